@@ -145,6 +145,16 @@ struct kiss_fft_state{
 	}while(0)
 
 
+/* x86 features detected at runtime (kiss_fft.c) */
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+# define KISS_FFT_X86 1
+#endif
+#define KF_X86_SSE 1
+#define KF_X86_AVX 2
+#define KF_X86_AVX2 4
+int kf_x86_features(void);
+
+
 /* a debugging function */
 #define pcpx(c)\
     fprintf(stderr,"%g + %gi\n",(double)((c)->r),(double)((c)->i) )
@@ -14,6 +14,13 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 
 
 #include "_kiss_fft_guts.h"
+#ifdef KISS_FFT_X86
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
 /* The guts header contains all the multiplication and addition macros that are defined for
  fixed or floating point complex numbers.  It also delares the kf_ internal functions.
  */
@@ -234,6 +241,265 @@ static void kf_bfly_generic(
     KISS_FFT_TMP_FREE(scratch);
 }
 
+#if defined(KISS_FFT_X86) && !defined(FIXED_POINT) && !defined(USE_SIMD)
+/*
+   AVX2 butterflies for float builds.
+
+   Four consecutive butterflies of a stage are done at once, with the complex
+   values left interleaved (r,i,r,i,...) as they are in memory.  Twiddles for
+   those four are fstride apart and are loaded two at a time.  Every product and sum is
+   the same IEEE operation as in the scalar butterflies above (no fma, no
+   reassociation), so the output is bit-identical; the tails of stages that
+   are not a multiple of four use masked loads and stores.
+ */
+#include <immintrin.h>
+#define KF_AVX2 1
+
+#if defined(__GNUC__) || defined(__clang__)
+# define KF_AVX2_TARGET __attribute__((target("avx2")))
+#else
+# define KF_AVX2_TARGET
+#endif
+
+static int kf_isa = -1;
+
+/* lanes enabled for 0..4 remaining complex values */
+static const int kf_avx2_masks[5][8] = {
+    { 0, 0, 0, 0, 0, 0, 0, 0},
+    {-1,-1, 0, 0, 0, 0, 0, 0},
+    {-1,-1,-1,-1, 0, 0, 0, 0},
+    {-1,-1,-1,-1,-1,-1, 0, 0},
+    {-1,-1,-1,-1,-1,-1,-1,-1},
+};
+
+static KF_AVX2_TARGET __m256i kf_avx2_mask(size_t rem)
+{
+    return _mm256_loadu_si256((const __m256i*)kf_avx2_masks[rem < 4 ? rem : 4]);
+}
+
+static KF_AVX2_TARGET __m256 kf_avx2_load(const kiss_fft_cpx * p,size_t rem,__m256i mask)
+{
+    return rem >= 4 ? _mm256_loadu_ps((const float*)p) : _mm256_maskload_ps((const float*)p,mask);
+}
+
+static KF_AVX2_TARGET void kf_avx2_store(kiss_fft_cpx * p,__m256 v,size_t rem,__m256i mask)
+{
+    if (rem >= 4)
+        _mm256_storeu_ps((float*)p,v);
+    else
+        _mm256_maskstore_ps((float*)p,mask,v);
+}
+
+/* twiddles tw[0], tw[stride], tw[2*stride], tw[3*stride]; each complex is one
+   64-bit element.  They are loaded in pairs rather than gathered: gathers are
+   microcoded on some cpus and slowed by microcode mitigations on others,
+   which made the short stages of mid-size transforms slower than scalar */
+static KF_AVX2_TARGET __m256 kf_avx2_twiddles(const kiss_fft_cpx * tw,size_t stride,size_t rem,__m256i mask)
+{
+    if (stride == 1)
+        return kf_avx2_load(tw,rem,mask);
+    else {
+        __m128 lo = _mm_loadl_pi(_mm_setzero_ps(),(const __m64*)tw);
+        __m128 hi = _mm_setzero_ps();
+        if (rem > 1)
+            lo = _mm_loadh_pi(lo,(const __m64*)(tw+stride));
+        if (rem > 2)
+            hi = _mm_loadl_pi(hi,(const __m64*)(tw+2*stride));
+        if (rem > 3)
+            hi = _mm_loadh_pi(hi,(const __m64*)(tw+3*stride));
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo),hi,1);
+    }
+}
+
+/* (ar*br - ai*bi, ai*br + ar*bi): same products and sums as C_MUL */
+static KF_AVX2_TARGET __m256 kf_avx2_cmul(__m256 a,__m256 b)
+{
+    const __m256 br = _mm256_moveldup_ps(b);
+    const __m256 bi = _mm256_movehdup_ps(b);
+    const __m256 as = _mm256_permute_ps(a,0xB1);
+    return _mm256_addsub_ps(_mm256_mul_ps(a,br),_mm256_mul_ps(as,bi));
+}
+
+/* swap real and imag of each complex */
+#define KF_AVX2_SWAP(a) _mm256_permute_ps(a,0xB1)
+/* negate imag / real parts */
+#define KF_AVX2_NEGI(a) _mm256_xor_ps(a,_mm256_setr_ps(0.f,-0.f,0.f,-0.f,0.f,-0.f,0.f,-0.f))
+#define KF_AVX2_NEGR(a) _mm256_xor_ps(a,_mm256_setr_ps(-0.f,0.f,-0.f,0.f,-0.f,0.f,-0.f,0.f))
+
+static KF_AVX2_TARGET void kf_bfly2_avx2(
+        kiss_fft_cpx * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m
+        )
+{
+    kiss_fft_cpx * Fout2 = Fout + m;
+    size_t k;
+    for (k=0;k<(size_t)m;k+=4) {
+        const size_t rem = m-k;
+        const __m256i mask = kf_avx2_mask(rem);
+        const __m256 a = kf_avx2_load(Fout+k,rem,mask);
+        const __m256 b = kf_avx2_load(Fout2+k,rem,mask);
+        const __m256 tw = kf_avx2_twiddles(st->twiddles+k*fstride,fstride,rem,mask);
+        const __m256 t = kf_avx2_cmul(b,tw);
+        kf_avx2_store(Fout2+k,_mm256_sub_ps(a,t),rem,mask);
+        kf_avx2_store(Fout+k,_mm256_add_ps(a,t),rem,mask);
+    }
+}
+
+static KF_AVX2_TARGET void kf_bfly4_avx2(
+        kiss_fft_cpx * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        const size_t m
+        )
+{
+    const size_t m2=2*m;
+    const size_t m3=3*m;
+    size_t k;
+    for (k=0;k<m;k+=4) {
+        const size_t rem = m-k;
+        const __m256i mask = kf_avx2_mask(rem);
+        __m256 f0 = kf_avx2_load(Fout+k,rem,mask);
+        const __m256 s0 = kf_avx2_cmul(kf_avx2_load(Fout+k+m,rem,mask),
+                kf_avx2_twiddles(st->twiddles+k*fstride,fstride,rem,mask));
+        const __m256 s1 = kf_avx2_cmul(kf_avx2_load(Fout+k+m2,rem,mask),
+                kf_avx2_twiddles(st->twiddles+k*fstride*2,fstride*2,rem,mask));
+        const __m256 s2 = kf_avx2_cmul(kf_avx2_load(Fout+k+m3,rem,mask),
+                kf_avx2_twiddles(st->twiddles+k*fstride*3,fstride*3,rem,mask));
+        const __m256 s5 = _mm256_sub_ps(f0,s1);
+        __m256 s3,s4,s4s;
+
+        f0 = _mm256_add_ps(f0,s1);
+        s3 = _mm256_add_ps(s0,s2);
+        s4 = _mm256_sub_ps(s0,s2);
+        kf_avx2_store(Fout+k+m2,_mm256_sub_ps(f0,s3),rem,mask);
+        kf_avx2_store(Fout+k,_mm256_add_ps(f0,s3),rem,mask);
+
+        /* s5 +/- (s4.i, -s4.r) */
+        s4s = KF_AVX2_SWAP(s4);
+        if(st->inverse) {
+            kf_avx2_store(Fout+k+m,_mm256_addsub_ps(s5,s4s),rem,mask);
+            kf_avx2_store(Fout+k+m3,_mm256_add_ps(s5,KF_AVX2_NEGI(s4s)),rem,mask);
+        }else{
+            kf_avx2_store(Fout+k+m,_mm256_add_ps(s5,KF_AVX2_NEGI(s4s)),rem,mask);
+            kf_avx2_store(Fout+k+m3,_mm256_addsub_ps(s5,s4s),rem,mask);
+        }
+    }
+}
+
+static KF_AVX2_TARGET void kf_bfly3_avx2(
+         kiss_fft_cpx * Fout,
+         const size_t fstride,
+         const kiss_fft_cfg st,
+         size_t m
+         )
+{
+     const size_t m2 = 2*m;
+     const __m256 epi3 = _mm256_set1_ps(st->twiddles[fstride*m].i);
+     const __m256 half = _mm256_set1_ps(.5f);
+     size_t k;
+     for (k=0;k<m;k+=4) {
+         const size_t rem = m-k;
+         const __m256i mask = kf_avx2_mask(rem);
+         const __m256 f0 = kf_avx2_load(Fout+k,rem,mask);
+         const __m256 s1 = kf_avx2_cmul(kf_avx2_load(Fout+k+m,rem,mask),
+                 kf_avx2_twiddles(st->twiddles+k*fstride,fstride,rem,mask));
+         const __m256 s2 = kf_avx2_cmul(kf_avx2_load(Fout+k+m2,rem,mask),
+                 kf_avx2_twiddles(st->twiddles+k*fstride*2,fstride*2,rem,mask));
+         const __m256 s3 = _mm256_add_ps(s1,s2);
+         const __m256 s0 = _mm256_mul_ps(_mm256_sub_ps(s1,s2),epi3);
+         const __m256 f1 = _mm256_sub_ps(f0,_mm256_mul_ps(s3,half));
+         const __m256 s0s = KF_AVX2_SWAP(s0);
+
+         kf_avx2_store(Fout+k,_mm256_add_ps(f0,s3),rem,mask);
+         /* f1 + (s0.i, -s0.r) and f1 - (s0.i, -s0.r) */
+         kf_avx2_store(Fout+k+m2,_mm256_add_ps(f1,KF_AVX2_NEGI(s0s)),rem,mask);
+         kf_avx2_store(Fout+k+m,_mm256_addsub_ps(f1,s0s),rem,mask);
+     }
+}
+
+static KF_AVX2_TARGET void kf_bfly5_avx2(
+        kiss_fft_cpx * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m
+        )
+{
+    const kiss_fft_cpx * twiddles = st->twiddles;
+    const __m256 yar = _mm256_set1_ps(twiddles[fstride*m].r);
+    const __m256 yai = _mm256_set1_ps(twiddles[fstride*m].i);
+    const __m256 ybr = _mm256_set1_ps(twiddles[fstride*2*m].r);
+    const __m256 ybi = _mm256_set1_ps(twiddles[fstride*2*m].i);
+    size_t u;
+
+    for ( u=0; u<(size_t)m; u+=4 ) {
+        const size_t rem = m-u;
+        const __m256i mask = kf_avx2_mask(rem);
+        const __m256 s0 = kf_avx2_load(Fout+u,rem,mask);
+        const __m256 s1 = kf_avx2_cmul(kf_avx2_load(Fout+u+m,rem,mask),
+                kf_avx2_twiddles(twiddles+u*fstride,fstride,rem,mask));
+        const __m256 s2 = kf_avx2_cmul(kf_avx2_load(Fout+u+2*m,rem,mask),
+                kf_avx2_twiddles(twiddles+2*u*fstride,2*fstride,rem,mask));
+        const __m256 s3 = kf_avx2_cmul(kf_avx2_load(Fout+u+3*m,rem,mask),
+                kf_avx2_twiddles(twiddles+3*u*fstride,3*fstride,rem,mask));
+        const __m256 s4 = kf_avx2_cmul(kf_avx2_load(Fout+u+4*m,rem,mask),
+                kf_avx2_twiddles(twiddles+4*u*fstride,4*fstride,rem,mask));
+        const __m256 s7 = _mm256_add_ps(s1,s4);
+        const __m256 s10 = _mm256_sub_ps(s1,s4);
+        const __m256 s8 = _mm256_add_ps(s2,s3);
+        const __m256 s9 = _mm256_sub_ps(s2,s3);
+        const __m256 s10s = KF_AVX2_SWAP(s10);
+        const __m256 s9s = KF_AVX2_SWAP(s9);
+        __m256 s5,s6,s11,s12;
+
+        kf_avx2_store(Fout+u,_mm256_add_ps(s0,_mm256_add_ps(s7,s8)),rem,mask);
+
+        s5 = _mm256_add_ps(_mm256_add_ps(s0,_mm256_mul_ps(s7,yar)),_mm256_mul_ps(s8,ybr));
+        /* (s10.i*ya.i + s9.i*yb.i, -s10.r*ya.i - s9.r*yb.i) */
+        s6 = _mm256_add_ps(KF_AVX2_NEGI(_mm256_mul_ps(s10s,yai)),KF_AVX2_NEGI(_mm256_mul_ps(s9s,ybi)));
+        kf_avx2_store(Fout+u+m,_mm256_sub_ps(s5,s6),rem,mask);
+        kf_avx2_store(Fout+u+4*m,_mm256_add_ps(s5,s6),rem,mask);
+
+        s11 = _mm256_add_ps(_mm256_add_ps(s0,_mm256_mul_ps(s7,ybr)),_mm256_mul_ps(s8,yar));
+        /* (-s10.i*yb.i + s9.i*ya.i, s10.r*yb.i - s9.r*ya.i) */
+        s12 = _mm256_add_ps(KF_AVX2_NEGR(_mm256_mul_ps(s10s,ybi)),KF_AVX2_NEGI(_mm256_mul_ps(s9s,yai)));
+        kf_avx2_store(Fout+u+2*m,_mm256_add_ps(s11,s12),rem,mask);
+        kf_avx2_store(Fout+u+3*m,_mm256_sub_ps(s11,s12),rem,mask);
+    }
+}
+#endif
+
+/* recombine the p smaller DFTs of one stage */
+static
+void kf_bfly(
+        kiss_fft_cpx * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m,
+        int p
+        )
+{
+#ifdef KF_AVX2
+    /* short stages gain nothing from 4-wide butterflies */
+    if (kf_isa == KISS_FFT_ISA_AVX2 && m >= 4) {
+        switch (p) {
+            case 2: kf_bfly2_avx2(Fout,fstride,st,m); return;
+            case 3: kf_bfly3_avx2(Fout,fstride,st,m); return;
+            case 4: kf_bfly4_avx2(Fout,fstride,st,m); return;
+            case 5: kf_bfly5_avx2(Fout,fstride,st,m); return;
+        }
+    }
+#endif
+    switch (p) {
+        case 2: kf_bfly2(Fout,fstride,st,m); break;
+        case 3: kf_bfly3(Fout,fstride,st,m); break; 
+        case 4: kf_bfly4(Fout,fstride,st,m); break;
+        case 5: kf_bfly5(Fout,fstride,st,m); break; 
+        default: kf_bfly_generic(Fout,fstride,st,m,p); break;
+    }
+}
+
 static
 void kf_work(
         kiss_fft_cpx * Fout,
@@ -262,13 +528,7 @@ void kf_work(
             kf_work( Fout +k*m, f+ fstride*in_stride*k,fstride*p,in_stride,factors,st);
         // all threads have joined by this point
 
-        switch (p) {
-            case 2: kf_bfly2(Fout,fstride,st,m); break;
-            case 3: kf_bfly3(Fout,fstride,st,m); break; 
-            case 4: kf_bfly4(Fout,fstride,st,m); break;
-            case 5: kf_bfly5(Fout,fstride,st,m); break; 
-            default: kf_bfly_generic(Fout,fstride,st,m,p); break;
-        }
+        kf_bfly(Fout,fstride,st,m,p);
         return;
     }
 #endif
@@ -292,13 +552,7 @@ void kf_work(
     Fout=Fout_beg;
 
     // recombine the p smaller DFTs 
-    switch (p) {
-        case 2: kf_bfly2(Fout,fstride,st,m); break;
-        case 3: kf_bfly3(Fout,fstride,st,m); break; 
-        case 4: kf_bfly4(Fout,fstride,st,m); break;
-        case 5: kf_bfly5(Fout,fstride,st,m); break; 
-        default: kf_bfly_generic(Fout,fstride,st,m,p); break;
-    }
+    kf_bfly(Fout,fstride,st,m,p);
 }
 
 /*  facbuf is populated by p1,m1,p2,m2, ...
@@ -351,6 +605,10 @@ kiss_fft_cfg kiss_fft_alloc(int nfft,int inverse_fft,void * mem,size_t * lenmem
     }
     if (st) {
         int i;
+#ifdef KF_AVX2
+        if (kf_isa < 0)
+            kiss_fft_set_isa(-1);
+#endif
         st->nfft=nfft;
         st->inverse = inverse_fft;
 
@@ -406,3 +664,61 @@ int kiss_fft_next_fast_size(int n)
     }
     return n;
 }
+
+int kf_x86_features(void)
+{
+    int features = 0;
+#ifdef KISS_FFT_X86
+    int regs[4] = {0,0,0,0};
+    int regs7[4] = {0,0,0,0};
+# ifdef _MSC_VER
+    __cpuid(regs,0);
+    if (regs[0] >= 7)
+        __cpuidex(regs7,7,0);
+    __cpuid(regs,1);
+# else
+    unsigned int a,b,c,d;
+    if (__get_cpuid_max(0,0) >= 7) {
+        __cpuid_count(7,0,a,b,c,d);
+        regs7[1] = (int)b;
+    }
+    if (__get_cpuid(1,&a,&b,&c,&d)) {
+        regs[2] = (int)c;
+        regs[3] = (int)d;
+    }
+# endif
+    if (regs[3] & (1<<25))
+        features |= KF_X86_SSE;
+    /* avx needs the cpu flag and the os saving ymm state (osxsave + xcr0) */
+    if ((regs[2] & (1<<28)) && (regs[2] & (1<<27))) {
+        unsigned long long xcr0;
+# ifdef _MSC_VER
+        xcr0 = _xgetbv(0);
+# else
+        unsigned int lo,hi;
+        __asm__ __volatile__ ("xgetbv" : "=a"(lo),"=d"(hi) : "c"(0));
+        xcr0 = ((unsigned long long)hi << 32) | lo;
+# endif
+        if ((xcr0 & 6) == 6) {
+            features |= KF_X86_AVX;
+            if (regs7[1] & (1<<5))
+                features |= KF_X86_AVX2;
+        }
+    }
+#endif
+    return features;
+}
+
+int kiss_fft_set_isa(int isa)
+{
+#ifdef KF_AVX2
+    int best = KISS_FFT_ISA_SCALAR;
+    if (sizeof(kiss_fft_scalar) == sizeof(float) && (kf_x86_features() & KF_X86_AVX2))
+        best = KISS_FFT_ISA_AVX2;
+    kf_isa = (isa < 0 || isa > best) ? best : isa;
+    return kf_isa;
+#else
+    (void)isa;
+    return KISS_FFT_ISA_SCALAR;
+#endif
+}
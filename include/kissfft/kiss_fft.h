@@ -108,6 +108,18 @@ void kiss_fft_stride(kiss_fft_cfg cfg,const kiss_fft_cpx *fin,kiss_fft_cpx *fout
 void kiss_fft_cleanup(void);
 	
 
+/*
+ * kiss_fft_set_isa
+ *
+ * Float builds on x86 can run the radix 2,3,4,5 butterflies with AVX2, picked at
+ * runtime from cpuid.  Results are bit-identical to the scalar butterflies.
+ * This limits what kiss_fft may use from now on; pass -1 for the best available.
+ * Returns the instruction set that will actually be used.
+ */
+#define KISS_FFT_ISA_SCALAR 0
+#define KISS_FFT_ISA_AVX2 1
+int kiss_fft_set_isa(int isa);
+
 /*
  * Returns the smallest integer k, such that k>=n and k has only "fast" factors (2,3,5)
  */
@@ -1,14 +1,22 @@
 #ifndef KISSFFT_I32_CLASS_HH
 #define KISSFFT_I32_CLASS_HH
 
+#include <cmath>
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
 // TODO1: substitute complex<type> (behaviour not defined for nonfloats), should be faster
-// TODO2: use std:: namespace
 // TODO3: make unittests for all ffts (c, cpp, i32)
 
+// Fixed point: twiddles are stored times scale_factor, and every product
+// with a twiddle is formed in 64 bits and divided back down (a rounding
+// shift when scale_factor is a power of two).  Data is never rescaled, so
+// the caller has to leave log2(nfft)+2 bits of headroom in the input; see
+// test/testi32.cc for block scaling int16 input that way.
+
 template <typename DType>
 struct complex_s
 {
@@ -21,27 +29,34 @@ class kissfft_i32
 private:
 
     using scalar_type = int32_t;
-    using cpx_type    = complex<int32_t>;
+    using cpx_type    = std::complex<int32_t>;
 
     scalar_type _scale_factor;
+    int _scale_shift;   // log2(_scale_factor) if a power of two, else -1
     std::size_t _nfft;
     bool _inverse;
     std::vector<cpx_type> _twiddles;
     std::vector<std::size_t> _stageRadix;
     std::vector<std::size_t> _stageRemainder;
+    mutable std::vector<cpx_type> _scratch; // generic butterfly, largest radix
 
 public:
 
     // scale_factor: upscale twiddle-factors otherwise they lie between 0..1 (out of range for integer) --> fixed point math
     kissfft_i32(const std::size_t nfft, const bool inverse, const double scale_factor = 1024.0)
-            : _scale_factor(scalar_type(scale_factor)), _nfft(nfft), _inverse(inverse)
+            : _scale_factor(scalar_type(scale_factor)), _scale_shift(-1), _nfft(nfft), _inverse(inverse)
     {
-        // fill twiddle factors
+        for (int b = 0; b < 31; ++b)
+            if (_scale_factor == (scalar_type(1) << b))
+                _scale_shift = b;
+
+        // fill twiddle factors, rounded to nearest
         _twiddles.resize(_nfft);
-        const double phinc = (_inverse ? 2 : -2) * acos(-1.0) / _nfft;
+        const double phinc = (_inverse ? 2 : -2) * std::acos(-1.0) / _nfft;
         for (std::size_t i = 0; i < _nfft; ++i)
         {
-            _twiddles[i] = scale_factor * exp(complex<double>(0, i * phinc));
+            const std::complex<double> tw = scale_factor * std::exp(std::complex<double>(0, i * phinc));
+            _twiddles[i] = cpx_type(scalar_type(std::floor(tw.real() + 0.5)), scalar_type(std::floor(tw.imag() + 0.5)));
         }
         //factorize
         //start factoring out 4's, then 2's, then 3,5,7,9,...
@@ -68,6 +83,8 @@ public:
             n /= p;
             _stageRadix.push_back(p);
             _stageRemainder.push_back(n);
+            if (p > 5 && p > _scratch.size())
+                _scratch.resize(p);
         } while (n > 1);
     }
 
@@ -140,11 +157,31 @@ public:
 
 private:
 
-    void kf_bfly2(cpx_type *const Fout, const size_t fstride, const std::size_t m) const
+    // a * b / scale_factor, products in 64 bits
+    scalar_type descale(const int64_t x) const
+    {
+        if (_scale_shift > 0)
+            return scalar_type((x + (int64_t(1) << (_scale_shift - 1))) >> _scale_shift);
+        return scalar_type(x / _scale_factor);
+    }
+
+    cpx_type mul(const cpx_type & a, const cpx_type & b) const
+    {
+        return cpx_type(
+                descale(int64_t(a.real()) * b.real() - int64_t(a.imag()) * b.imag()),
+                descale(int64_t(a.real()) * b.imag() + int64_t(a.imag()) * b.real()));
+    }
+
+    cpx_type mul(const cpx_type & a, const scalar_type b) const
+    {
+        return cpx_type(descale(int64_t(a.real()) * b), descale(int64_t(a.imag()) * b));
+    }
+
+    void kf_bfly2(cpx_type *const Fout, const std::size_t fstride, const std::size_t m) const
     {
         for (std::size_t k = 0; k < m; ++k)
         {
-            const cpx_type t = (Fout[m + k] * _twiddles[k * fstride]) / _scale_factor;
+            const cpx_type t = mul(Fout[m + k], _twiddles[k * fstride]);
             Fout[m + k] = Fout[k] - t;
             Fout[k] += t;
         }
@@ -162,8 +199,8 @@ private:
 
         do
         {
-            scratch[1] = (Fout[m] * *tw1) / _scale_factor;
-            scratch[2] = (Fout[m2] * *tw2) / _scale_factor;
+            scratch[1] = mul(Fout[m], *tw1);
+            scratch[2] = mul(Fout[m2], *tw2);
 
             scratch[3] = scratch[1] + scratch[2];
             scratch[0] = scratch[1] - scratch[2];
@@ -171,8 +208,7 @@ private:
             tw2 += fstride * 2;
 
             Fout[m] = Fout[0] - (scratch[3] / 2);
-            scratch[0] *= epi3.imag();
-            scratch[0] /= _scale_factor;
+            scratch[0] = mul(scratch[0], epi3.imag());
 
             Fout[0] += scratch[3];
 
@@ -190,9 +226,9 @@ private:
 
         for (std::size_t k = 0; k < m; ++k)
         {
-            scratch[0] = (Fout[k + m] * _twiddles[k * fstride]) / _scale_factor;
-            scratch[1] = (Fout[k + 2 * m] * _twiddles[k * fstride * 2]) / _scale_factor;
-            scratch[2] = (Fout[k + 3 * m] * _twiddles[k * fstride * 3]) / _scale_factor;
+            scratch[0] = mul(Fout[k + m], _twiddles[k * fstride]);
+            scratch[1] = mul(Fout[k + 2 * m], _twiddles[k * fstride * 2]);
+            scratch[2] = mul(Fout[k + 3 * m], _twiddles[k * fstride * 3]);
             scratch[5] = Fout[k] - scratch[1];
 
             Fout[k] += scratch[1];
@@ -225,10 +261,10 @@ private:
         {
             scratch[0] = *Fout0;
 
-            scratch[1] = (*Fout1 * _twiddles[u * fstride]) / _scale_factor;
-            scratch[2] = (*Fout2 * _twiddles[2 * u * fstride]) / _scale_factor;
-            scratch[3] = (*Fout3 * _twiddles[3 * u * fstride]) / _scale_factor;
-            scratch[4] = (*Fout4 * _twiddles[4 * u * fstride]) / _scale_factor;
+            scratch[1] = mul(*Fout1, _twiddles[u * fstride]);
+            scratch[2] = mul(*Fout2, _twiddles[2 * u * fstride]);
+            scratch[3] = mul(*Fout3, _twiddles[3 * u * fstride]);
+            scratch[4] = mul(*Fout4, _twiddles[4 * u * fstride]);
 
             scratch[7] = scratch[1] + scratch[4];
             scratch[10] = scratch[1] - scratch[4];
@@ -238,24 +274,20 @@ private:
             *Fout0 += scratch[7];
             *Fout0 += scratch[8];
 
-            scratch[5] = scratch[0] + (cpx_type(
-                    scratch[7].real() * ya.real() + scratch[8].real() * yb.real(),
-                    scratch[7].imag() * ya.real() + scratch[8].imag() * yb.real() ) / _scale_factor);
+            scratch[5] = scratch[0] + mul(scratch[7], ya.real()) + mul(scratch[8], yb.real());
 
             scratch[6] = cpx_type(
-                    scratch[10].imag() * ya.imag() + scratch[9].imag() * yb.imag(),
-                    -scratch[10].real() * ya.imag() - scratch[9].real() * yb.imag() ) / _scale_factor;
+                    descale(int64_t(scratch[10].imag()) * ya.imag() + int64_t(scratch[9].imag()) * yb.imag()),
+                    descale(-int64_t(scratch[10].real()) * ya.imag() - int64_t(scratch[9].real()) * yb.imag()));
 
             *Fout1 = scratch[5] - scratch[6];
             *Fout4 = scratch[5] + scratch[6];
 
-            scratch[11] = scratch[0] + (cpx_type(
-                    scratch[7].real() * yb.real() + scratch[8].real() * ya.real(),
-                    scratch[7].imag() * yb.real() + scratch[8].imag() * ya.real() ) / _scale_factor);
+            scratch[11] = scratch[0] + mul(scratch[7], yb.real()) + mul(scratch[8], ya.real());
 
             scratch[12] = cpx_type(
-                    -scratch[10].imag() * yb.imag() + scratch[9].imag() * ya.imag(),
-                    scratch[10].real() * yb.imag() - scratch[9].real() * ya.imag() ) / _scale_factor;
+                    descale(-int64_t(scratch[10].imag()) * yb.imag() + int64_t(scratch[9].imag()) * ya.imag()),
+                    descale(int64_t(scratch[10].real()) * yb.imag() - int64_t(scratch[9].real()) * ya.imag()));
 
             *Fout2 = scratch[11] + scratch[12];
             *Fout3 = scratch[11] - scratch[12];
@@ -269,10 +301,10 @@ private:
     }
 
     /* perform the butterfly for one stage of a mixed radix FFT */
-    void kf_bfly_generic(cpx_type * const Fout, const size_t fstride, const std::size_t m, const std::size_t p) const
+    void kf_bfly_generic(cpx_type * const Fout, const std::size_t fstride, const std::size_t m, const std::size_t p) const
     {
         const cpx_type *twiddles = &_twiddles[0];
-        cpx_type scratchbuf[p];
+        cpx_type *const scratchbuf = &_scratch[0];
 
         for (std::size_t u = 0; u < m; ++u)
         {
@@ -293,7 +325,7 @@ private:
                     twidx += fstride * k;
                     if (twidx >= _nfft)
                         twidx -= _nfft;
-                    Fout[k] += (scratchbuf[q] * twiddles[twidx]) / _scale_factor;
+                    Fout[k] += mul(scratchbuf[q], twiddles[twidx]);
                 }
                 k += m;
             }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/times.h>
+#include <sys/time.h>
 #include <unistd.h>
 #include "kiss_fft.h"
 #include "kiss_fftr.h"
@@ -9,6 +10,57 @@
 
 #include "pstats.h"
 
+/* wall clock seconds, for the scalar vs vectorized comparison */
+static
+double now(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/* time scalar and vectorized butterflies on each 1d size, print the speedup;
+   the two paths alternate over several rounds and the fastest round of each
+   counts, so a frequency step or a busy core does not land on one path only */
+#define COMPARE_ROUNDS 7
+static
+void compare_isa(int * nfft,int nsizes,int isinverse,int numffts)
+{
+    int k,i,isa,round;
+    int best = kiss_fft_set_isa(-1);
+    if (best == KISS_FFT_ISA_SCALAR) {
+        fprintf(stderr,"no vectorized butterflies on this cpu/build\n");
+        return;
+    }
+    fprintf(stderr,"KISS isa\tnumffts=%d\n",numffts);
+    for (k=0;k<nsizes;++k) {
+        double t[2];
+        int nbytes = sizeof(kiss_fft_cpx)*nfft[k];
+        kiss_fft_cpx * buf = (kiss_fft_cpx*)KISS_FFT_MALLOC(nbytes);
+        kiss_fft_cpx * bufout = (kiss_fft_cpx*)KISS_FFT_MALLOC(nbytes);
+        kiss_fft_cfg st = kiss_fft_alloc(nfft[k],isinverse,0,0);
+        memset(buf,0,nbytes);
+        t[0] = t[1] = 1e30;
+        for (round=0;round<COMPARE_ROUNDS;++round) {
+            for (isa=0;isa<2;++isa) {
+                double t0;
+                kiss_fft_set_isa(isa ? best : KISS_FFT_ISA_SCALAR);
+                kiss_fft(st,buf,bufout);
+                t0 = now();
+                for (i=0;i<numffts;++i)
+                    kiss_fft(st,buf,bufout);
+                t0 = now() - t0;
+                if (t0 < t[isa])
+                    t[isa] = t0;
+            }
+        }
+        fprintf(stderr,"\tnfft=%d\tscalar=%.1f us\tvectorized=%.1f us\tspeedup=%.2fx\n",
+                nfft[k],t[0]*1e6/numffts,t[1]*1e6/numffts,t[0]/t[1]);
+        free(st); free(buf); free(bufout);
+    }
+    kiss_fft_set_isa(-1);
+}
+
 static
 int getdims(int * dims, char * arg)
 {
@@ -32,17 +84,21 @@ int main(int argc,char ** argv)
     kiss_fft_cpx * buf;
     kiss_fft_cpx * bufout;
     int real = 0;
+    int compare = 0;
 
     nfft[0] = 1024;// default
 
     while (1) {
-        int c = getopt (argc, argv, "n:ix:r");
+        int c = getopt (argc, argv, "n:ix:rc");
         if (c == -1)
             break;
         switch (c) {
             case 'r':
                 real = 1;
                 break;
+            case 'c':
+                compare = 1;
+                break;
             case 'n':
                 ndims = getdims(nfft, optarg );
                 if (nfft[0] != kiss_fft_next_fast_size(nfft[0]) ) {
@@ -58,6 +114,12 @@ int main(int argc,char ** argv)
                 break;
         }
     }
+    if (compare) {
+        /* -c: every -n value is a separate 1d size */
+        compare_isa(nfft,ndims,isinverse,numffts);
+        return 0;
+    }
+
     int nbytes = sizeof(kiss_fft_cpx);
     for (k=0;k<ndims;++k)
         nbytes *= nfft[k];
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "kiss_fft.h"
+#include "kiss_fftr.h"
+#include "kiss_fft_batch.h"
+
+/*
+ Compares kiss_fft_batch against running the scalar transform once per lane.
+ Every timing is for numffts batches of 'lanes' transforms each, so the
+ numbers are directly comparable.
+ */
+
+static
+double now(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static const char * isa_name[] = {"scalar","sse","avx"};
+
+int main(int argc,char ** argv)
+{
+    int nfft = 1024;
+    int lanes = 4;
+    int numffts = 10000;
+    int real = 0;
+    int i,j,k,isa,best;
+    int nout;
+    float * in, * out, * ref;
+    kiss_fft_cpx * lin, * lout;
+    double t0,tscalar,tbatch;
+
+    while (1) {
+        int c = getopt (argc, argv, "n:x:l:r");
+        if (c == -1)
+            break;
+        switch (c) {
+            case 'n':
+                nfft = atoi(optarg);
+                break;
+            case 'x':
+                numffts = atoi(optarg);
+                break;
+            case 'l':
+                lanes = atoi(optarg);
+                break;
+            case 'r':
+                real = 1;
+                break;
+        }
+    }
+    if (real && (nfft & 1)) {
+        fprintf(stderr,"real transforms need an even nfft\n");
+        return 1;
+    }
+
+    /* complex layout is the bigger of the two, use it for both */
+    nout = real ? nfft/2+1 : nfft;
+    in = (float*)KISS_FFT_MALLOC(sizeof(float)*2*lanes*nfft);
+    out = (float*)KISS_FFT_MALLOC(sizeof(float)*2*lanes*nout);
+    ref = (float*)KISS_FFT_MALLOC(sizeof(float)*2*lanes*nout);
+    lin = (kiss_fft_cpx*)KISS_FFT_MALLOC(sizeof(kiss_fft_cpx)*nfft);
+    lout = (kiss_fft_cpx*)KISS_FFT_MALLOC(sizeof(kiss_fft_cpx)*nfft);
+
+    srand(5);
+    for (i=0;i<2*lanes*nfft;++i)
+        in[i] = rand()/(float)RAND_MAX - .5f;
+
+    /* scalar reference: one transform per lane, gather/scatter excluded from timing */
+    if (real) {
+        kiss_fftr_cfg st = kiss_fftr_alloc(nfft,0,0,0);
+        for (j=0;j<lanes;++j) {
+            for (k=0;k<nfft;++k)
+                ((float*)lin)[k] = in[lanes*k+j];
+            kiss_fftr(st,(float*)lin,lout);
+            for (k=0;k<nout;++k) {
+                kiss_fft_batch_re(ref,lanes,k,j) = lout[k].r;
+                kiss_fft_batch_im(ref,lanes,k,j) = lout[k].i;
+            }
+        }
+        t0 = now();
+        for (i=0;i<numffts;++i)
+            for (j=0;j<lanes;++j)
+                kiss_fftr(st,(float*)lin,lout);
+        tscalar = now() - t0;
+        free(st);
+    } else {
+        kiss_fft_cfg st = kiss_fft_alloc(nfft,0,0,0);
+        for (j=0;j<lanes;++j) {
+            for (k=0;k<nfft;++k) {
+                lin[k].r = kiss_fft_batch_re(in,lanes,k,j);
+                lin[k].i = kiss_fft_batch_im(in,lanes,k,j);
+            }
+            kiss_fft(st,lin,lout);
+            for (k=0;k<nout;++k) {
+                kiss_fft_batch_re(ref,lanes,k,j) = lout[k].r;
+                kiss_fft_batch_im(ref,lanes,k,j) = lout[k].i;
+            }
+        }
+        t0 = now();
+        for (i=0;i<numffts;++i)
+            for (j=0;j<lanes;++j)
+                kiss_fft(st,lin,lout);
+        tscalar = now() - t0;
+        free(st);
+    }
+
+    fprintf(stderr,"KISS batch\tnfft=%d\tlanes=%d\tnumffts=%d\t%s\n",nfft,lanes,numffts,real ? "real" : "complex");
+    fprintf(stderr,"\t%-8s %8.3f s  %10.1f ns/transform\n","per-lane",tscalar,tscalar*1e9/((double)numffts*lanes));
+
+    best = kiss_fft_batch_set_isa(-1);
+    for (isa=KISS_FFT_BATCH_ISA_SCALAR;isa<=best;++isa) {
+        double maxerr = 0, maxref = 0;
+        kiss_fft_batch_set_isa(isa);
+        if (real) {
+            kiss_fftr_batch_cfg st = kiss_fftr_batch_alloc(nfft,lanes,0,0);
+            kiss_fftr_batch(st,in,out);
+            t0 = now();
+            for (i=0;i<numffts;++i)
+                kiss_fftr_batch(st,in,out);
+            tbatch = now() - t0;
+            free(st);
+        } else {
+            kiss_fft_batch_cfg st = kiss_fft_batch_alloc(nfft,0,lanes,0,0);
+            kiss_fft_batch(st,in,out);
+            t0 = now();
+            for (i=0;i<numffts;++i)
+                kiss_fft_batch(st,in,out);
+            tbatch = now() - t0;
+            free(st);
+        }
+        for (i=0;i<2*lanes*nout;++i) {
+            double d = fabs((double)out[i] - ref[i]);
+            if (d > maxerr) maxerr = d;
+            if (fabs(ref[i]) > maxref) maxref = fabs(ref[i]);
+        }
+        fprintf(stderr,"\t%-8s %8.3f s  %10.1f ns/transform  speedup=%.2fx  maxerr=%g\n",
+                isa_name[isa],tbatch,tbatch*1e9/((double)numffts*lanes),tscalar/tbatch,maxerr/maxref);
+        if (maxerr > 1e-5*maxref) {
+            fprintf(stderr,"batch result differs from per-lane result\n");
+            return 1;
+        }
+    }
+
+    free(in); free(out); free(ref); free(lin); free(lout);
+    kiss_fft_cleanup();
+    return 0;
+}
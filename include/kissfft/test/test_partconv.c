@@ -0,0 +1,139 @@
+#include "kiss_partconv.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <sys/times.h>
+#include <unistd.h>
+
+static double cputime(void)
+{
+    struct tms t;
+    times(&t);
+    return (double)(t.tms_utime + t.tms_stime)/  sysconf(_SC_CLK_TCK) ;
+}
+
+static
+kiss_fft_scalar rand_scalar(void)
+{
+    return (kiss_fft_scalar)(rand() - RAND_MAX/2) / (kiss_fft_scalar)RAND_MAX;
+}
+
+/* reference: out[n] = sum h[k] x[n-k] */
+static
+void direct_conv(const kiss_fft_scalar * x,size_t nx,const kiss_fft_scalar * h,size_t nh,double * out)
+{
+    size_t n,k;
+    for (n=0;n<nx;++n) {
+        double acc=0;
+        for (k=0;k<nh && k<=n;++k)
+            acc += (double)h[k] * (double)x[n-k];
+        out[n] = acc;
+    }
+}
+
+static
+double snr_compare(const double * ref,const kiss_fft_scalar * got,size_t n)
+{
+    size_t k;
+    double sigpow=1e-10,noisepow=1e-10,err;
+    for (k=0;k<n;++k) {
+        sigpow += ref[k]*ref[k];
+        err = ref[k] - (double)got[k];
+        noisepow += err*err;
+    }
+    return 10*log10( sigpow / noisepow );
+}
+
+static
+int check(int blocksize,size_t nh,size_t nblocks)
+{
+    size_t nx = nblocks * (size_t)blocksize, k;
+    kiss_fft_scalar * h = (kiss_fft_scalar*)malloc(sizeof(kiss_fft_scalar)*nh);
+    kiss_fft_scalar * x = (kiss_fft_scalar*)malloc(sizeof(kiss_fft_scalar)*nx);
+    kiss_fft_scalar * y = (kiss_fft_scalar*)malloc(sizeof(kiss_fft_scalar)*nx);
+    double * ref = (double*)malloc(sizeof(double)*nx);
+    double snr1,snr2;
+    kiss_partconv_cfg cfg;
+
+    for (k=0;k<nh;++k)
+        h[k] = rand_scalar();
+    for (k=0;k<nx;++k)
+        x[k] = rand_scalar();
+    direct_conv(x,nx,h,nh,ref);
+
+    cfg = kiss_partconv_alloc(h,nh,blocksize,NULL,NULL);
+    for (k=0;k<nblocks;++k)
+        kiss_partconv(cfg,x+k*blocksize,y+k*blocksize);
+    snr1 = snr_compare(ref,y,nx);
+
+    /* new response in place, same partitions; reset makes it a fresh run */
+    for (k=0;k<nh;++k)
+        h[k] = rand_scalar();
+    direct_conv(x,nx,h,nh,ref);
+    if (kiss_partconv_set_response(cfg,h,nh) != 0) {
+        printf("set_response rejected a response that fits\n");
+        exit(1);
+    }
+    kiss_partconv_reset(cfg);
+    for (k=0;k<nblocks;++k) {
+        /* in place */
+        memcpy(y+k*blocksize,x+k*blocksize,sizeof(kiss_fft_scalar)*blocksize);
+        kiss_partconv(cfg,y+k*blocksize,y+k*blocksize);
+    }
+    snr2 = snr_compare(ref,y,nx);
+
+    printf("blocksize=%d ir=%d partitions=%d snr=%.1f/%.1f dB\n",
+            blocksize,(int)nh,kiss_partconv_partitions(cfg),snr1,snr2);
+
+    if (kiss_partconv_set_response(cfg,h,(size_t)kiss_partconv_partitions(cfg)*blocksize+1) != -1) {
+        printf("set_response accepted a response that does not fit\n");
+        exit(1);
+    }
+
+    kiss_partconv_free(cfg);
+    free(h);free(x);free(y);free(ref);
+    return snr1 > 80 && snr2 > 80;
+}
+
+static
+void bench(int blocksize,size_t nh,int nblocks)
+{
+    kiss_fft_scalar * h = (kiss_fft_scalar*)calloc(nh,sizeof(kiss_fft_scalar));
+    kiss_fft_scalar * buf = (kiss_fft_scalar*)calloc(blocksize,sizeof(kiss_fft_scalar));
+    kiss_partconv_cfg cfg;
+    double t0,t1;
+    int k;
+
+    h[0] = 1;
+    cfg = kiss_partconv_alloc(h,nh,blocksize,NULL,NULL);
+    t0 = cputime();
+    for (k=0;k<nblocks;++k)
+        kiss_partconv(cfg,buf,buf);
+    t1 = cputime();
+    printf("blocksize=%d ir=%d: %.3f us per block, %.1f ns per sample\n",
+            blocksize,(int)nh,1e6*(t1-t0)/nblocks,1e9*(t1-t0)/((double)nblocks*blocksize));
+    kiss_partconv_free(cfg);
+    free(h);free(buf);
+}
+
+int main(void)
+{
+    static const int blocksizes[] = {64,128,256};
+    static const size_t irlens[] = {1,100,3000};
+    size_t b,i;
+    int ok = 1;
+
+    for (b=0;b<sizeof(blocksizes)/sizeof(blocksizes[0]);++b)
+        for (i=0;i<sizeof(irlens)/sizeof(irlens[0]);++i)
+            ok &= check(blocksizes[b],irlens[i],40);
+
+    if (!ok) {
+        printf("partitioned convolution does not match direct convolution\n");
+        return 1;
+    }
+
+    /* a 1 second reverb at 48 kHz */
+    for (b=0;b<sizeof(blocksizes)/sizeof(blocksizes[0]);++b)
+        bench(blocksizes[b],48000,2000);
+    return 0;
+}
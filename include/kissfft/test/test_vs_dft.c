@@ -35,40 +35,63 @@ void check(kiss_fft_cpx  * in,kiss_fft_cpx  * out,int nfft,int isinverse)
     printf("nfft=%d inverse=%d,snr = %f\n",nfft,isinverse,10*log10(sigpow/errpow) );
 }
 
-void test1d(int nfft,int isinverse)
+/* vectorized butterflies must match the scalar ones bit for bit */
+int parity(kiss_fft_cfg cfg,kiss_fft_cpx * in,kiss_fft_cpx * out,int nfft,int isinverse)
+{
+    size_t buflen = sizeof(kiss_fft_cpx)*nfft;
+    kiss_fft_cpx  * vout;
+    int isa,ndiff;
+
+    isa = kiss_fft_set_isa(-1);
+    if (isa == KISS_FFT_ISA_SCALAR)
+        return 0;
+
+    vout = (kiss_fft_cpx*)malloc(buflen);
+    kiss_fft(cfg,in,vout);
+    ndiff = memcmp(out,vout,buflen) != 0;
+    printf("nfft=%d inverse=%d,isa %d vs scalar: %s\n",nfft,isinverse,isa,ndiff ? "DIFFERENT" : "bit-exact");
+    free(vout);
+    return ndiff;
+}
+
+int test1d(int nfft,int isinverse)
 {
     size_t buflen = sizeof(kiss_fft_cpx)*nfft;
 
     kiss_fft_cpx  * in = (kiss_fft_cpx*)malloc(buflen);
     kiss_fft_cpx  * out= (kiss_fft_cpx*)malloc(buflen);
     kiss_fft_cfg  cfg = kiss_fft_alloc(nfft,isinverse,0,0);
-    int k;
+    int k,ndiff;
 
     for (k=0;k<nfft;++k) {
         in[k].r = (rand() % 65536) - 32768;
         in[k].i = (rand() % 65536) - 32768;
     }
 
+    kiss_fft_set_isa(KISS_FFT_ISA_SCALAR);
     kiss_fft(cfg,in,out);
 
     check(in,out,nfft,isinverse);
+    ndiff = parity(cfg,in,out,nfft,isinverse);
 
     free(in);
     free(out);
     free(cfg);
+    return ndiff;
 }
 
 int main(int argc,char ** argv)
 {
+    int nfail = 0;
     if (argc>1) {
         int k;
         for (k=1;k<argc;++k) {
-            test1d(atoi(argv[k]),0);
-            test1d(atoi(argv[k]),1);
+            nfail += test1d(atoi(argv[k]),0);
+            nfail += test1d(atoi(argv[k]),1);
         }
     }else{
-        test1d(32,0);
-        test1d(32,1);
+        nfail += test1d(32,0);
+        nfail += test1d(32,1);
     }
-    return 0;
+    return nfail != 0;
 }
@@ -0,0 +1,107 @@
+#include "kissfft.hh"
+#include "kissfft_i32.hh"
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+
+#include <sys/time.h>
+static inline
+double curtime(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec + (double)tv.tv_usec*.000001;
+}
+
+using namespace std;
+
+typedef complex<int32_t> icpx;
+
+// Block floating point for int16 input: shift the whole block so its peak
+// sits just under the headroom the transform needs (log2(nfft)+2 bits),
+// and return the shift; quiet blocks move up instead of losing bits.
+static int blockscale(const vector<icpx> & in, vector<icpx> & out, int nfft)
+{
+    int32_t peak = 0;
+    for (int k=0;k<nfft;++k) {
+        peak = max(peak, abs(in[k].real()));
+        peak = max(peak, abs(in[k].imag()));
+    }
+    int guard = 2;
+    while ((1 << guard) < nfft)
+        ++guard;
+    int bits = 0;
+    while (bits < 31 && (int32_t(1) << bits) <= peak)
+        ++bits;
+    const int shift = (31 - guard) - bits;
+    for (int k=0;k<nfft;++k) {
+        if (shift >= 0)
+            out[k] = icpx(in[k].real() << shift, in[k].imag() << shift);
+        else
+            out[k] = icpx(in[k].real() >> -shift, in[k].imag() >> -shift);
+    }
+    return shift;
+}
+
+// int16 input at a level (1 is full scale); SNR of the float and the
+// integer transform against a long double DFT, and their speed
+static void dotest(int nfft, double level)
+{
+    cout << "nfft:" << nfft << " level:" << level;
+
+    kissfft<float> ffft(nfft,false);
+    kissfft_i32 ifft(nfft,false,1<<30);
+
+    vector<icpx> pcm(nfft), iin(nfft), iout(nfft);
+    vector< complex<float> > fin(nfft), fout(nfft);
+    for (int k=0;k<nfft;++k) {
+        pcm[k] = icpx(
+                (int32_t)floor(level * (rand()/(double)RAND_MAX - .5) * 65535 + .5),
+                (int32_t)floor(level * (rand()/(double)RAND_MAX - .5) * 65535 + .5) );
+        fin[k] = complex<float>( pcm[k].real() / 32768.f, pcm[k].imag() / 32768.f );
+    }
+    const int shift = blockscale(pcm, iin, nfft);
+    ffft.transform( &fin[0] , &fout[0] );
+    ifft.transform( &iin[0] , &iout[0] );
+
+    const long double iscale = ldexpl(1.0L, -shift) / 32768;
+    long double totalpower=0, fdifpower=0, idifpower=0;
+    for (int k0=0;k0<nfft;++k0) {
+        complex<long double> acc = 0;
+        long double phinc = 2*k0* M_PIl / nfft;
+        for (int k1=0;k1<nfft;++k1) {
+            complex<long double> x(fin[k1].real(),fin[k1].imag());
+            acc += x * exp( complex<long double>(0,-k1*phinc) );
+        }
+        totalpower += norm(acc);
+        fdifpower += norm(acc - complex<long double>(fout[k0].real(),fout[k0].imag()));
+        idifpower += norm(acc - complex<long double>(iout[k0].real()*iscale,iout[k0].imag()*iscale));
+    }
+    cout << " shift:" << shift;
+    cout << " SNR float:" << 10*log10(totalpower/fdifpower) << "dB";
+    cout << " i32:" << 10*log10(totalpower/idifpower) << "dB\t";
+
+    int nits=20e6/nfft;
+    double t0 = curtime();
+    for (int k=0;k<nits;++k)
+        ffft.transform( &fin[0] , &fout[0] );
+    double t1 = curtime();
+    for (int k=0;k<nits;++k)
+        ifft.transform( &iin[0] , &iout[0] );
+    double t2 = curtime();
+    cout << " MSPS float:" << ( (nits*nfft)*1e-6/ (t1-t0) );
+    cout << " i32:" << ( (nits*nfft)*1e-6/ (t2-t1) ) << endl;
+}
+
+int main(int argc,char ** argv)
+{
+    if (argc>1) {
+        for (int k=1;k<argc;++k)
+            dotest(atoi(argv[k]), 1.0);
+    }else{
+        dotest(1024, 1.0); dotest(1024, 1e-3);
+        dotest(840, 1.0);
+        dotest(4096, 1.0); dotest(4096, 1e-3);
+    }
+    return 0;
+}
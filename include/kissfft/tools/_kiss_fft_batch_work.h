@@ -0,0 +1,398 @@
+/*
+Copyright (c) 2003-2010, Mark Borgerding
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * Neither the author nor the names of any contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/* _kiss_fft_batch_work.h
+
+   Butterflies and recursion of kiss_fft.c, rewritten for KFB_W lanes at a time.
+   Included once per instruction set by kiss_fft_batch.c, which defines:
+
+     KFB_NAME(x)          decorate a function name for this instruction set
+     KFB_TARGET           function attribute needed to compile it (may be empty)
+     KFB_W                lanes per vector
+     kfb_v                vector type
+     KFB_LOAD(p)          unaligned load of KFB_W floats
+     KFB_STORE(p,v)       unaligned store of KFB_W floats
+     KFB_SET1(x)          broadcast a float
+     KFB_ADD, KFB_SUB, KFB_MUL, KFB_NEG
+
+   Every function works on one group of KFB_W consecutive lanes out of 'lanes';
+   a complex element is 'es' = 2*lanes floats apart, with imag 'lanes' floats
+   after real.  Operation order follows kiss_fft.c so each lane matches the
+   scalar transform.
+ */
+
+typedef struct {
+    kfb_v r;
+    kfb_v i;
+} KFB_NAME(kfb_cpx);
+
+#define kfb_cpx KFB_NAME(kfb_cpx)
+
+#define KFB_LD(c,p,im) \
+    do{ (c).r = KFB_LOAD(p); (c).i = KFB_LOAD((p)+(im)); }while(0)
+#define KFB_ST(p,c,im) \
+    do{ KFB_STORE(p,(c).r); KFB_STORE((p)+(im),(c).i); }while(0)
+#define KFB_TW(c,t) \
+    do{ (c).r = KFB_SET1((t).r); (c).i = KFB_SET1((t).i); }while(0)
+#define KFB_CMUL(m,a,b) \
+    do{ (m).r = KFB_SUB( KFB_MUL((a).r,(b).r) , KFB_MUL((a).i,(b).i) );\
+        (m).i = KFB_ADD( KFB_MUL((a).r,(b).i) , KFB_MUL((a).i,(b).r) ); }while(0)
+#define KFB_CADD(res,a,b) \
+    do{ (res).r = KFB_ADD((a).r,(b).r); (res).i = KFB_ADD((a).i,(b).i); }while(0)
+#define KFB_CSUB(res,a,b) \
+    do{ (res).r = KFB_SUB((a).r,(b).r); (res).i = KFB_SUB((a).i,(b).i); }while(0)
+
+static KFB_TARGET void KFB_NAME(kfb_bfly2)(
+        float * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    float * Fout2 = Fout + m*es;
+    const kiss_fft_cpx * tw1 = st->twiddles;
+    kfb_cpx a,b,t,tw;
+    do{
+        KFB_LD(a,Fout,lanes);
+        KFB_LD(b,Fout2,lanes);
+        KFB_TW(tw,*tw1);
+
+        KFB_CMUL(t,b,tw);
+        tw1 += fstride;
+        KFB_CSUB(b,a,t);
+        KFB_CADD(a,a,t);
+
+        KFB_ST(Fout2,b,lanes);
+        KFB_ST(Fout,a,lanes);
+        Fout2 += es;
+        Fout += es;
+    }while (--m);
+}
+
+static KFB_TARGET void KFB_NAME(kfb_bfly4)(
+        float * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        const size_t m,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    const kiss_fft_cpx *tw1,*tw2,*tw3;
+    kfb_cpx f0,f1,f2,f3,tw,scratch[6];
+    size_t k=m;
+    const size_t m1=m*es;
+    const size_t m2=2*m*es;
+    const size_t m3=3*m*es;
+
+    tw3 = tw2 = tw1 = st->twiddles;
+
+    do {
+        KFB_LD(f0,Fout,lanes);
+        KFB_LD(f1,Fout+m1,lanes);
+        KFB_LD(f2,Fout+m2,lanes);
+        KFB_LD(f3,Fout+m3,lanes);
+
+        KFB_TW(tw,*tw1); KFB_CMUL(scratch[0],f1,tw);
+        KFB_TW(tw,*tw2); KFB_CMUL(scratch[1],f2,tw);
+        KFB_TW(tw,*tw3); KFB_CMUL(scratch[2],f3,tw);
+
+        KFB_CSUB( scratch[5] , f0, scratch[1] );
+        KFB_CADD( f0, f0, scratch[1] );
+        KFB_CADD( scratch[3] , scratch[0] , scratch[2] );
+        KFB_CSUB( scratch[4] , scratch[0] , scratch[2] );
+        KFB_CSUB( f2, f0, scratch[3] );
+        tw1 += fstride;
+        tw2 += fstride*2;
+        tw3 += fstride*3;
+        KFB_CADD( f0, f0, scratch[3] );
+
+        if(st->inverse) {
+            f1.r = KFB_SUB(scratch[5].r,scratch[4].i);
+            f1.i = KFB_ADD(scratch[5].i,scratch[4].r);
+            f3.r = KFB_ADD(scratch[5].r,scratch[4].i);
+            f3.i = KFB_SUB(scratch[5].i,scratch[4].r);
+        }else{
+            f1.r = KFB_ADD(scratch[5].r,scratch[4].i);
+            f1.i = KFB_SUB(scratch[5].i,scratch[4].r);
+            f3.r = KFB_SUB(scratch[5].r,scratch[4].i);
+            f3.i = KFB_ADD(scratch[5].i,scratch[4].r);
+        }
+
+        KFB_ST(Fout,f0,lanes);
+        KFB_ST(Fout+m1,f1,lanes);
+        KFB_ST(Fout+m2,f2,lanes);
+        KFB_ST(Fout+m3,f3,lanes);
+        Fout += es;
+    }while(--k);
+}
+
+static KFB_TARGET void KFB_NAME(kfb_bfly3)(
+         float * Fout,
+         const size_t fstride,
+         const kiss_fft_cfg st,
+         size_t m,
+         const int lanes
+         )
+{
+     const size_t es = 2*lanes;
+     size_t k=m;
+     const size_t m1 = m*es;
+     const size_t m2 = 2*m*es;
+     const kiss_fft_cpx *tw1,*tw2;
+     kfb_cpx f0,f1,f2,tw,scratch[4];
+     const kfb_v epi3 = KFB_SET1(st->twiddles[fstride*m].i);
+     const kfb_v half = KFB_SET1(.5f);
+
+     tw1=tw2=st->twiddles;
+
+     do{
+         KFB_LD(f0,Fout,lanes);
+         KFB_LD(f1,Fout+m1,lanes);
+         KFB_LD(f2,Fout+m2,lanes);
+
+         KFB_TW(tw,*tw1); KFB_CMUL(scratch[1],f1,tw);
+         KFB_TW(tw,*tw2); KFB_CMUL(scratch[2],f2,tw);
+
+         KFB_CADD(scratch[3],scratch[1],scratch[2]);
+         KFB_CSUB(scratch[0],scratch[1],scratch[2]);
+         tw1 += fstride;
+         tw2 += fstride*2;
+
+         f1.r = KFB_SUB(f0.r,KFB_MUL(scratch[3].r,half));
+         f1.i = KFB_SUB(f0.i,KFB_MUL(scratch[3].i,half));
+
+         scratch[0].r = KFB_MUL(scratch[0].r,epi3);
+         scratch[0].i = KFB_MUL(scratch[0].i,epi3);
+
+         KFB_CADD(f0,f0,scratch[3]);
+
+         f2.r = KFB_ADD(f1.r,scratch[0].i);
+         f2.i = KFB_SUB(f1.i,scratch[0].r);
+
+         f1.r = KFB_SUB(f1.r,scratch[0].i);
+         f1.i = KFB_ADD(f1.i,scratch[0].r);
+
+         KFB_ST(Fout,f0,lanes);
+         KFB_ST(Fout+m1,f1,lanes);
+         KFB_ST(Fout+m2,f2,lanes);
+         Fout += es;
+     }while(--k);
+}
+
+static KFB_TARGET void KFB_NAME(kfb_bfly5)(
+        float * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    float *Fout0,*Fout1,*Fout2,*Fout3,*Fout4;
+    int u;
+    kfb_cpx f0,f1,f2,f3,f4,tw,scratch[13];
+    const kiss_fft_cpx * twiddles = st->twiddles;
+    const kfb_v yar = KFB_SET1(twiddles[fstride*m].r);
+    const kfb_v yai = KFB_SET1(twiddles[fstride*m].i);
+    const kfb_v ybr = KFB_SET1(twiddles[fstride*2*m].r);
+    const kfb_v ybi = KFB_SET1(twiddles[fstride*2*m].i);
+
+    Fout0=Fout;
+    Fout1=Fout0+m*es;
+    Fout2=Fout0+2*m*es;
+    Fout3=Fout0+3*m*es;
+    Fout4=Fout0+4*m*es;
+
+    for ( u=0; u<m; ++u ) {
+        KFB_LD(f0,Fout0,lanes);
+        KFB_LD(f1,Fout1,lanes);
+        KFB_LD(f2,Fout2,lanes);
+        KFB_LD(f3,Fout3,lanes);
+        KFB_LD(f4,Fout4,lanes);
+        scratch[0] = f0;
+
+        KFB_TW(tw,twiddles[u*fstride]);   KFB_CMUL(scratch[1],f1,tw);
+        KFB_TW(tw,twiddles[2*u*fstride]); KFB_CMUL(scratch[2],f2,tw);
+        KFB_TW(tw,twiddles[3*u*fstride]); KFB_CMUL(scratch[3],f3,tw);
+        KFB_TW(tw,twiddles[4*u*fstride]); KFB_CMUL(scratch[4],f4,tw);
+
+        KFB_CADD( scratch[7],scratch[1],scratch[4]);
+        KFB_CSUB( scratch[10],scratch[1],scratch[4]);
+        KFB_CADD( scratch[8],scratch[2],scratch[3]);
+        KFB_CSUB( scratch[9],scratch[2],scratch[3]);
+
+        f0.r = KFB_ADD(f0.r,KFB_ADD(scratch[7].r,scratch[8].r));
+        f0.i = KFB_ADD(f0.i,KFB_ADD(scratch[7].i,scratch[8].i));
+
+        scratch[5].r = KFB_ADD(KFB_ADD(scratch[0].r,KFB_MUL(scratch[7].r,yar)),KFB_MUL(scratch[8].r,ybr));
+        scratch[5].i = KFB_ADD(KFB_ADD(scratch[0].i,KFB_MUL(scratch[7].i,yar)),KFB_MUL(scratch[8].i,ybr));
+
+        scratch[6].r = KFB_ADD(KFB_MUL(scratch[10].i,yai),KFB_MUL(scratch[9].i,ybi));
+        scratch[6].i = KFB_SUB(KFB_NEG(KFB_MUL(scratch[10].r,yai)),KFB_MUL(scratch[9].r,ybi));
+
+        KFB_CSUB(f1,scratch[5],scratch[6]);
+        KFB_CADD(f4,scratch[5],scratch[6]);
+
+        scratch[11].r = KFB_ADD(KFB_ADD(scratch[0].r,KFB_MUL(scratch[7].r,ybr)),KFB_MUL(scratch[8].r,yar));
+        scratch[11].i = KFB_ADD(KFB_ADD(scratch[0].i,KFB_MUL(scratch[7].i,ybr)),KFB_MUL(scratch[8].i,yar));
+        scratch[12].r = KFB_ADD(KFB_NEG(KFB_MUL(scratch[10].i,ybi)),KFB_MUL(scratch[9].i,yai));
+        scratch[12].i = KFB_SUB(KFB_MUL(scratch[10].r,ybi),KFB_MUL(scratch[9].r,yai));
+
+        KFB_CADD(f2,scratch[11],scratch[12]);
+        KFB_CSUB(f3,scratch[11],scratch[12]);
+
+        KFB_ST(Fout0,f0,lanes);
+        KFB_ST(Fout1,f1,lanes);
+        KFB_ST(Fout2,f2,lanes);
+        KFB_ST(Fout3,f3,lanes);
+        KFB_ST(Fout4,f4,lanes);
+        Fout0+=es;Fout1+=es;Fout2+=es;Fout3+=es;Fout4+=es;
+    }
+}
+
+/* scratch holds p complex vectors: 2*KFB_W floats each, imag KFB_W after real */
+static KFB_TARGET void KFB_NAME(kfb_bfly_generic)(
+        float * Fout,
+        const size_t fstride,
+        const kiss_fft_cfg st,
+        int m,
+        int p,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    int u,k,q1,q;
+    const kiss_fft_cpx * twiddles = st->twiddles;
+    kfb_cpx a,t,tw;
+    int Norig = st->nfft;
+
+    float * scratch = (float*)KISS_FFT_TMP_ALLOC(sizeof(float)*2*KFB_W*p);
+
+    for ( u=0; u<m; ++u ) {
+        k=u;
+        for ( q1=0 ; q1<p ; ++q1 ) {
+            KFB_LD(a,Fout+k*es,lanes);
+            KFB_ST(scratch+q1*2*KFB_W,a,KFB_W);
+            k += m;
+        }
+
+        k=u;
+        for ( q1=0 ; q1<p ; ++q1 ) {
+            int twidx=0;
+            kfb_cpx sum;
+            KFB_LD(sum,scratch,KFB_W);
+            for (q=1;q<p;++q ) {
+                twidx += fstride * k;
+                if (twidx>=Norig) twidx-=Norig;
+                KFB_LD(a,scratch+q*2*KFB_W,KFB_W);
+                KFB_TW(tw,twiddles[twidx]);
+                KFB_CMUL(t,a,tw);
+                KFB_CADD(sum,sum,t);
+            }
+            KFB_ST(Fout+k*es,sum,lanes);
+            k += m;
+        }
+    }
+    KISS_FFT_TMP_FREE(scratch);
+}
+
+static KFB_TARGET void KFB_NAME(kfb_work)(
+        float * Fout,
+        const float * f,
+        const size_t fstride,
+        const int * factors,
+        const kiss_fft_cfg st,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    float * Fout_beg=Fout;
+    const int p=*factors++; /* the radix  */
+    const int m=*factors++; /* stage's fft length/p */
+    const float * Fout_end = Fout + p*m*es;
+
+    if (m==1) {
+        do{
+            KFB_STORE(Fout,KFB_LOAD(f));
+            KFB_STORE(Fout+lanes,KFB_LOAD(f+lanes));
+            f += fstride*es;
+        }while( (Fout += es) != Fout_end );
+    }else{
+        do{
+            KFB_NAME(kfb_work)( Fout , f, fstride*p, factors, st, lanes);
+            f += fstride*es;
+        }while( (Fout += m*es) != Fout_end );
+    }
+
+    Fout=Fout_beg;
+
+    switch (p) {
+        case 2: KFB_NAME(kfb_bfly2)(Fout,fstride,st,m,lanes); break;
+        case 3: KFB_NAME(kfb_bfly3)(Fout,fstride,st,m,lanes); break;
+        case 4: KFB_NAME(kfb_bfly4)(Fout,fstride,st,m,lanes); break;
+        case 5: KFB_NAME(kfb_bfly5)(Fout,fstride,st,m,lanes); break;
+        default: KFB_NAME(kfb_bfly_generic)(Fout,fstride,st,m,p,lanes); break;
+    }
+}
+
+/* split the packed half-size transform into the real spectrum, as kiss_fftr does */
+static KFB_TARGET void KFB_NAME(kfb_real_split)(
+        const float * tmpbuf,
+        float * freqdata,
+        const kiss_fft_cpx * super_twiddles,
+        const int ncfft,
+        const int lanes
+        )
+{
+    const size_t es = 2*lanes;
+    const kfb_v half = KFB_SET1(.5f);
+    const kfb_v zero = KFB_SET1(0.f);
+    kfb_cpx tdc,fpk,fpnk,f1k,f2k,stw,tw,out;
+    int k;
+
+    KFB_LD(tdc,tmpbuf,lanes);
+    KFB_STORE(freqdata,KFB_ADD(tdc.r,tdc.i));
+    KFB_STORE(freqdata+lanes,zero);
+    KFB_STORE(freqdata+ncfft*es,KFB_SUB(tdc.r,tdc.i));
+    KFB_STORE(freqdata+ncfft*es+lanes,zero);
+
+    for ( k=1;k <= ncfft/2 ; ++k ) {
+        KFB_LD(fpk,tmpbuf+k*es,lanes);
+        KFB_LD(fpnk,tmpbuf+(ncfft-k)*es,lanes);
+        fpnk.i = KFB_NEG(fpnk.i);
+
+        KFB_CADD( f1k, fpk , fpnk );
+        KFB_CSUB( f2k, fpk , fpnk );
+        KFB_TW(stw,super_twiddles[k-1]);
+        KFB_CMUL( tw , f2k , stw );
+
+        out.r = KFB_MUL(KFB_ADD(f1k.r,tw.r),half);
+        out.i = KFB_MUL(KFB_ADD(f1k.i,tw.i),half);
+        KFB_ST(freqdata+k*es,out,lanes);
+        out.r = KFB_MUL(KFB_SUB(f1k.r,tw.r),half);
+        out.i = KFB_MUL(KFB_SUB(tw.i,f1k.i),half);
+        KFB_ST(freqdata+(ncfft-k)*es,out,lanes);
+    }
+}
+
+#undef kfb_cpx
+#undef KFB_LD
+#undef KFB_ST
+#undef KFB_TW
+#undef KFB_CMUL
+#undef KFB_CADD
+#undef KFB_CSUB
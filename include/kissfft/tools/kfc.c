@@ -15,93 +15,329 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 */
 
 
+#include "kiss_fftr.h"
+#include "_kiss_fft_guts.h"
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK kfc_lock_t;
+#define KFC_LOCK_INIT SRWLOCK_INIT
+#define kfc_lock(l) AcquireSRWLockExclusive(l)
+#define kfc_unlock(l) ReleaseSRWLockExclusive(l)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t kfc_lock_t;
+#define KFC_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define kfc_lock(l) pthread_mutex_lock(l)
+#define kfc_unlock(l) pthread_mutex_unlock(l)
+#endif
+
+/* power of two; chains stay short for any realistic set of sizes */
+#define KFC_NBUCKETS 64
+
 typedef struct cached_fft *kfc_cfg;
 
 struct cached_fft
 {
     int nfft;
     int inverse;
-    kiss_fft_cfg cfg;
-    kfc_cfg next;
+    int real;
+    void * cfg;         /* kiss_fft_cfg or kiss_fftr_cfg, depending on real */
+    size_t bytes;       /* whole node, cfg included */
+    int refs;           /* transforms currently running with cfg */
+    int dead;           /* evicted while in use, free when refs drops to 0 */
+    kfc_cfg hnext;      /* bucket chain */
+    kfc_cfg newer;      /* lru list, most recently used at lru_head */
+    kfc_cfg older;
 };
 
-static kfc_cfg cache_root=NULL;
-static int ncached=0;
+static kfc_lock_t cache_lock = KFC_LOCK_INIT;
+static kfc_cfg buckets[KFC_NBUCKETS];
+static kfc_cfg lru_head=NULL;
+static kfc_cfg lru_tail=NULL;
+static size_t budget=0;
+static kfc_stats stats;
 
-static kiss_fft_cfg find_cached_fft(int nfft,int inverse)
+static unsigned kfc_hash(int nfft,int inverse,int real)
 {
-    size_t len;
-    kfc_cfg  cur=cache_root;
-    kfc_cfg  prev=NULL;
-    while ( cur ) {
-        if ( cur->nfft == nfft && inverse == cur->inverse )
-            break;/*found the right node*/
-        prev = cur;
-        cur = prev->next;
+    unsigned h = (unsigned)nfft * 2654435761u;
+    h ^= (unsigned)(inverse | real<<1) * 40503u;
+    return (h >> 16) & (KFC_NBUCKETS-1);
+}
+
+static void lru_unlink(kfc_cfg cur)
+{
+    if (cur->newer)
+        cur->newer->older = cur->older;
+    else
+        lru_head = cur->older;
+    if (cur->older)
+        cur->older->newer = cur->newer;
+    else
+        lru_tail = cur->newer;
+    cur->newer = cur->older = NULL;
+}
+
+static void lru_push(kfc_cfg cur)
+{
+    cur->newer = NULL;
+    cur->older = lru_head;
+    if (lru_head)
+        lru_head->newer = cur;
+    else
+        lru_tail = cur;
+    lru_head = cur;
+}
+
+/* take a node out of the table; it is freed now or by the last kfc_release */
+static void cache_remove(kfc_cfg cur)
+{
+    kfc_cfg * link = &buckets[kfc_hash(cur->nfft,cur->inverse,cur->real)];
+    while (*link != cur)
+        link = &(*link)->hnext;
+    *link = cur->hnext;
+    lru_unlink(cur);
+    --stats.entries;
+    stats.bytes -= cur->bytes;
+    if (cur->refs)
+        cur->dead = 1;
+    else
+        free(cur);
+}
+
+/* make room for 'bytes' more, oldest first, skipping nodes in use */
+static void cache_trim(size_t bytes)
+{
+    kfc_cfg cur = lru_tail;
+    while (budget && cur && stats.bytes + bytes > budget) {
+        kfc_cfg newer = cur->newer;
+        if (cur->refs == 0) {
+            cache_remove(cur);
+            ++stats.evictions;
+        }
+        cur = newer;
     }
-    if (cur== NULL) {
-        /* no cached node found, need to create a new one*/
+}
+
+static kfc_cfg cache_create(int nfft,int inverse,int real)
+{
+    size_t len=0;
+    size_t padding=0;
+    kfc_cfg cur;
+    if (real)
+        kiss_fftr_alloc(nfft,inverse,0,&len);
+    else
         kiss_fft_alloc(nfft,inverse,0,&len);
 #ifdef USE_SIMD
-        int padding = (16-sizeof(struct cached_fft)) & 15;
-        // make sure the cfg aligns on a 16 byte boundary
-        len += padding;
-#endif
-        cur = (kfc_cfg)KISS_FFT_MALLOC((sizeof(struct cached_fft) + len ));
-        if (cur == NULL)
-            return NULL;
-        cur->cfg = (kiss_fft_cfg)(cur+1);
-#ifdef USE_SIMD
-        cur->cfg = (kiss_fft_cfg) ((char*)(cur+1)+padding);
+    padding = (16-sizeof(struct cached_fft)) & 15;
+    // make sure the cfg aligns on a 16 byte boundary
+    len += padding;
 #endif
+    cur = (kfc_cfg)KISS_FFT_MALLOC((sizeof(struct cached_fft) + len ));
+    if (cur == NULL)
+        return NULL;
+    cur->cfg = (char*)(cur+1)+padding;
+    if (real)
+        kiss_fftr_alloc(nfft,inverse,cur->cfg,&len);
+    else
         kiss_fft_alloc(nfft,inverse,cur->cfg,&len);
-        cur->nfft=nfft;
-        cur->inverse=inverse;
-        cur->next = NULL;
-        if ( prev )
-            prev->next = cur;
-        else
-            cache_root = cur;
-        ++ncached;
+    cur->nfft=nfft;
+    cur->inverse=inverse;
+    cur->real=real;
+    cur->bytes=sizeof(struct cached_fft) + len;
+    cur->refs=0;
+    cur->dead=0;
+    cur->hnext=NULL;
+    cur->newer=cur->older=NULL;
+    return cur;
+}
+
+/* node for a size in a bucket, or NULL; cache_lock held */
+static kfc_cfg cache_find(kfc_cfg cur,int nfft,int inverse,int real)
+{
+    for (; cur; cur = cur->hnext)
+        if ( cur->nfft == nfft && cur->inverse == inverse && cur->real == real )
+            break;/*found the right node*/
+    return cur;
+}
+
+/* find or create a node and pin it until kfc_release */
+static kfc_cfg kfc_acquire(int nfft,int inverse,int real)
+{
+    kfc_cfg * bucket = &buckets[kfc_hash(nfft,inverse,real)];
+    kfc_cfg cur, made;
+
+    kfc_lock(&cache_lock);
+    cur = cache_find(*bucket,nfft,inverse,real);
+    if (cur) {
+        ++stats.hits;
+        if (cur != lru_head) {
+            lru_unlink(cur);
+            lru_push(cur);
+        }
+        ++cur->refs;
+        kfc_unlock(&cache_lock);
+        return cur;
     }
-    return cur->cfg;
+    ++stats.misses;
+    kfc_unlock(&cache_lock);
+
+    /* no cached node found, plan a new one without holding the lock, so
+       other threads' hits do not wait on the malloc and twiddles */
+    made = cache_create(nfft,inverse,real);
+    if (made == NULL)
+        return NULL;
+
+    /* another thread may have planned the same size meanwhile; keep the
+       node that got in first and drop this one */
+    kfc_lock(&cache_lock);
+    cur = cache_find(*bucket,nfft,inverse,real);
+    if (cur == NULL) {
+        cur = made;
+        made = NULL;
+        cache_trim(cur->bytes);
+        cur->hnext = *bucket;
+        *bucket = cur;
+        lru_push(cur);
+        ++stats.entries;
+        stats.bytes += cur->bytes;
+    }
+    ++cur->refs;
+    kfc_unlock(&cache_lock);
+    free(made);
+    return cur;
 }
 
-void kfc_cleanup(void)
+static void kfc_release(kfc_cfg cur)
 {
-    kfc_cfg  cur=cache_root;
-    kfc_cfg  next=NULL;
-    while (cur){
-        next = cur->next;
+    kfc_lock(&cache_lock);
+    if (--cur->refs == 0 && cur->dead)
         free(cur);
-        cur=next;
-    }
-    ncached=0;
-    cache_root = NULL;
+    kfc_unlock(&cache_lock);
+}
+
+void kfc_set_budget(size_t bytes)
+{
+    kfc_lock(&cache_lock);
+    budget = bytes;
+    cache_trim(0);
+    kfc_unlock(&cache_lock);
+}
+
+void kfc_get_stats(kfc_stats * out)
+{
+    kfc_lock(&cache_lock);
+    *out = stats;
+    kfc_unlock(&cache_lock);
+}
+
+void kfc_cleanup(void)
+{
+    kfc_lock(&cache_lock);
+    while (lru_head)
+        cache_remove(lru_head);
+    memset(&stats,0,sizeof(stats));
+    kfc_unlock(&cache_lock);
 }
+
 void kfc_fft(int nfft, const kiss_fft_cpx * fin,kiss_fft_cpx * fout)
 {
-    kiss_fft( find_cached_fft(nfft,0),fin,fout );
+    kfc_cfg cur = kfc_acquire(nfft,0,0);
+    if (cur == NULL)
+        return;
+    kiss_fft( (kiss_fft_cfg)cur->cfg,fin,fout );
+    kfc_release(cur);
 }
 
 void kfc_ifft(int nfft, const kiss_fft_cpx * fin,kiss_fft_cpx * fout)
 {
-    kiss_fft( find_cached_fft(nfft,1),fin,fout );
+    kfc_cfg cur = kfc_acquire(nfft,1,0);
+    if (cur == NULL)
+        return;
+    kiss_fft( (kiss_fft_cfg)cur->cfg,fin,fout );
+    kfc_release(cur);
+}
+
+void kfc_fftr(int nfft, const kiss_fft_scalar * timedata,kiss_fft_cpx * freqdata)
+{
+    kiss_fft_cpx * scratch;
+    kfc_cfg cur = kfc_acquire(nfft,0,1);
+    if (cur == NULL)
+        return;
+    scratch = (kiss_fft_cpx*)KISS_FFT_TMP_ALLOC(sizeof(kiss_fft_cpx)*(nfft/2));
+    kiss_fftr_scratch( (kiss_fftr_cfg)cur->cfg,timedata,freqdata,scratch );
+    KISS_FFT_TMP_FREE(scratch);
+    kfc_release(cur);
+}
+
+void kfc_ifftr(int nfft, const kiss_fft_cpx * freqdata,kiss_fft_scalar * timedata)
+{
+    kiss_fft_cpx * scratch;
+    kfc_cfg cur = kfc_acquire(nfft,1,1);
+    if (cur == NULL)
+        return;
+    scratch = (kiss_fft_cpx*)KISS_FFT_TMP_ALLOC(sizeof(kiss_fft_cpx)*(nfft/2));
+    kiss_fftri_scratch( (kiss_fftr_cfg)cur->cfg,freqdata,timedata,scratch );
+    KISS_FFT_TMP_FREE(scratch);
+    kfc_release(cur);
 }
 
 #ifdef KFC_TEST
 static void check(int nc)
 {
-    if (ncached != nc) {
-        fprintf(stderr,"ncached should be %d,but it is %d\n",nc,ncached);
+    kfc_stats st;
+    kfc_get_stats(&st);
+    if (st.entries != (size_t)nc) {
+        fprintf(stderr,"ncached should be %d,but it is %d\n",nc,(int)st.entries);
         exit(1);
     }
 }
 
+static void check_counts(unsigned long hits,unsigned long misses,unsigned long evictions)
+{
+    kfc_stats st;
+    kfc_get_stats(&st);
+    if (st.hits != hits || st.misses != misses || st.evictions != evictions) {
+        fprintf(stderr,"expected %lu hits %lu misses %lu evictions, got %lu %lu %lu\n",
+                hits,misses,evictions,st.hits,st.misses,st.evictions);
+        exit(1);
+    }
+}
+
+#ifndef _WIN32
+#define NTHREADS 4
+static void * worker(void * arg)
+{
+    kiss_fft_cpx in[1024],out[1024],back[1024];
+    int i,k;
+    (void)arg;
+    for (i=0;i<200;++i) {
+        /* cycle through more sizes than the budget holds */
+        int nfft = 64 << (i%5);
+        for (k=0;k<nfft;++k) {
+            in[k].r = (kiss_fft_scalar)(k%7);
+            in[k].i = (kiss_fft_scalar)(k%3);
+        }
+        kfc_fft(nfft,in,out);
+        kfc_ifft(nfft,out,back);
+        for (k=0;k<nfft;++k) {
+            if (fabs(back[k].r/nfft - in[k].r) > .01 || fabs(back[k].i/nfft - in[k].i) > .01) {
+                fprintf(stderr,"round trip failed for nfft=%d\n",nfft);
+                exit(1);
+            }
+        }
+    }
+    return NULL;
+}
+#endif
+
 int main(void)
 {
     kiss_fft_cpx buf1[1024],buf2[1024];
+    kiss_fft_scalar rbuf[1024];
+    kfc_stats st;
     memset(buf1,0,sizeof(buf1));
+    memset(rbuf,0,sizeof(rbuf));
     check(0);
     kfc_fft(512,buf1,buf2);
     check(1);
@@ -109,8 +345,52 @@ int main(void)
     check(1);
     kfc_ifft(512,buf1,buf2);
     check(2);
+    check_counts(1,2,0);
+    kfc_fftr(512,rbuf,buf2);
+    kfc_ifftr(512,buf2,rbuf);
+    kfc_fftr(512,rbuf,buf2);
+    check(4);
+    check_counts(2,4,0);
     kfc_cleanup();
     check(0);
+    check_counts(0,0,0);
+
+    /* a budget that fits two configs of this size evicts the oldest */
+    kfc_fft(256,buf1,buf2);
+    kfc_get_stats(&st);
+    kfc_set_budget(st.bytes*2);
+    kfc_fft(256,buf1,buf2);
+    kfc_ifft(256,buf1,buf2);
+    check(2);
+    kfc_fft(256,buf1,buf2);   /* forward is now the newest */
+    kfc_fft(128,buf1,buf2);   /* so this pushes out the inverse */
+    check(2);
+    check_counts(2,3,1);
+    kfc_ifft(256,buf1,buf2);
+    check_counts(2,4,2);
+    kfc_cleanup();
+
+#ifndef _WIN32
+    {
+        pthread_t threads[NTHREADS];
+        int i;
+        kfc_fft(1024,buf1,buf2);
+        kfc_get_stats(&st);
+        kfc_set_budget(st.bytes*3);
+        kfc_cleanup();
+        for (i=0;i<NTHREADS;++i)
+            pthread_create(&threads[i],NULL,worker,NULL);
+        for (i=0;i<NTHREADS;++i)
+            pthread_join(threads[i],NULL);
+        kfc_get_stats(&st);
+        if (st.hits + st.misses != NTHREADS*400ul || st.evictions == 0) {
+            fprintf(stderr,"threaded run: %lu hits %lu misses %lu evictions\n",st.hits,st.misses,st.evictions);
+            exit(1);
+        }
+        kfc_cleanup();
+    }
+#endif
+    kfc_set_budget(0);
     return 0;
 }
 #endif
@@ -17,17 +17,17 @@ The first time kfc_fft or kfc_ifft for a given FFT size, the cfg
 object is created for it.  All subsequent calls use the cached 
 configuration object.
 
-NOTE:
-You should probably not use this if your program will be using a lot 
-of various sizes of FFTs.  There is a linear search through the
-cached objects.  If you are only using one or two FFT sizes, this
-will be negligible. Otherwise, you may want to use another method 
-of managing the cfg objects.
- 
- There is no automated cleanup of the cached objects.  This could lead 
-to large memory usage in a program that uses a lot of *DIFFERENT* 
-sized FFTs.  If you want to force all cached cfg objects to be freed,
-call kfc_cleanup.
+Configs are kept in a hash table keyed by (size, direction, real/complex),
+so lookups take the same time however many sizes are in use.
+
+All functions may be called from several threads at once.  The cache lock
+is only held for the lookup; the transforms themselves run unlocked, and
+real transforms use their own scratch so threads can share a config.
+
+By default nothing is freed until kfc_cleanup.  kfc_set_budget caps the
+memory held by cached configs; when a new config would go over it, the
+least recently used configs are freed first.  A config in use by another
+thread is freed as soon as that thread is done with it.
  
  */
 
@@ -36,7 +36,26 @@ void kfc_fft(int nfft, const kiss_fft_cpx * fin,kiss_fft_cpx * fout);
 /*reverse complex FFT */
 void kfc_ifft(int nfft, const kiss_fft_cpx * fin,kiss_fft_cpx * fout);
 
-/*free all cached objects*/
+/*forward real FFT, nfft must be even (see kiss_fftr.h for buffer sizes) */
+void kfc_fftr(int nfft, const kiss_fft_scalar * timedata,kiss_fft_cpx * freqdata);
+/*reverse real FFT */
+void kfc_ifftr(int nfft, const kiss_fft_cpx * freqdata,kiss_fft_scalar * timedata);
+
+/*memory budget for cached configs in bytes, 0 for no limit (the default) */
+void kfc_set_budget(size_t bytes);
+
+typedef struct {
+    unsigned long hits;      /* lookups that found a cached config */
+    unsigned long misses;    /* lookups that had to create one */
+    unsigned long evictions; /* configs freed to stay within the budget */
+    size_t entries;          /* configs currently cached */
+    size_t bytes;            /* memory held by cached configs */
+} kfc_stats;
+
+/*copy the current counters */
+void kfc_get_stats(kfc_stats * stats);
+
+/*free all cached objects, reset counters*/
 void kfc_cleanup(void);
 
 #ifdef __cplusplus
@@ -0,0 +1,299 @@
+/*
+Copyright (c) 2003-2010, Mark Borgerding
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * Neither the author nor the names of any contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "kiss_fft_batch.h"
+#include "_kiss_fft_guts.h"
+
+#if defined(FIXED_POINT) || defined(USE_SIMD)
+#error "kiss_fft_batch needs a float build of kiss_fft"
+#endif
+
+#ifdef KISS_FFT_X86
+# define KFB_X86 1
+# include <immintrin.h>
+#endif
+
+/* gcc and clang only emit AVX inside functions that ask for it */
+#if defined(__GNUC__) || defined(__clang__)
+# define KFB_TARGET_SSE __attribute__((target("sse")))
+# define KFB_TARGET_AVX __attribute__((target("avx")))
+#else
+# define KFB_TARGET_SSE
+# define KFB_TARGET_AVX
+#endif
+
+
+struct kiss_fft_batch_state{
+    kiss_fft_cfg plan;      /* ordinary float plan: factors and twiddles */
+    int lanes;
+    int isa;
+};
+
+struct kiss_fftr_batch_state{
+    struct kiss_fft_batch_state sub;
+    float * tmpbuf;
+    kiss_fft_cpx * super_twiddles;
+};
+
+
+/* scalar: one lane at a time */
+#define KFB_NAME(x) x##_scalar
+#define KFB_TARGET
+#define KFB_W 1
+#define kfb_v float
+#define KFB_LOAD(p) (*(p))
+#define KFB_STORE(p,v) (*(p) = (v))
+#define KFB_SET1(x) ((float)(x))
+#define KFB_ADD(a,b) ((a)+(b))
+#define KFB_SUB(a,b) ((a)-(b))
+#define KFB_MUL(a,b) ((a)*(b))
+#define KFB_NEG(a) (-(a))
+#include "_kiss_fft_batch_work.h"
+#undef KFB_NAME
+#undef KFB_TARGET
+#undef KFB_W
+#undef kfb_v
+#undef KFB_LOAD
+#undef KFB_STORE
+#undef KFB_SET1
+#undef KFB_ADD
+#undef KFB_SUB
+#undef KFB_MUL
+#undef KFB_NEG
+
+#ifdef KFB_X86
+/* SSE: 4 lanes */
+#define KFB_NAME(x) x##_sse
+#define KFB_TARGET KFB_TARGET_SSE
+#define KFB_W 4
+#define kfb_v __m128
+#define KFB_LOAD(p) _mm_loadu_ps(p)
+#define KFB_STORE(p,v) _mm_storeu_ps(p,v)
+#define KFB_SET1(x) _mm_set1_ps(x)
+#define KFB_ADD(a,b) _mm_add_ps(a,b)
+#define KFB_SUB(a,b) _mm_sub_ps(a,b)
+#define KFB_MUL(a,b) _mm_mul_ps(a,b)
+#define KFB_NEG(a) _mm_xor_ps(a,_mm_set1_ps(-0.f))
+#include "_kiss_fft_batch_work.h"
+#undef KFB_NAME
+#undef KFB_TARGET
+#undef KFB_W
+#undef kfb_v
+#undef KFB_LOAD
+#undef KFB_STORE
+#undef KFB_SET1
+#undef KFB_ADD
+#undef KFB_SUB
+#undef KFB_MUL
+#undef KFB_NEG
+
+/* AVX: 8 lanes */
+#define KFB_NAME(x) x##_avx
+#define KFB_TARGET KFB_TARGET_AVX
+#define KFB_W 8
+#define kfb_v __m256
+#define KFB_LOAD(p) _mm256_loadu_ps(p)
+#define KFB_STORE(p,v) _mm256_storeu_ps(p,v)
+#define KFB_SET1(x) _mm256_set1_ps(x)
+#define KFB_ADD(a,b) _mm256_add_ps(a,b)
+#define KFB_SUB(a,b) _mm256_sub_ps(a,b)
+#define KFB_MUL(a,b) _mm256_mul_ps(a,b)
+#define KFB_NEG(a) _mm256_xor_ps(a,_mm256_set1_ps(-0.f))
+#include "_kiss_fft_batch_work.h"
+#undef KFB_NAME
+#undef KFB_TARGET
+#undef KFB_W
+#undef kfb_v
+#undef KFB_LOAD
+#undef KFB_STORE
+#undef KFB_SET1
+#undef KFB_ADD
+#undef KFB_SUB
+#undef KFB_MUL
+#undef KFB_NEG
+#endif
+
+
+/* best instruction set this cpu and os support */
+static
+int kfb_detect_isa(void)
+{
+    const int features = kf_x86_features();
+    if (features & KF_X86_AVX)
+        return KISS_FFT_BATCH_ISA_AVX;
+    if (features & KF_X86_SSE)
+        return KISS_FFT_BATCH_ISA_SSE;
+    return KISS_FFT_BATCH_ISA_SCALAR;
+}
+
+static int kfb_isa_limit = -1;
+
+int kiss_fft_batch_set_isa(int isa)
+{
+    const int best = kfb_detect_isa();
+    kfb_isa_limit = (isa < 0 || isa > best) ? best : isa;
+    return kfb_isa_limit;
+}
+
+static
+int kfb_current_isa(void)
+{
+    if (kfb_isa_limit < 0)
+        kfb_isa_limit = kfb_detect_isa();
+    return kfb_isa_limit;
+}
+
+/* run one batched complex transform, widest vectors first */
+static
+void kfb_run(const struct kiss_fft_batch_state * st,const float * fin,float * fout)
+{
+    const int lanes = st->lanes;
+    const int * factors = st->plan->factors;
+    int j = 0;
+#ifdef KFB_X86
+    if (st->isa >= KISS_FFT_BATCH_ISA_AVX)
+        for (; j+8<=lanes; j+=8)
+            kfb_work_avx(fout+j,fin+j,1,factors,st->plan,lanes);
+    if (st->isa >= KISS_FFT_BATCH_ISA_SSE)
+        for (; j+4<=lanes; j+=4)
+            kfb_work_sse(fout+j,fin+j,1,factors,st->plan,lanes);
+#endif
+    for (; j<lanes; ++j)
+        kfb_work_scalar(fout+j,fin+j,1,factors,st->plan,lanes);
+}
+
+static
+void kfb_run_split(const struct kiss_fftr_batch_state * st,float * freqdata)
+{
+    const int lanes = st->sub.lanes;
+    const int ncfft = st->sub.plan->nfft;
+    int j = 0;
+#ifdef KFB_X86
+    if (st->sub.isa >= KISS_FFT_BATCH_ISA_AVX)
+        for (; j+8<=lanes; j+=8)
+            kfb_real_split_avx(st->tmpbuf+j,freqdata+j,st->super_twiddles,ncfft,lanes);
+    if (st->sub.isa >= KISS_FFT_BATCH_ISA_SSE)
+        for (; j+4<=lanes; j+=4)
+            kfb_real_split_sse(st->tmpbuf+j,freqdata+j,st->super_twiddles,ncfft,lanes);
+#endif
+    for (; j<lanes; ++j)
+        kfb_real_split_scalar(st->tmpbuf+j,freqdata+j,st->super_twiddles,ncfft,lanes);
+}
+
+static
+void kfb_init(struct kiss_fft_batch_state * st,int nfft,int inverse_fft,int lanes,void * planmem,size_t plansize)
+{
+    st->plan = kiss_fft_alloc(nfft,inverse_fft,planmem,&plansize);
+    st->lanes = lanes;
+    st->isa = kfb_current_isa();
+}
+
+
+kiss_fft_batch_cfg kiss_fft_batch_alloc(int nfft,int inverse_fft,int lanes,void * mem,size_t * lenmem)
+{
+    kiss_fft_batch_cfg st = NULL;
+    size_t plansize = 0, memneeded;
+
+    if (nfft < 1 || lanes < 1)
+        return NULL;
+
+    kiss_fft_alloc(nfft,inverse_fft,NULL,&plansize);
+    memneeded = sizeof(struct kiss_fft_batch_state) + plansize;
+
+    if (lenmem == NULL) {
+        st = (kiss_fft_batch_cfg) KISS_FFT_MALLOC(memneeded);
+    } else {
+        if (mem != NULL && *lenmem >= memneeded)
+            st = (kiss_fft_batch_cfg) mem;
+        *lenmem = memneeded;
+    }
+    if (st)
+        kfb_init(st,nfft,inverse_fft,lanes,st + 1,plansize);
+    return st;
+}
+
+void kiss_fft_batch(kiss_fft_batch_cfg st,const float *fin,float *fout)
+{
+    if (fin == fout) {
+        /* not in-place either; same as kiss_fft_stride */
+        const size_t nbytes = sizeof(float)*2*st->lanes*st->plan->nfft;
+        float * tmpbuf = (float*)KISS_FFT_TMP_ALLOC(nbytes);
+        kfb_run(st,fin,tmpbuf);
+        memcpy(fout,tmpbuf,nbytes);
+        KISS_FFT_TMP_FREE(tmpbuf);
+    } else {
+        kfb_run(st,fin,fout);
+    }
+}
+
+int kiss_fft_batch_get_isa(kiss_fft_batch_cfg st)
+{
+    return st->isa;
+}
+
+
+kiss_fftr_batch_cfg kiss_fftr_batch_alloc(int nfft,int lanes,void * mem,size_t * lenmem)
+{
+    int i;
+    kiss_fftr_batch_cfg st = NULL;
+    size_t plansize = 0, memneeded;
+
+    if (nfft & 1) {
+        fprintf(stderr,"Real FFT optimization must be even.\n");
+        return NULL;
+    }
+    if (nfft < 2 || lanes < 1)
+        return NULL;
+    nfft >>= 1;
+
+    kiss_fft_alloc(nfft,0,NULL,&plansize);
+    memneeded = sizeof(struct kiss_fftr_batch_state) + plansize
+        + sizeof(float) * 2 * lanes * nfft
+        + sizeof(kiss_fft_cpx) * (nfft / 2);
+
+    if (lenmem == NULL) {
+        st = (kiss_fftr_batch_cfg) KISS_FFT_MALLOC(memneeded);
+    } else {
+        if (mem != NULL && *lenmem >= memneeded)
+            st = (kiss_fftr_batch_cfg) mem;
+        *lenmem = memneeded;
+    }
+    if (!st)
+        return NULL;
+
+    kfb_init(&st->sub,nfft,0,lanes,st + 1,plansize);
+    st->tmpbuf = (float *) (((char *) (st + 1)) + plansize);
+    st->super_twiddles = (kiss_fft_cpx *) (st->tmpbuf + 2 * lanes * nfft);
+
+    /* same twiddles as kiss_fftr */
+    for (i = 0; i < nfft/2; ++i) {
+        double phase =
+            -3.14159265358979323846264338327 * ((double) (i+1) / nfft + .5);
+        kf_cexp (st->super_twiddles+i,phase);
+    }
+    return st;
+}
+
+void kiss_fftr_batch(kiss_fftr_batch_cfg st,const float *timedata,float *freqdata)
+{
+    /* pairs of real samples are the real and imag parts of a half-size
+       complex signal, which is exactly the complex batch layout */
+    kfb_run(&st->sub,timedata,st->tmpbuf);
+    kfb_run_split(st,freqdata);
+}
+
+int kiss_fftr_batch_get_isa(kiss_fftr_batch_cfg st)
+{
+    return st->sub.isa;
+}
@@ -0,0 +1,98 @@
+#ifndef KISS_FFT_BATCH_H
+#define KISS_FFT_BATCH_H
+
+#include "kiss_fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ Batched transforms: several independent FFTs of the same size in one call.
+
+ This is the same idea as the USE_SIMD build (see README.simd), but it works
+ in a normal float build:  the plan is an ordinary float kiss_fft_cfg and the
+ butterflies are written with explicit SSE / AVX intrinsics that are picked
+ at runtime, so it can live next to the scalar transforms in one program and
+ it compiles with MSVC (USE_SIMD relies on gcc vector operators on __m128).
+
+ The data layout matches README.simd, generalized to 'lanes' signals:
+
+ complex data, element k of signal j:
+    real at buf[2*lanes*k + j]
+    imag at buf[2*lanes*k + lanes + j]
+
+ real data, sample t of signal j:
+    buf[lanes*t + j]
+
+ Lanes are processed 8 at a time with AVX and 4 at a time with SSE; any lanes
+ left over (or every lane, on other cpus) go through a scalar loop.  Each lane
+ gives the same result as kiss_fft / kiss_fftr on that signal alone, within
+ rounding.
+
+ Requires kiss_fft_scalar to be float.
+ */
+
+#define KISS_FFT_BATCH_ISA_SCALAR 0
+#define KISS_FFT_BATCH_ISA_SSE 1
+#define KISS_FFT_BATCH_ISA_AVX 2
+
+typedef struct kiss_fft_batch_state* kiss_fft_batch_cfg;
+typedef struct kiss_fftr_batch_state* kiss_fftr_batch_cfg;
+
+/*
+ * kiss_fft_batch_set_isa
+ *
+ * Limit the instruction set used by configs allocated after this call.
+ * Pass -1 to go back to the best one the cpu supports.
+ * Returns the instruction set that will actually be used.
+ * */
+int kiss_fft_batch_set_isa(int isa);
+
+/*
+ * kiss_fft_batch_alloc
+ *
+ * Same as kiss_fft_alloc (including the mem/lenmem placement rules) for a
+ * batch of 'lanes' complex transforms of size nfft.
+ * */
+kiss_fft_batch_cfg kiss_fft_batch_alloc(int nfft,int inverse_fft,int lanes,void * mem,size_t * lenmem);
+
+/*
+ * kiss_fft_batch(cfg,fin,fout)
+ *
+ * fin and fout each hold nfft*2*lanes floats in the layout above.
+ * */
+void kiss_fft_batch(kiss_fft_batch_cfg cfg,const float *fin,float *fout);
+
+/*
+ * kiss_fftr_batch_alloc
+ *
+ * Batch of 'lanes' forward real transforms; nfft must be even.
+ * Placement rules are the same as kiss_fft_alloc.
+ * */
+kiss_fftr_batch_cfg kiss_fftr_batch_alloc(int nfft,int lanes,void * mem,size_t * lenmem);
+
+/*
+ * kiss_fftr_batch(cfg,timedata,freqdata)
+ *
+ * timedata holds nfft*lanes floats (real layout),
+ * freqdata receives (nfft/2+1)*2*lanes floats (complex layout).
+ * */
+void kiss_fftr_batch(kiss_fftr_batch_cfg cfg,const float *timedata,float *freqdata);
+
+/* instruction set a config ended up with */
+int kiss_fft_batch_get_isa(kiss_fft_batch_cfg cfg);
+int kiss_fftr_batch_get_isa(kiss_fftr_batch_cfg cfg);
+
+/* access an element of complex batch data */
+#define kiss_fft_batch_re(buf,lanes,k,j) ((buf)[2*(lanes)*(k) + (j)])
+#define kiss_fft_batch_im(buf,lanes,k,j) ((buf)[2*(lanes)*(k) + (lanes) + (j)])
+
+/* configs are one contiguous block, same as kiss_fft_alloc */
+#define kiss_fft_batch_free free
+#define kiss_fftr_batch_free free
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2003-2010, Mark Borgerding
+
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+    * Neither the author nor the names of any contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "kiss_partconv.h"
+#include "kiss_fftr.h"
+#include "_kiss_fft_guts.h"
+
+#if defined(FIXED_POINT) || defined(USE_SIMD)
+#error "kiss_partconv needs a float or double build of kiss_fft"
+#endif
+
+/* keep every sub-buffer of the single allocation 16-byte aligned */
+#define KPC_ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+struct kiss_partconv_state{
+    size_t blocksize;
+    size_t nbins;               /* blocksize + 1 */
+    size_t npart;
+    size_t newest;              /* delay line slot of the newest input spectrum */
+    kiss_fftr_cfg fftcfg;
+    kiss_fftr_cfg ifftcfg;
+    kiss_fft_scalar * inbuf;    /* previous block then current block, 2*blocksize */
+    kiss_fft_scalar * timebuf;  /* inverse transform output, 2*blocksize */
+    kiss_fft_cpx * accum;       /* output spectrum */
+    kiss_fft_cpx * fdl;         /* input spectra of the last npart blocks */
+    kiss_fft_cpx * parts;       /* partition spectra, scaled by 1/nfft */
+};
+
+
+kiss_partconv_cfg kiss_partconv_alloc(const kiss_fft_scalar * imp_resp,size_t n_imp_resp,int blocksize,void * mem,size_t * lenmem)
+{
+    kiss_partconv_cfg st = NULL;
+    size_t len_fftcfg = 0,len_ifftcfg = 0,len_time,len_spec,memneeded;
+    size_t npart,nbins,bs;
+    char * ptr;
+
+    if (blocksize <= 0 || n_imp_resp == 0 || imp_resp == NULL)
+        return NULL;
+    bs = (size_t)blocksize;
+    nbins = bs + 1;
+    npart = (n_imp_resp + bs - 1) / bs;
+
+    kiss_fftr_alloc((int)(2 * bs), 0, NULL, &len_fftcfg);
+    kiss_fftr_alloc((int)(2 * bs), 1, NULL, &len_ifftcfg);
+    len_time = KPC_ALIGN(sizeof(kiss_fft_scalar) * 2 * bs);
+    len_spec = KPC_ALIGN(sizeof(kiss_fft_cpx) * nbins);
+    memneeded = KPC_ALIGN(sizeof(struct kiss_partconv_state))
+        + KPC_ALIGN(len_fftcfg) + KPC_ALIGN(len_ifftcfg)
+        + 2 * len_time + len_spec + 2 * npart * len_spec;
+
+    if (lenmem == NULL) {
+        st = (kiss_partconv_cfg) KISS_FFT_MALLOC(memneeded);
+    } else {
+        if (mem != NULL && *lenmem >= memneeded)
+            st = (kiss_partconv_cfg) mem;
+        *lenmem = memneeded;
+    }
+    if (!st)
+        return NULL;
+
+    st->blocksize = bs;
+    st->nbins = nbins;
+    st->npart = npart;
+
+    ptr = (char*)st + KPC_ALIGN(sizeof(struct kiss_partconv_state));
+    st->fftcfg = kiss_fftr_alloc((int)(2 * bs), 0, ptr, &len_fftcfg);
+    ptr += KPC_ALIGN(len_fftcfg);
+    st->ifftcfg = kiss_fftr_alloc((int)(2 * bs), 1, ptr, &len_ifftcfg);
+    ptr += KPC_ALIGN(len_ifftcfg);
+    st->inbuf = (kiss_fft_scalar*)ptr;
+    ptr += len_time;
+    st->timebuf = (kiss_fft_scalar*)ptr;
+    ptr += len_time;
+    st->accum = (kiss_fft_cpx*)ptr;
+    ptr += len_spec;
+    st->fdl = (kiss_fft_cpx*)ptr;
+    ptr += npart * len_spec;
+    st->parts = (kiss_fft_cpx*)ptr;
+
+    kiss_partconv_reset(st);
+    kiss_partconv_set_response(st, imp_resp, n_imp_resp);
+    return st;
+}
+
+/* distance between consecutive spectra in fdl and parts */
+static
+size_t kpc_stride(const struct kiss_partconv_state * st)
+{
+    return KPC_ALIGN(sizeof(kiss_fft_cpx) * st->nbins) / sizeof(kiss_fft_cpx);
+}
+
+int kiss_partconv_set_response(kiss_partconv_cfg st,const kiss_fft_scalar * imp_resp,size_t n_imp_resp)
+{
+    const size_t bs = st->blocksize, stride = kpc_stride(st);
+    const kiss_fft_scalar scale = (kiss_fft_scalar)(1.0 / (double)(2 * bs));
+    size_t p,k,first,count;
+    kiss_fft_cpx * part;
+
+    if (n_imp_resp > st->npart * bs)
+        return -1;
+
+    /* each partition is zero padded to the fft size; the padding is what
+       makes the last half of each inverse transform a linear convolution */
+    for (p = 0; p < st->npart; ++p) {
+        part = st->parts + p * stride;
+        first = p * bs;
+        count = first < n_imp_resp ? n_imp_resp - first : 0;
+        if (count > bs)
+            count = bs;
+        if (count == 0) {
+            memset(part, 0, sizeof(kiss_fft_cpx) * st->nbins);
+            continue;
+        }
+        memset(st->timebuf, 0, sizeof(kiss_fft_scalar) * 2 * bs);
+        memcpy(st->timebuf, imp_resp + first, sizeof(kiss_fft_scalar) * count);
+        kiss_fftr(st->fftcfg, st->timebuf, part);
+
+        /* fold the inverse transform's 1/nfft in here, once */
+        for (k = 0; k < st->nbins; ++k) {
+            part[k].r *= scale;
+            part[k].i *= scale;
+        }
+    }
+    return 0;
+}
+
+void kiss_partconv_reset(kiss_partconv_cfg st)
+{
+    memset(st->inbuf, 0, sizeof(kiss_fft_scalar) * 2 * st->blocksize);
+    memset(st->fdl, 0, sizeof(kiss_fft_cpx) * kpc_stride(st) * st->npart);
+    st->newest = 0;
+}
+
+void kiss_partconv(kiss_partconv_cfg st,const kiss_fft_scalar * in,kiss_fft_scalar * out)
+{
+    const size_t bs = st->blocksize, nbins = st->nbins, npart = st->npart, stride = kpc_stride(st);
+    kiss_fft_cpx * const acc = st->accum;
+    const kiss_fft_cpx * x;
+    const kiss_fft_cpx * h;
+    size_t p,k,slot;
+
+    /* slide the input window along by one block */
+    memmove(st->inbuf, st->inbuf + bs, sizeof(kiss_fft_scalar) * bs);
+    memcpy(st->inbuf + bs, in, sizeof(kiss_fft_scalar) * bs);
+
+    /* the delay line runs backwards, so the spectrum from p blocks ago is
+       p slots after the newest one */
+    st->newest = st->newest ? st->newest - 1 : npart - 1;
+    kiss_fftr(st->fftcfg, st->inbuf, st->fdl + st->newest * stride);
+
+    /* output spectrum: sum over partitions of delayed input times partition */
+    memset(acc, 0, sizeof(kiss_fft_cpx) * nbins);
+    for (p = 0, slot = st->newest; p < npart; ++p) {
+        x = st->fdl + slot * stride;
+        h = st->parts + p * stride;
+        for (k = 0; k < nbins; ++k) {
+            acc[k].r += x[k].r * h[k].r - x[k].i * h[k].i;
+            acc[k].i += x[k].r * h[k].i + x[k].i * h[k].r;
+        }
+        if (++slot == npart)
+            slot = 0;
+    }
+
+    /* first half of the inverse transform is wrapped around; keep the rest */
+    kiss_fftri(st->ifftcfg, acc, st->timebuf);
+    memcpy(out, st->timebuf + bs, sizeof(kiss_fft_scalar) * bs);
+}
+
+int kiss_partconv_blocksize(kiss_partconv_cfg st)
+{
+    return (int)st->blocksize;
+}
+
+int kiss_partconv_partitions(kiss_partconv_cfg st)
+{
+    return (int)st->npart;
+}
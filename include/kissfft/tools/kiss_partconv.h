@@ -0,0 +1,77 @@
+#ifndef KISS_PARTCONV_H
+#define KISS_PARTCONV_H
+
+#include "kiss_fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ Uniformly partitioned convolution (overlap-save with a frequency-domain
+ delay line) of a real signal with a real impulse response of any length.
+
+ kiss_fastfir transforms the whole impulse response at once, so its latency
+ is the fft size, which grows with the response.  Here the response is cut
+ into partitions of 'blocksize' samples; each partition is transformed once
+ at alloc time (fft size 2*blocksize) and every call to kiss_partconv
+ filters exactly one block.  Latency is one block no matter how long the
+ response is, and the cost per block grows with the number of partitions
+ (one complex multiply-add per bin per partition) instead of with the fft
+ size.
+
+ Blocks of 64 to 256 samples suit real time use; longer blocks cost less
+ per sample but wait longer for input.
+
+ Floating point builds only (float or double kiss_fft_scalar).
+ */
+
+typedef struct kiss_partconv_state* kiss_partconv_cfg;
+
+/*
+ * kiss_partconv_alloc
+ *
+ * Set up a convolver for an impulse response of n_imp_resp samples, filtering
+ * 'blocksize' samples per call.  Memory rules are the same as
+ * kiss_fft_alloc: pass mem = lenmem = NULL to malloc, otherwise the config
+ * is placed in mem if *lenmem is big enough and *lenmem is set to the
+ * number of bytes needed.
+ * */
+kiss_partconv_cfg kiss_partconv_alloc(const kiss_fft_scalar * imp_resp,size_t n_imp_resp,int blocksize,void * mem,size_t * lenmem);
+
+/*
+ * kiss_partconv
+ *
+ * Filter one block: in and out each hold 'blocksize' samples and may be the
+ * same buffer.  Output is the linear convolution of everything passed in
+ * so far, with no delay beyond the block itself.  Does not allocate.
+ * */
+void kiss_partconv(kiss_partconv_cfg cfg,const kiss_fft_scalar * in,kiss_fft_scalar * out);
+
+/*
+ * kiss_partconv_set_response
+ *
+ * Swap in a new impulse response (e.g. a different EQ curve) that fits in
+ * the partitions allocated for the first one.  Input history is kept, so
+ * the change is heard from the next block on.  Does not allocate.
+ * Returns 0 on success, -1 if the response is too long.
+ * */
+int kiss_partconv_set_response(kiss_partconv_cfg cfg,const kiss_fft_scalar * imp_resp,size_t n_imp_resp);
+
+/*
+ * kiss_partconv_reset
+ *
+ * Forget input history, as if nothing had been filtered yet.
+ * */
+void kiss_partconv_reset(kiss_partconv_cfg cfg);
+
+/* blocksize and partition count of a config */
+int kiss_partconv_blocksize(kiss_partconv_cfg cfg);
+int kiss_partconv_partitions(kiss_partconv_cfg cfg);
+
+#define kiss_partconv_free free
+
+#ifdef __cplusplus
+}
+#endif
+#endif
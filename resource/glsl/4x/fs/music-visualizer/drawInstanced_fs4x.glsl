@@ -0,0 +1,50 @@
+/*
+* Team Members:
+*				Vedant Chaudhari 1530277
+*				Aaron Hamilton
+*
+* Course Code: EGP-300
+* Section: 01
+* Project Name: Final Project - Music Visualizer
+* Certificate of Authenticity :
+*		We certify that this work is entirely our own.  The assessor of this 
+		project may reproduce this project and provide copies to other academic staff, 
+		and/or communicate a copy of this project to a plagiarism-checking service, which 
+		may retain a copy of the project on its database.
+*/
+
+// Instanced field fragment shader: diffuse lit instance color, brightened 
+//	by the beat pulse
+
+#version 410
+
+in vbInstanceData
+{
+	vec4 vPosition_world;
+	vec3 vNormal_world;
+	vec4 vColor;
+	float vPulse;
+} vInstanceData;
+
+// per-frame scene data; layout matches a3_DemoFrameBlock
+layout (std140) uniform uFrame
+{
+	mat4 viewProjectionMat;
+	vec4 lightPos_world;
+	vec4 eyePos_world;
+	float time;
+	float resolutionX;
+	float resolutionY;
+	float reserved;
+} frame;
+
+out vec4 rtFragColor;
+
+void main()
+{
+	vec3 N = normalize(vInstanceData.vNormal_world);
+	vec3 L = normalize(frame.lightPos_world.xyz - vInstanceData.vPosition_world.xyz);
+	float diffuse = max(dot(N, L), 0.0);
+
+	rtFragColor = vec4(vInstanceData.vColor.rgb * (0.25 + 0.75 * diffuse + vInstanceData.vPulse), vInstanceData.vColor.a);
+}
@@ -0,0 +1,58 @@
+/*
+* Team Members:
+*				Vedant Chaudhari 1530277
+*				Aaron Hamilton
+*
+* Course Code: EGP-300
+* Section: 01
+* Project Name: Final Project - Music Visualizer
+* Certificate of Authenticity :
+*		We certify that this work is entirely our own.  The assessor of this 
+		project may reproduce this project and provide copies to other academic staff, 
+		and/or communicate a copy of this project to a plagiarism-checking service, which 
+		may retain a copy of the project on its database.
+*/
+
+// Instanced field vertex shader: every copy has its own transform, color 
+// Scene object fragment shader: Phong shading from the diffuse and 
+//	specular maps, brightened on the beat
+
+#version 410
+
+in vbSceneData
+{
+	vec3 vNormal_obj;
+	vec3 vLight_obj;
+	vec3 vView_obj;
+	vec2 vTexcoord;
+} vSceneData;
+
+uniform sampler2D uTex_dm;
+uniform sampler2D uTex_sm;
+
+// leading members of the per-frame audio data; layout matches 
+//	a3_DemoAudioBlock
+layout (std140) uniform uAudio
+{
+	vec4 bands[16];				// 64 band peaks, 4 per element, loudness-normalized
+	vec4 wave[64];
+	float beatPhase;			// 0 on the beat, rising to 1 before the next
+} audio;
+
+out vec4 rtFragColor;
+
+void main()
+{
+	vec3 N = normalize(vSceneData.vNormal_obj);
+	vec3 L = normalize(vSceneData.vLight_obj);
+	vec3 V = normalize(vSceneData.vView_obj);
+	vec3 R = reflect(-L, N);
+	float diffuse = max(dot(N, L), 0.0);
+	float specular = pow(max(dot(V, R), 0.0), 16.0);
+	float beat = 1.0 - audio.beatPhase;
+
+	vec4 dm = texture(uTex_dm, vSceneData.vTexcoord);
+	vec4 sm = texture(uTex_sm, vSceneData.vTexcoord);
+
+	rtFragColor = vec4(dm.rgb * (0.1 + diffuse + 0.25 * beat * beat) + sm.rgb * specular, dm.a);
+}
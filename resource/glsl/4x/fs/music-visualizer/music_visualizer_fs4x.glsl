@@ -19,41 +19,107 @@
 
 in vec4 vPosition;
 
-uniform mat4 uMVP;
+uniform sampler2D uTex_spectrogram;	// band history: u = band, v wraps over time
 
-uniform float uTime;
-
-uniform float spectrum_data[256];
-uniform float wave_data[256];
+// per-frame scene data; layout matches a3_DemoFrameBlock
+layout (std140) uniform uFrame
+{
+	mat4 viewProjectionMat;
+	vec4 lightPos_world;
+	vec4 eyePos_world;
+	float time;					// seconds
+	float resolutionX;			// window size in pixels
+	float resolutionY;
+	float reserved;
+} frame;
 
-uniform int uResX;
-uniform int uResY;
+// per-frame audio data; layout matches a3_DemoAudioBlock
+layout (std140) uniform uAudio
+{
+	vec4 bands[16];				// 64 band peaks, 4 per element, loudness-normalized
+	vec4 wave[64];				// 256 waveform samples, 4 per element, loudness-normalized
+	float beatPhase;			// 0 on the beat, rising to 1 before the next (predicted for now)
+	float onsetStrength;		// > 1 on onsets
+	float tempo;				// beats per minute
+	int onsetCount;				// onsets since the previous frame
+	float spectrogramOffset;	// v of the newest spectrogram row
+	float rms;					// loudness of the waveform
+	float zeroCrossingRate;		// 0 to 1, higher for noisy or bright sound
+	float spectralCentroid;		// spectral center of mass in Hz
+	float rolloff;				// Hz below which most of the power lies
+	float flatness;				// 0 for tones, 1 for noise
+	float flux;					// how fast the spectrum is rising
+	float nextBeat;				// seconds until the next predicted beat
+	float loudnessMomentary;	// LUFS over 400 ms
+	float loudnessShortTerm;	// LUFS over 3 s
+	float loudnessIntegrated;	// LUFS over the track so far
+	float gain;					// normalization already applied to bands and wave
+	vec4 harmonic[16];			// 64 band peaks of sustained, tonal sound
+	vec4 percussive[16];		// 64 band peaks of drums and other hits
+	vec4 chroma[3];				// 12 pitch classes from C, strongest is 1
+	int key;					// 0-11 major on C..B, 12-23 minor, -1 unknown
+	float keyStrength;			// how well the key fits, up to 1
+} audio;
 
 out vec4 rtMusicVisualizer;
 
 #define THICCNESS = 0.05;
 
+float waveSample(in int index)
+{
+	return audio.wave[index >> 2][index & 3];
+}
+
 void interpolate(in float index, out float value)
 {
-	float norm = 255.0 / uResX * index;
+	float norm = 255.0 / frame.resolutionX * index;
 	int floorVal = int(floor(norm));
 	int ceilVal = int(ceil(norm));
-	value = mix(wave_data[floorVal], wave_data[ceilVal], fract(norm));
+	value = mix(waveSample(floorVal), waveSample(ceilVal), fract(norm));
+}
+
+// hue of the harmony: pitch classes around the color wheel by fifths,
+//	so related chords get related colors, averaged by strength
+vec3 chromaColor()
+{
+	vec2 sum = vec2(0.0);
+	for (int i = 0; i < 12; ++i)
+	{
+		float angle = float((i * 7) % 12) * 0.5235988;
+		sum += audio.chroma[i >> 2][i & 3] * vec2(cos(angle), sin(angle));
+	}
+	float hue = atan(sum.y, sum.x) * 0.1591549 + 0.5;
+	vec3 color = clamp(abs(fract(hue + vec3(0.0, 2.0 / 3.0, 1.0 / 3.0)) * 6.0 - 3.0) - 1.0, 0.0, 1.0);
+	// minor keys a little darker
+	return color * (audio.key >= 12 ? 0.75 : 1.0);
 }
 
 void main()
 {
-	float time = uTime;
-	float x = vPosition.x / uResX;
-	float y = vPosition.y / uResY;
+	float time = frame.time;
+	float x = vPosition.x / frame.resolutionX;
+	float y = vPosition.y / frame.resolutionY;
 	float wave = 0;
 
-	interpolate(x * uResX, wave);
+	interpolate(x * frame.resolutionX, wave);
 
 	wave = 0.5 - wave / 3;
 
-	float r = abs(0.05 /((wave - y)));
+	// line flares on each beat and fades before the next
+	// and kicks in the low percussive bands thicken it
+	float kick = dot(audio.percussive[0] + audio.percussive[1], vec4(0.125));
+	float pulse = (1.0 + 0.5 * exp(-6.0 * audio.beatPhase) + kick) * (0.75 + audio.rms);
+
+	float r = abs(0.05 * pulse /((wave - y)));
 	vec4 result = vec4(r-abs(r*0.2*sin(time/5)), r-abs(r*0.2*sin(time/7)), r-abs(r*0.2*sin(time/9)), 0);
 
+	// waterfall behind the line: newest bands at the top, scrolling down
+	float history = texture(uTex_spectrogram, vec2(x, audio.spectrogramOffset - (1.0 - y))).r;
+	// clearly tonal sound colors the waterfall by its harmony, brighter
+	//	sound shifts it towards white
+	float brightness = clamp(audio.spectralCentroid / 8000.0, 0.0, 1.0);
+	vec3 tint = mix(vec3(0.1, 0.2, 0.4), chromaColor() * 0.4, clamp(audio.keyStrength, 0.0, 1.0));
+	result.rgb += mix(tint, vec3(0.4), brightness) * sqrt(history);
+
 	rtMusicVisualizer = result;
 }
\ No newline at end of file
@@ -19,12 +19,12 @@
 
 layout (location = 0) in vec4 aPosition;
 
-uniform mat4 uMVP;
-
 out vec4 vPosition;
 
 void main ()
 {
+	// visualizer works in screen space: with no object transform it 
+	//	declares no object block, and the queue stages none for it
 	gl_Position = aPosition;
 
 	vPosition = aPosition;
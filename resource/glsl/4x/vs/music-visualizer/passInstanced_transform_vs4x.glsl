@@ -0,0 +1,73 @@
+/*
+* Team Members:
+*				Vedant Chaudhari 1530277
+*				Aaron Hamilton
+*
+* Course Code: EGP-300
+* Section: 01
+* Project Name: Final Project - Music Visualizer
+* Certificate of Authenticity :
+*		We certify that this work is entirely our own.  The assessor of this 
+		project may reproduce this project and provide copies to other academic staff, 
+		and/or communicate a copy of this project to a plagiarism-checking service, which 
+		may retain a copy of the project on its database.
+*/
+
+// Instanced field vertex shader: every copy has its own transform, color 
+//	and audio band, read from per-instance attributes
+
+#version 410
+
+layout (location = 0) in vec4 aPosition;
+layout (location = 2) in vec3 aNormal;
+
+// per-instance attributes; layout matches a3_DemoInstance
+layout (location = 3) in vec4 aInstanceColor;
+layout (location = 4) in vec4 aInstanceAudio;		// beat phase offset, band, amount, reserved
+layout (location = 12) in mat4 aInstanceModelMat;
+
+// per-frame scene data; layout matches a3_DemoFrameBlock
+layout (std140) uniform uFrame
+{
+	mat4 viewProjectionMat;
+	vec4 lightPos_world;
+	vec4 eyePos_world;
+	float time;
+	float resolutionX;
+	float resolutionY;
+	float reserved;
+} frame;
+
+// leading members of the per-frame audio data; layout matches 
+//	a3_DemoAudioBlock
+layout (std140) uniform uAudio
+{
+	vec4 bands[16];				// 64 band peaks, 4 per element, loudness-normalized
+	vec4 wave[64];
+	float beatPhase;			// 0 on the beat, rising to 1 before the next
+} audio;
+
+out vbInstanceData
+{
+	vec4 vPosition_world;
+	vec3 vNormal_world;
+	vec4 vColor;
+	float vPulse;
+} vInstanceData;
+
+void main()
+{
+	// each copy swells with its band and flashes on the beat, shifted by 
+	//	its phase so the field ripples instead of blinking at once
+	int band = int(aInstanceAudio.y);
+	float level = audio.bands[band >> 2][band & 3];
+	float beat = 1.0 - fract(audio.beatPhase + aInstanceAudio.x);
+	vec4 position = vec4(aPosition.xyz * (1.0 + aInstanceAudio.z * level), 1.0);
+
+	vInstanceData.vPosition_world = aInstanceModelMat * position;
+	vInstanceData.vNormal_world = mat3(aInstanceModelMat) * aNormal;
+	vInstanceData.vColor = aInstanceColor;
+	vInstanceData.vPulse = aInstanceAudio.z * beat * beat;
+
+	gl_Position = frame.viewProjectionMat * vInstanceData.vPosition_world;
+}
@@ -0,0 +1,68 @@
+/*
+* Team Members:
+*				Vedant Chaudhari 1530277
+*				Aaron Hamilton
+*
+* Course Code: EGP-300
+* Section: 01
+* Project Name: Final Project - Music Visualizer
+* Certificate of Authenticity :
+*		We certify that this work is entirely our own.  The assessor of this 
+		project may reproduce this project and provide copies to other academic staff, 
+		and/or communicate a copy of this project to a plagiarism-checking service, which 
+		may retain a copy of the project on its database.
+*/
+
+// Instanced field vertex shader: every copy has its own transform, color 
+// Scene object vertex shader: each object reads its transform and its 
+//	light and eye positions from its own block in the run
+
+#version 410
+
+// objects drawn together by one indirect call are told apart by draw 
+//	index; drawn one at a time, each has its own range and index 0
+#extension GL_ARB_shader_draw_parameters : enable
+#ifdef GL_ARB_shader_draw_parameters
+#define DRAW_ID gl_DrawIDARB
+#else
+#define DRAW_ID 0
+#endif
+
+layout (location = 0) in vec4 aPosition;
+layout (location = 2) in vec3 aNormal;
+layout (location = 8) in vec2 aTexcoord;
+
+// per-draw object data; layout matches a3_DemoObjectBlock
+struct ObjectData
+{
+	mat4 modelViewProjectionMat;
+	vec4 lightPos_obj;
+	vec4 eyePos_obj;
+};
+
+// blocks of one run of draws; size matches demoRenderBatch_drawMax
+layout (std140) uniform uObject
+{
+	ObjectData objects[128];
+};
+
+// lighting is done in object space, so the normal needs no transform
+out vbSceneData
+{
+	vec3 vNormal_obj;
+	vec3 vLight_obj;
+	vec3 vView_obj;
+	vec2 vTexcoord;
+} vSceneData;
+
+void main()
+{
+	ObjectData object = objects[DRAW_ID];
+
+	vSceneData.vNormal_obj = aNormal;
+	vSceneData.vLight_obj = object.lightPos_obj.xyz - aPosition.xyz;
+	vSceneData.vView_obj = object.eyePos_obj.xyz - aPosition.xyz;
+	vSceneData.vTexcoord = aTexcoord;
+
+	gl_Position = object.modelViewProjectionMat * aPosition;
+}
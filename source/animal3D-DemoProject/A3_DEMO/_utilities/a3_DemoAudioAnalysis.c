@@ -0,0 +1,342 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioAnalysis.c
+	Audio analysis thread and lock-free frame hand-off implementation.
+*/
+
+#include "a3_DemoAudioAnalysis.h"
+
+
+//-----------------------------------------------------------------------------
+
+// platform atomics and sleep
+#ifdef _WIN32
+#include <Windows.h>
+#define a3demo_atomicLoad(ptr)			InterlockedCompareExchange(ptr, 0, 0)
+#define a3demo_atomicStore(ptr, val)	InterlockedExchange(ptr, val)
+#define a3demo_threadYield()			Sleep(1)
+#else	// !_WIN32
+#include <unistd.h>
+#define a3demo_atomicLoad(ptr)			__atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define a3demo_atomicStore(ptr, val)	__atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define a3demo_threadYield()			usleep(1000)
+#endif	// _WIN32
+
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// producer: claim, fill and publish the next frame
+// only the analysis thread calls this; returns the analyze result
+int a3demo_publishAudioFrame(a3_DemoAudioAnalysis *analysis)
+{
+	a3_DemoAudioRing *const ring = analysis->ring;
+	const long head = ring->head;
+	const long tail = a3demo_atomicLoad(&ring->tail);
+	a3_DemoAudioFrame *frame;
+	int result;
+
+	// full: consumer has not caught up, so this hop is analyzed but not 
+	//	published; analysis still has to run, since beat and loudness 
+	//	clocks count hops and event totals carry over to the next frame
+	if (head - tail >= demoAudioRing_frameCount)
+	{
+		result = analysis->analyzeFunc(analysis->source, analysis->dropped);
+		if (result != a3analyze_none)
+			++analysis->framesDropped;
+		return result;
+	}
+
+	frame = ring->frame + (head & (demoAudioRing_frameCount - 1));
+	result = analysis->analyzeFunc(analysis->source, frame);
+	if (result != a3analyze_none)
+	{
+		frame->timestamp = analysis->hopTimer->totalTime;
+		frame->sequence = analysis->framesPublished++;
+
+		// release: frame contents are visible before the new head
+		a3demo_atomicStore(&ring->head, head + 1);
+	}
+	return result;
+}
+
+
+// analysis thread entry point
+long a3demo_audioAnalysisThread(void *args)
+{
+	a3_DemoAudioAnalysis *const analysis = (a3_DemoAudioAnalysis *)args;
+
+	a3timerSet(analysis->hopTimer, analysis->hopRate);
+	a3timerStart(analysis->hopTimer);
+
+	while (a3demo_atomicLoad(&analysis->running))
+	{
+		// one frame per hop the source has ready
+		if (a3timerUpdate(analysis->hopTimer) > 0)
+			while (a3demo_publishAudioFrame(analysis) == a3analyze_more);
+		else
+			a3demo_threadYield();
+	}
+
+	a3timerStop(analysis->hopTimer);
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_startAudioAnalysis(a3_DemoAudioAnalysis *analysis, a3_DemoAudioAnalyzeFunc analyzeFunc, void *source, double hopRate)
+{
+	static char threadName[] = "a3demo audio analysis";
+	if (analysis && analyzeFunc && hopRate > 0.0)
+	{
+		if (!analysis->running)
+		{
+			// fresh ring and descriptor; thread handles from a previous
+			//	library instance are not valid anymore
+			memset(analysis, 0, sizeof(a3_DemoAudioAnalysis));
+			analysis->analyzeFunc = analyzeFunc;
+			analysis->source = source;
+			analysis->hopRate = hopRate;
+			analysis->running = 1;
+			if (a3threadLaunch(analysis->thread, a3demo_audioAnalysisThread, analysis, threadName) > 0)
+				return 1;
+			analysis->running = 0;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_stopAudioAnalysis(a3_DemoAudioAnalysis *analysis)
+{
+	if (analysis)
+	{
+		if (analysis->running)
+		{
+			a3demo_atomicStore(&analysis->running, 0);
+			a3threadWait(analysis->thread);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_consumeAudioFrameLatest(a3_DemoAudioAnalysis *analysis, a3_DemoAudioFrame *frame_out)
+{
+	if (analysis && frame_out)
+	{
+		a3_DemoAudioRing *const ring = analysis->ring;
+		const long tail = ring->tail;
+
+		// acquire: frame contents are visible once head is seen
+		const long head = a3demo_atomicLoad(&ring->head);
+		const long pending = head - tail;
+		if (pending > 0)
+		{
+			// copy before releasing the slot back to the producer
+			*frame_out = ring->frame[(head - 1) & (demoAudioRing_frameCount - 1)];
+			a3demo_atomicStore(&ring->tail, head);
+		}
+		return (int)pending;
+	}
+	return -1;
+}
+
+
+// events since the previous aggregate; totals restart with the analysis
+unsigned int a3demo_audioEventsSince(const unsigned int total, const unsigned int previous)
+{
+	return total >= previous ? total - previous : total;
+}
+
+int a3demo_consumeAudioFrames(a3_DemoAudioAnalysis *analysis, a3_DemoAudioAggregate *aggregate, a3_DemoAudioFrame *frameLatest_out_opt)
+{
+	if (analysis && aggregate)
+	{
+		a3_DemoAudioRing *const ring = analysis->ring;
+		const long tail = ring->tail;
+
+		// acquire: frame contents are visible once head is seen
+		const long head = a3demo_atomicLoad(&ring->head);
+		const long pending = head - tail;
+		if (pending > 0)
+		{
+			const unsigned int valueCount = demoAudioFrame_channelCount * demoAudioFrame_bandCount;
+			const unsigned int featureCount = sizeof(a3_DemoAudioFeatures) / sizeof(float);
+			const float invCount = 1.0f / (float)pending;
+			const a3_DemoAudioFrame *frame;
+			const float *bands, *features;
+			float *const peak = *aggregate->bandPeak, *const mean = *aggregate->bandMean, *const rms = *aggregate->bandRMS;
+			float *const featureMean = (float *)&aggregate->featureMean, *const featurePeak = (float *)&aggregate->featurePeak;
+			float onsetStrengthPeak = 0.0f;
+			unsigned int i;
+			long j;
+
+			// frames between tail and head belong to the consumer until the
+			//	tail moves, so they can be read in place
+			memset(aggregate->bandPeak, 0, sizeof(aggregate->bandPeak));
+			memset(aggregate->bandMean, 0, sizeof(aggregate->bandMean));
+			memset(aggregate->bandRMS, 0, sizeof(aggregate->bandRMS));
+			memset(aggregate->harmonicPeak, 0, sizeof(aggregate->harmonicPeak));
+			memset(aggregate->percussivePeak, 0, sizeof(aggregate->percussivePeak));
+			memset(featureMean, 0, sizeof(a3_DemoAudioFeatures));
+			memset(featurePeak, 0, sizeof(a3_DemoAudioFeatures));
+			for (j = tail; j < head; ++j)
+			{
+				frame = ring->frame + (j & (demoAudioRing_frameCount - 1));
+				bands = *frame->bands;
+				for (i = 0; i < valueCount; ++i)
+				{
+					if (bands[i] > peak[i])
+						peak[i] = bands[i];
+					mean[i] += bands[i];
+					rms[i] += bands[i] * bands[i];
+				}
+				for (i = 0; i < demoAudioFrame_bandCount; ++i)
+				{
+					if (frame->harmonicBands[i] > aggregate->harmonicPeak[i])
+						aggregate->harmonicPeak[i] = frame->harmonicBands[i];
+					if (frame->percussiveBands[i] > aggregate->percussivePeak[i])
+						aggregate->percussivePeak[i] = frame->percussiveBands[i];
+				}
+				// features are all floats, so treat them as an array
+				features = (const float *)&frame->features;
+				for (i = 0; i < featureCount; ++i)
+				{
+					if (features[i] > featurePeak[i])
+						featurePeak[i] = features[i];
+					featureMean[i] += features[i];
+				}
+				if (frame->onsetStrength > onsetStrengthPeak)
+					onsetStrengthPeak = frame->onsetStrength;
+			}
+			for (i = 0; i < valueCount; ++i)
+			{
+				mean[i] *= invCount;
+				rms[i] = sqrtf(rms[i] * invCount);
+			}
+			for (i = 0; i < featureCount; ++i)
+				featureMean[i] *= invCount;
+
+			// event counts come from running totals, so hops dropped while
+			//	the ring was full are still counted
+			frame = ring->frame + ((head - 1) & (demoAudioRing_frameCount - 1));
+			aggregate->onsetStrengthPeak = onsetStrengthPeak;
+			aggregate->frameCount = (unsigned int)pending;
+			aggregate->onsetCount = a3demo_audioEventsSince(frame->onsetTotal, aggregate->onsetTotal);
+			aggregate->beatCount = a3demo_audioEventsSince(frame->beatTotal, aggregate->beatTotal);
+			aggregate->onsetTotal = frame->onsetTotal;
+			aggregate->beatTotal = frame->beatTotal;
+			if (frameLatest_out_opt)
+				*frameLatest_out_opt = *frame;
+
+			// release slots back to the producer
+			a3demo_atomicStore(&ring->tail, head);
+		}
+		return (int)pending;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// job thread entry point
+long a3demo_audioJobThread(void *args)
+{
+	a3_DemoAudioJob *const job = (a3_DemoAudioJob *)args;
+
+	// release: result is visible before the finished flag
+	job->result = job->jobFunc(job->data, job);
+	a3demo_atomicStore(&job->finished, 1);
+	return 0;
+}
+
+
+int a3demo_startAudioJob(a3_DemoAudioJob *job, a3_DemoAudioJobFunc jobFunc, void *data)
+{
+	static char threadName[] = "a3demo audio job";
+	if (job && jobFunc)
+	{
+		if (!job->running)
+		{
+			// fresh descriptor, as for the analysis thread
+			memset(job, 0, sizeof(a3_DemoAudioJob));
+			job->jobFunc = jobFunc;
+			job->data = data;
+			job->running = 1;
+			if (a3threadLaunch(job->thread, a3demo_audioJobThread, job, threadName) > 0)
+				return 1;
+			job->running = 0;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_stopAudioJob(a3_DemoAudioJob *job)
+{
+	if (job)
+	{
+		if (job->running)
+		{
+			a3demo_atomicStore(&job->running, 0);
+			a3threadWait(job->thread);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_pollAudioJob(a3_DemoAudioJob *job)
+{
+	if (job)
+	{
+		// acquire: finished flag is seen before the result
+		if (job->running && a3demo_atomicLoad(&job->finished))
+		{
+			a3threadWait(job->thread);
+			job->running = 0;
+			return job->result > 0;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_isAudioJobRunning(const a3_DemoAudioJob *job)
+{
+	if (job)
+		return a3demo_atomicLoad((volatile long *)&job->running) != 0;
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
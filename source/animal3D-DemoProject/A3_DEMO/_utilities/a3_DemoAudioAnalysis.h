@@ -0,0 +1,230 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioAnalysis.h
+	Audio analysis thread and lock-free frame hand-off to the render thread.
+*/
+
+#ifndef __ANIMAL3D_DEMOAUDIOANALYSIS_H
+#define __ANIMAL3D_DEMOAUDIOANALYSIS_H
+
+
+// threading and timing utilities
+#include "animal3D/a3utility/a3_Thread.h"
+#include "animal3D/a3utility/a3_Timer.h"
+
+// per-hop feature vector
+#include "a3_DemoAudioFeatures.h"
+
+// pitch-class sizes
+#include "a3_DemoChroma.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef enum a3_DemoAudioChannel		a3_DemoAudioChannel;
+	typedef struct a3_DemoAudioFrame		a3_DemoAudioFrame;
+	typedef struct a3_DemoAudioAggregate	a3_DemoAudioAggregate;
+	typedef struct a3_DemoAudioRing			a3_DemoAudioRing;
+	typedef struct a3_DemoAudioAnalysis		a3_DemoAudioAnalysis;
+	typedef enum a3_DemoAudioAnalyzeResult	a3_DemoAudioAnalyzeResult;
+	typedef struct a3_DemoAudioJob			a3_DemoAudioJob;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// sizes of analysis data
+	// ring frame count must be a power of two
+	enum a3_DemoAudioAnalysisMaxCounts
+	{
+		demoAudioFrame_bandCount = 64,
+		demoAudioFrame_waveSize = 256,
+		demoAudioRing_frameCount = 32,
+	};
+
+
+	// analyzed channels; stereo pair and its sum and difference
+	enum a3_DemoAudioChannel
+	{
+		a3audio_left,
+		a3audio_right,
+		a3audio_mid,
+		a3audio_side,
+
+		demoAudioFrame_channelCount
+	};
+
+
+	// analysis windows, longest first; all end on the newest sample
+	enum a3_DemoAudioResolution
+	{
+		a3audio_bass,										// 4096 samples: bands below 250 Hz, chroma
+		a3audio_main,										// 1024 samples: bands to 4 kHz, everything else
+		a3audio_treble,										// 512 samples: bands above 4 kHz
+
+		demoAudio_resolutionCount
+	};
+
+
+	// one analyzed hop of audio
+	struct a3_DemoAudioFrame
+	{
+		double timestamp;									// seconds since analysis started
+		unsigned int sequence;								// index of this frame since analysis started
+		float bands[demoAudioFrame_channelCount][demoAudioFrame_bandCount];	// log-frequency band magnitudes per channel, normalized
+		float wave[demoAudioFrame_waveSize];				// most recent waveform (mid), normalized
+		float harmonicBands[demoAudioFrame_bandCount];		// mid channel bands of the sustained, tonal part, normalized
+		float percussiveBands[demoAudioFrame_bandCount];	// mid channel bands of the broadband hits, normalized
+		float chroma[demoChroma_pitchCount];				// mid channel pitch-class magnitudes, C first, strongest is 1
+		int key;											// estimated key, see a3_DemoChromaAnalyzer; -1 if unknown
+		float keyStrength;									// how well the key fits, up to 1
+		a3_DemoAudioFeatures features;						// mid channel features
+		float loudnessMomentary;							// LUFS over the last 400 ms
+		float loudnessShortTerm;							// LUFS over the last 3 s
+		float loudnessIntegrated;							// gated LUFS since analysis started
+		float gain;											// normalization already applied to bands and wave
+		float onsetStrength;								// spectral flux relative to onset threshold
+		float beatPhase;									// 0 on the beat, rising to 1 before the next
+		float tempo;										// beats per minute
+		int onset;											// onset detected on this hop
+		int beat;											// beat fell on this hop
+		unsigned int onsetTotal;							// onsets since analysis started
+		unsigned int beatTotal;								// beats since analysis started
+	};
+
+	// summary of every frame published since the previous render tick, so
+	//	short events between ticks still show up
+	struct a3_DemoAudioAggregate
+	{
+		float bandPeak[demoAudioFrame_channelCount][demoAudioFrame_bandCount];	// loudest value per band
+		float bandMean[demoAudioFrame_channelCount][demoAudioFrame_bandCount];	// average per band
+		float bandRMS[demoAudioFrame_channelCount][demoAudioFrame_bandCount];	// root mean square per band
+		float harmonicPeak[demoAudioFrame_bandCount];		// loudest harmonic value per band
+		float percussivePeak[demoAudioFrame_bandCount];		// loudest percussive value per band
+		a3_DemoAudioFeatures featureMean;					// average of each feature
+		a3_DemoAudioFeatures featurePeak;					// largest value of each feature
+		float onsetStrengthPeak;							// strongest onset strength
+		unsigned int frameCount;							// frames summarized
+		unsigned int onsetCount;							// onsets since previous aggregate
+		unsigned int beatCount;								// beats since previous aggregate
+		unsigned int onsetTotal, beatTotal;					// totals at previous aggregate
+	};
+
+	// single-producer/single-consumer ring of frames
+	// producer (analysis thread) only writes 'head', consumer only writes 'tail'
+	struct a3_DemoAudioRing
+	{
+		a3_DemoAudioFrame frame[demoAudioRing_frameCount];
+		volatile long head;									// next frame to be written
+		volatile long tail;									// next frame to be read
+	};
+
+
+	// what an analysis callback produced
+	enum a3_DemoAudioAnalyzeResult
+	{
+		a3analyze_none,										// nothing new, frame is not valid
+		a3analyze_frame,									// frame is valid
+		a3analyze_more,										// frame is valid and another hop is ready
+	};
+
+	// analysis callback: fill frame with data from source
+	//	(called on the analysis thread; returns an analyze result; a source
+	//	that is behind by several hops is called again in the same tick for
+	//	each, so every hop reaches the consumer as its own frame)
+	typedef int(*a3_DemoAudioAnalyzeFunc)(void *source, a3_DemoAudioFrame *frame_out);
+
+	// analysis worker
+	struct a3_DemoAudioAnalysis
+	{
+		a3_DemoAudioRing ring[1];							// frame hand-off
+		a3_DemoAudioFrame dropped[1];						// analyzed while the ring was full, never published
+		a3_Thread thread[1];								// analysis thread
+		a3_Timer hopTimer[1];								// paces analysis (owned by thread)
+		a3_DemoAudioAnalyzeFunc analyzeFunc;				// analysis callback
+		void *source;										// callback data
+		double hopRate;										// analysis hops per second
+		volatile long running;								// thread keeps going while set
+		unsigned int framesPublished;						// frames written to ring
+		unsigned int framesDropped;							// frames analyzed but not published because ring was full
+	};
+
+
+	// background job callback: long work that must not stall the main
+	//	thread, e.g. building the analysis cache of a new track; polls
+	//	a3demo_isAudioJobRunning and returns early once it clears
+	//	(called on the job's thread; return 1 on success)
+	typedef int(*a3_DemoAudioJobFunc)(void *data, const a3_DemoAudioJob *job);
+
+	// one-off worker
+	struct a3_DemoAudioJob
+	{
+		a3_Thread thread[1];								// job thread
+		a3_DemoAudioJobFunc jobFunc;						// job callback
+		void *data;											// callback data
+		volatile long running;								// job keeps going while set
+		volatile long finished;								// set by the job thread when the callback returns
+		int result;											// callback's result, valid once finished
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// analysis thread control
+	int a3demo_startAudioAnalysis(a3_DemoAudioAnalysis *analysis, a3_DemoAudioAnalyzeFunc analyzeFunc, void *source, double hopRate);
+	int a3demo_stopAudioAnalysis(a3_DemoAudioAnalysis *analysis);
+
+	// consumer side: copy the newest published frame and discard older ones
+	//	returns the number of frames that were pending (0 if nothing new)
+	int a3demo_consumeAudioFrameLatest(a3_DemoAudioAnalysis *analysis, a3_DemoAudioFrame *frame_out);
+
+	// consumer side: summarize every published frame and copy the newest
+	//	aggregate keeps event totals between calls; zero it before the first
+	//	returns the number of frames summarized (0 if nothing new, in which
+	//	case aggregate and frame are left as they were)
+	int a3demo_consumeAudioFrames(a3_DemoAudioAnalysis *analysis, a3_DemoAudioAggregate *aggregate, a3_DemoAudioFrame *frameLatest_out_opt);
+
+	// job control; stop asks a running job to return early and waits for it
+	int a3demo_startAudioJob(a3_DemoAudioJob *job, a3_DemoAudioJobFunc jobFunc, void *data);
+	int a3demo_stopAudioJob(a3_DemoAudioJob *job);
+
+	// owner side: once the job has finished, wait for its thread
+	//	returns 1 if it finished with success since the previous call,
+	//	0 if it is still running, failed or was never started
+	int a3demo_pollAudioJob(a3_DemoAudioJob *job);
+
+	// job side: whether the job should keep going
+	int a3demo_isAudioJobRunning(const a3_DemoAudioJob *job);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOAUDIOANALYSIS_H
@@ -0,0 +1,115 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioBlock.h
+	Per-frame audio data as one std140 uniform block, uploaded with a
+		single buffer write and shared by every visualizer program.
+*/
+
+#ifndef __ANIMAL3D_DEMOAUDIOBLOCK_H
+#define __ANIMAL3D_DEMOAUDIOBLOCK_H
+
+
+// frame sizes
+#include "a3_DemoAudioAnalysis.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoAudioBlock		a3_DemoAudioBlock;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// CPU copy of the 'uAudio' block; members line up with std140 rules
+	//	as long as arrays are whole vec4s and scalars come in fours:
+	//
+	//	layout (std140) uniform uAudio
+	//	{
+	//		vec4 bands[16];				// offset 0: band peaks, 4 per element
+	//		vec4 wave[64];				// offset 256: waveform, 4 per element
+	//		float beatPhase;			// offset 1280
+	//		float onsetStrength;
+	//		float tempo;
+	//		int onsetCount;
+	//		float spectrogramOffset;	// offset 1296
+	//		float rms;
+	//		float zeroCrossingRate;
+	//		float centroid;
+	//		float rolloff;				// offset 1312
+	//		float flatness;
+	//		float flux;
+	//		float nextBeat;
+	//		float loudnessMomentary;	// offset 1328
+	//		float loudnessShortTerm;
+	//		float loudnessIntegrated;
+	//		float gain;
+	//		vec4 harmonic[16];			// offset 1344: harmonic band peaks
+	//		vec4 percussive[16];		// offset 1600: percussive band peaks
+	//		vec4 chroma[3];				// offset 1856: pitch classes, 4 per element
+	//		int key;					// offset 1904
+	//		float keyStrength;
+	//		float reserved[2];
+	//	} audio;
+	//
+	//	new members go at the end; keep the size a multiple of 16
+	struct a3_DemoAudioBlock
+	{
+		float bands[demoAudioFrame_bandCount];		// mid channel band peaks since last update, normalized
+		float wave[demoAudioFrame_waveSize];		// newest waveform (mid), normalized
+		float beatPhase;							// 0 on the beat, rising to 1 before the next; predicted for display time
+		float onsetStrength;						// strongest onset since last update, > 1 on onsets
+		float tempo;								// beats per minute
+		int onsetCount;								// onsets since last update
+		float spectrogramOffset;					// texture v of the newest spectrogram row
+		float rms;									// features: see a3_DemoAudioFeatures
+		float zeroCrossingRate;
+		float centroid;								// Hz
+		float rolloff;								// Hz
+		float flatness;
+		float flux;									// peak since last update
+		float nextBeat;								// seconds from display to the next predicted beat
+		float loudnessMomentary;					// LUFS; see a3_DemoLoudnessMeter
+		float loudnessShortTerm;
+		float loudnessIntegrated;
+		float gain;									// already applied to bands and wave
+		float harmonic[demoAudioFrame_bandCount];	// mid channel harmonic band peaks since last update, normalized
+		float percussive[demoAudioFrame_bandCount];	// mid channel percussive band peaks since last update, normalized
+		float chroma[demoChroma_pitchCount];		// newest pitch-class magnitudes, C first, strongest is 1
+		int key;									// 0-11 major on C..B, 12-23 minor, -1 unknown
+		float keyStrength;							// how well the key fits, up to 1
+		float reserved[2];							// pads the block to a whole vec4
+	};
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOAUDIOBLOCK_H
@@ -0,0 +1,210 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioCache.c
+	Analysis cache file implementation.
+*/
+
+#include "a3_DemoAudioCache.h"
+
+
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_hashAudioFile(const char *filePath, unsigned int *hashLo_out, unsigned int *hashHi_out)
+{
+	if (filePath && *filePath && hashLo_out && hashHi_out)
+	{
+		FILE *fp = fopen(filePath, "rb");
+		if (fp)
+		{
+			// 64-bit FNV-1a
+			unsigned long long hash = 0xcbf29ce484222325ull;
+			unsigned char buffer[65536], *ptr, *end;
+			size_t count;
+			while ((count = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+				for (ptr = buffer, end = buffer + count; ptr < end; ++ptr)
+					hash = (hash ^ *ptr) * 0x100000001b3ull;
+			fclose(fp);
+
+			*hashLo_out = (unsigned int)hash;
+			*hashHi_out = (unsigned int)(hash >> 32);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_getAudioCachePath(char *path_out, const unsigned int pathSize, const unsigned int hashLo, const unsigned int hashHi)
+{
+	if (path_out && pathSize)
+	{
+		const int length = snprintf(path_out, pathSize, "./data/audio_%08x%08x.dat", hashHi, hashLo);
+		return (length > 0 && (unsigned int)length < pathSize) ? length : -1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_saveAudioCacheHeaderBinary(const a3_DemoAudioCacheHeader *header, const a3_FileStream *fileStream)
+{
+	if (header && fileStream && fileStream->stream)
+		return (int)fwrite(header, 1, sizeof(a3_DemoAudioCacheHeader), (FILE *)fileStream->stream);
+	return -1;
+}
+
+int a3demo_saveAudioCacheHopBinary(const a3_DemoAudioCacheHop *hop, const a3_FileStream *fileStream)
+{
+	if (hop && fileStream && fileStream->stream)
+		return (int)fwrite(hop, 1, sizeof(a3_DemoAudioCacheHop), (FILE *)fileStream->stream);
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// header describes this build's layout and the expected audio file
+int a3demo_validateAudioCache(const a3_DemoAudioCacheHeader *header, const unsigned int size, const unsigned int hashLo, const unsigned int hashHi)
+{
+	return size >= sizeof(a3_DemoAudioCacheHeader)
+		&& header->magic == demoAudioCache_magic
+		&& header->version == demoAudioCache_version
+		&& header->hashLo == hashLo && header->hashHi == hashHi
+		&& header->channelCount == demoAudioFrame_channelCount
+		&& header->bandCount == demoAudioFrame_bandCount
+		&& header->hopBytes == sizeof(a3_DemoAudioCacheHop)
+		&& header->hopSize && header->hopCount
+		&& (size - sizeof(a3_DemoAudioCacheHeader)) / sizeof(a3_DemoAudioCacheHop) >= header->hopCount;
+}
+
+int a3demo_openAudioCache(a3_DemoAudioCache *cache_out, const char *filePath, const unsigned int hashLo, const unsigned int hashHi)
+{
+	if (cache_out && !cache_out->header && filePath && *filePath)
+	{
+		a3_DemoFileMapping *const file = cache_out->file;
+		if (a3demo_mapFile(file, filePath, 0) > 0)
+		{
+			if (a3demo_validateAudioCache((a3_DemoAudioCacheHeader *)file->view, file->size, hashLo, hashHi))
+			{
+				cache_out->header = (const a3_DemoAudioCacheHeader *)file->view;
+				cache_out->hop = (const a3_DemoAudioCacheHop *)(cache_out->header + 1);
+				return 1;
+			}
+			a3demo_unmapFile(file);
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_closeAudioCache(a3_DemoAudioCache *cache)
+{
+	if (cache)
+	{
+		if (cache->header)
+		{
+			a3demo_unmapFile(cache->file);
+			memset(cache, 0, sizeof(a3_DemoAudioCache));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+const a3_DemoAudioCacheHop *a3demo_getAudioCacheHop(const a3_DemoAudioCache *cache, const unsigned int samplePosition)
+{
+	if (cache && cache->header)
+	{
+		// hop i is the window that ends at sample i * hopSize
+		const unsigned int index = samplePosition / cache->header->hopSize;
+		return cache->hop + (index < cache->header->hopCount ? index : cache->header->hopCount - 1);
+	}
+	return 0;
+}
+
+int a3demo_copyAudioCacheHop(a3_DemoAudioFrame *frame_out, const a3_DemoAudioCacheHop *hop)
+{
+	if (frame_out && hop)
+	{
+		memcpy(frame_out->bands, hop->bands, sizeof(frame_out->bands));
+		memcpy(frame_out->harmonicBands, hop->harmonicBands, sizeof(frame_out->harmonicBands));
+		memcpy(frame_out->percussiveBands, hop->percussiveBands, sizeof(frame_out->percussiveBands));
+		memcpy(frame_out->chroma, hop->chroma, sizeof(frame_out->chroma));
+		frame_out->key = hop->key;
+		frame_out->keyStrength = hop->keyStrength;
+		frame_out->features = hop->features;
+		frame_out->loudnessMomentary = hop->loudnessMomentary;
+		frame_out->loudnessShortTerm = hop->loudnessShortTerm;
+		frame_out->loudnessIntegrated = hop->loudnessIntegrated;
+		frame_out->gain = hop->gain;
+		frame_out->onsetStrength = hop->onsetStrength;
+		frame_out->beatPhase = hop->beatPhase;
+		frame_out->tempo = hop->tempo;
+		frame_out->onset = hop->onset;
+		frame_out->beat = hop->beat;
+		frame_out->onsetTotal = hop->onsetTotal;
+		frame_out->beatTotal = hop->beatTotal;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_storeAudioCacheHop(a3_DemoAudioCacheHop *hop_out, const a3_DemoAudioFrame *frame)
+{
+	if (hop_out && frame)
+	{
+		memcpy(hop_out->bands, frame->bands, sizeof(hop_out->bands));
+		memcpy(hop_out->harmonicBands, frame->harmonicBands, sizeof(hop_out->harmonicBands));
+		memcpy(hop_out->percussiveBands, frame->percussiveBands, sizeof(hop_out->percussiveBands));
+		memcpy(hop_out->chroma, frame->chroma, sizeof(hop_out->chroma));
+		hop_out->key = frame->key;
+		hop_out->keyStrength = frame->keyStrength;
+		hop_out->features = frame->features;
+		hop_out->loudnessMomentary = frame->loudnessMomentary;
+		hop_out->loudnessShortTerm = frame->loudnessShortTerm;
+		hop_out->loudnessIntegrated = frame->loudnessIntegrated;
+		hop_out->gain = frame->gain;
+		hop_out->onsetStrength = frame->onsetStrength;
+		hop_out->beatPhase = frame->beatPhase;
+		hop_out->tempo = frame->tempo;
+		hop_out->onset = frame->onset;
+		hop_out->beat = frame->beat;
+		hop_out->onsetTotal = frame->onsetTotal;
+		hop_out->beatTotal = frame->beatTotal;
+		hop_out->reserved = 0;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
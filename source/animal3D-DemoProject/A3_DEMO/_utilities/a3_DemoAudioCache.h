@@ -0,0 +1,146 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioCache.h
+	Precomputed per-hop analysis of a whole track, stored in a versioned
+		binary file keyed by a hash of the audio file and read back through
+		a memory mapping.
+*/
+
+#ifndef __ANIMAL3D_DEMOAUDIOCACHE_H
+#define __ANIMAL3D_DEMOAUDIOCACHE_H
+
+
+// file streaming and frame layout
+#include "animal3D/a3utility/a3_Stream.h"
+#include "a3_DemoAudioAnalysis.h"
+#include "a3_DemoFileMapping.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoAudioCacheHeader	a3_DemoAudioCacheHeader;
+	typedef struct a3_DemoAudioCacheHop		a3_DemoAudioCacheHop;
+	typedef struct a3_DemoAudioCache		a3_DemoAudioCache;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// file identification; bump the version whenever the hop layout or the
+	//	analysis that fills it changes, so old files are rebuilt
+	enum a3_DemoAudioCacheVersion
+	{
+		demoAudioCache_magic = 0x43413341,		// "A3AC" little-endian
+		demoAudioCache_version = 8,
+	};
+
+
+	// file header, followed directly by 'hopCount' hops
+	struct a3_DemoAudioCacheHeader
+	{
+		unsigned int magic;
+		unsigned int version;
+		unsigned int hashLo, hashHi;			// 64-bit hash of the audio file's bytes
+		unsigned int sampleRate;				// samples per second of the decoded track
+		unsigned int hopSize;					// samples between hops
+		unsigned int transformSize;				// samples per main analysis window
+		unsigned int hopCount;
+		unsigned int channelCount;				// must match demoAudioFrame_channelCount
+		unsigned int bandCount;					// must match demoAudioFrame_bandCount
+		unsigned int hopBytes;					// must match sizeof(a3_DemoAudioCacheHop)
+		unsigned int reserved;
+	};
+
+	// one analyzed hop; same meaning as the matching frame members
+	//	(waveform is not stored; it is cheap to read live)
+	struct a3_DemoAudioCacheHop
+	{
+		float bands[demoAudioFrame_channelCount][demoAudioFrame_bandCount];
+		float harmonicBands[demoAudioFrame_bandCount];
+		float percussiveBands[demoAudioFrame_bandCount];
+		float chroma[demoChroma_pitchCount];
+		int key;
+		float keyStrength;
+		a3_DemoAudioFeatures features;
+		float loudnessMomentary;
+		float loudnessShortTerm;
+		float loudnessIntegrated;
+		float gain;
+		float onsetStrength;
+		float beatPhase;
+		float tempo;
+		int onset;
+		int beat;
+		unsigned int onsetTotal;
+		unsigned int beatTotal;
+		unsigned int reserved;
+	};
+
+
+	// opened cache; all members point into the mapped file
+	struct a3_DemoAudioCache
+	{
+		const a3_DemoAudioCacheHeader *header;
+		const a3_DemoAudioCacheHop *hop;		// [hopCount]
+		a3_DemoFileMapping file[1];
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// hash a file's contents (64-bit FNV-1a); used as the cache key
+	//	returns 1 if hashed, 0 if the file could not be read
+	int a3demo_hashAudioFile(const char *filePath, unsigned int *hashLo_out, unsigned int *hashHi_out);
+
+	// cache file path for a hash, e.g. "./data/audio_0123456789abcdef.dat"
+	int a3demo_getAudioCachePath(char *path_out, const unsigned int pathSize, const unsigned int hashLo, const unsigned int hashHi);
+
+	// write header/hop to an open file stream
+	//	(a3_FileStreamWriteFunc signature, for a3fileStreamWriteObject)
+	int a3demo_saveAudioCacheHeaderBinary(const a3_DemoAudioCacheHeader *header, const a3_FileStream *fileStream);
+	int a3demo_saveAudioCacheHopBinary(const a3_DemoAudioCacheHop *hop, const a3_FileStream *fileStream);
+
+	// map a cache file and check it against the expected hash
+	//	returns 1 if opened, 0 if missing, stale or truncated
+	int a3demo_openAudioCache(a3_DemoAudioCache *cache_out, const char *filePath, const unsigned int hashLo, const unsigned int hashHi);
+	int a3demo_closeAudioCache(a3_DemoAudioCache *cache);
+
+	// hop for a playback position in samples (clamped to the track)
+	const a3_DemoAudioCacheHop *a3demo_getAudioCacheHop(const a3_DemoAudioCache *cache, const unsigned int samplePosition);
+
+	// copy between cached hops and frames (waveform is not touched)
+	int a3demo_copyAudioCacheHop(a3_DemoAudioFrame *frame_out, const a3_DemoAudioCacheHop *hop);
+	int a3demo_storeAudioCacheHop(a3_DemoAudioCacheHop *hop_out, const a3_DemoAudioFrame *frame);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOAUDIOCACHE_H
@@ -0,0 +1,202 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioFeatures.c
+	Audio feature vector implementation.
+*/
+
+#include "a3_DemoAudioFeatures.h"
+
+#include <string.h>
+#include <math.h>
+
+// fast log needs integer ops on float bits, which came with SSE2
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define A3_DEMOAUDIOFEATURES_SSE2
+#include <emmintrin.h>
+#endif	// SSE2
+
+
+//-----------------------------------------------------------------------------
+
+// power floor, same as the spectrum engine's -120 dB
+#define a3demo_featurePowerFloor	1.0e-12f
+
+
+#ifdef A3_DEMOAUDIOFEATURES_SSE2
+// log2 of four positive floats: exponent from the bits, polynomial for the
+//	mantissa in [1, 2); within 2e-4 of the real thing, plenty for a mean
+__m128 a3demo_featureLog2(const __m128 x)
+{
+	const __m128i bits = _mm_castps_si128(x);
+	const __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	const __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+	__m128 p = _mm_set1_ps(-0.0791581277f);
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(0.628873414f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-2.08121371f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(4.02854750f));
+	p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(-2.49684590f));
+	return _mm_add_ps(p, e);
+}
+
+// add the four lanes
+float a3demo_featureSum(__m128 v)
+{
+	v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+	return _mm_cvtss_f32(v);
+}
+#endif	// A3_DEMOAUDIOFEATURES_SSE2
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initAudioFeatureExtractor(a3_DemoAudioFeatureExtractor *extractor_out, const unsigned int bins, const float sampleRate)
+{
+	if (extractor_out && bins >= 2 && bins <= demoAudioFeatures_binMax && sampleRate > 0.0f)
+	{
+		memset(extractor_out, 0, sizeof(a3_DemoAudioFeatureExtractor));
+		extractor_out->bins = bins;
+		extractor_out->hzPerBin = sampleRate / (float)((bins - 1) * 2);
+		extractor_out->rolloffFraction = 0.85f;
+		return 1;
+	}
+	return -1;
+}
+
+
+int a3demo_extractAudioFeatures(a3_DemoAudioFeatureExtractor *extractor, const float *spectrum, const float *wave, const unsigned int waveCount, a3_DemoAudioFeatures *features_out)
+{
+	if (extractor && extractor->bins && spectrum && wave && waveCount >= 2 && features_out)
+	{
+		// power of each group of four bins, so rolloff can be found without
+		//	going back over the spectrum
+		float groupPower[(demoAudioFeatures_binMax + 3) / 4];
+		const unsigned int bins = extractor->bins, groups = bins / 4;
+		float *const previous = extractor->previous;
+		float sumMag, sumBinMag, sumPower, sumLogPower, sumRise, sumSq, crossings;
+		float m, p, target, total;
+		unsigned int i, j, g;
+
+#ifdef A3_DEMOAUDIOFEATURES_SSE2
+		// spectrum: every sum in one pass, four bins at a time
+		const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), powerFloor = _mm_set1_ps(a3demo_featurePowerFloor);
+		__m128 vMag = zero, vBinMag = zero, vPower = zero, vLogPower = zero, vRise = zero, vSq = zero, vCross = zero;
+		__m128 vBin = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f), vm, vp, va, vb;
+		for (g = 0; g < groups; ++g)
+		{
+			vm = _mm_loadu_ps(spectrum + g * 4);
+			vp = _mm_mul_ps(vm, vm);
+			vMag = _mm_add_ps(vMag, vm);
+			vBinMag = _mm_add_ps(vBinMag, _mm_mul_ps(vBin, vm));
+			vPower = _mm_add_ps(vPower, vp);
+			vLogPower = _mm_add_ps(vLogPower, a3demo_featureLog2(_mm_max_ps(vp, powerFloor)));
+			vRise = _mm_add_ps(vRise, _mm_max_ps(_mm_sub_ps(vm, _mm_loadu_ps(previous + g * 4)), zero));
+			_mm_storeu_ps(previous + g * 4, vm);
+			vBin = _mm_add_ps(vBin, _mm_set1_ps(4.0f));
+			groupPower[g] = a3demo_featureSum(vp);
+		}
+		sumMag = a3demo_featureSum(vMag);
+		sumBinMag = a3demo_featureSum(vBinMag);
+		sumPower = a3demo_featureSum(vPower);
+		sumLogPower = a3demo_featureSum(vLogPower);
+		sumRise = a3demo_featureSum(vRise);
+
+		// waveform: energy and sign changes between each sample and the next
+		for (j = 0; j + 4 < waveCount; j += 4)
+		{
+			va = _mm_loadu_ps(wave + j);
+			vb = _mm_loadu_ps(wave + j + 1);
+			vSq = _mm_add_ps(vSq, _mm_mul_ps(va, va));
+			vCross = _mm_add_ps(vCross, _mm_and_ps(_mm_xor_ps(_mm_cmplt_ps(va, zero), _mm_cmplt_ps(vb, zero)), one));
+		}
+		sumSq = a3demo_featureSum(vSq);
+		crossings = a3demo_featureSum(vCross);
+#else	// !A3_DEMOAUDIOFEATURES_SSE2
+		sumMag = sumBinMag = sumPower = sumLogPower = sumRise = 0.0f;
+		for (g = 0; g < groups; ++g)
+		{
+			groupPower[g] = 0.0f;
+			for (i = g * 4; i < g * 4 + 4; ++i)
+			{
+				m = spectrum[i];
+				p = m * m;
+				sumMag += m;
+				sumBinMag += (float)i * m;
+				sumPower += p;
+				sumLogPower += log2f(p > a3demo_featurePowerFloor ? p : a3demo_featurePowerFloor);
+				sumRise += m > previous[i] ? m - previous[i] : 0.0f;
+				previous[i] = m;
+				groupPower[g] += p;
+			}
+		}
+
+		sumSq = crossings = 0.0f;
+		j = 0;
+#endif	// A3_DEMOAUDIOFEATURES_SSE2
+
+		// bins left over after the groups of four, samples the vector loop did
+		//	not reach
+		for (i = groups * 4; i < bins; ++i)
+		{
+			m = spectrum[i];
+			p = m * m;
+			sumMag += m;
+			sumBinMag += (float)i * m;
+			sumPower += p;
+			sumLogPower += log2f(p > a3demo_featurePowerFloor ? p : a3demo_featurePowerFloor);
+			sumRise += m > previous[i] ? m - previous[i] : 0.0f;
+			previous[i] = m;
+		}
+		for (; j + 1 < waveCount; ++j)
+		{
+			sumSq += wave[j] * wave[j];
+			crossings += (wave[j] < 0.0f) != (wave[j + 1] < 0.0f) ? 1.0f : 0.0f;
+		}
+		sumSq += wave[j] * wave[j];
+
+		// rolloff: whole groups first, then bins inside the one that crosses
+		target = extractor->rolloffFraction * sumPower;
+		for (g = 0, total = 0.0f; g < groups && total + groupPower[g] < target; ++g)
+			total += groupPower[g];
+		for (i = g * 4; i + 1 < bins && total + spectrum[i] * spectrum[i] < target; ++i)
+			total += spectrum[i] * spectrum[i];
+
+		features_out->rms = sqrtf(sumSq / (float)waveCount);
+		features_out->zeroCrossingRate = crossings / (float)(waveCount - 1);
+		features_out->centroid = sumMag > 0.0f ? extractor->hzPerBin * sumBinMag / sumMag : 0.0f;
+		features_out->rolloff = sumPower > 0.0f ? extractor->hzPerBin * (float)i : 0.0f;
+		features_out->flux = extractor->hop ? sumRise / (float)bins : 0.0f;
+
+		// silence has no shape; geometric mean can only pass the arithmetic
+		//	one through the floor, so clamp
+		p = sumPower / (float)bins;
+		features_out->flatness = p > a3demo_featurePowerFloor ? exp2f(sumLogPower / (float)bins) / p : 0.0f;
+		if (features_out->flatness > 1.0f)
+			features_out->flatness = 1.0f;
+
+		++extractor->hop;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioFeatures.h
+	Compact per-hop feature vector (loudness, brightness, noisiness, change)
+		computed once on the CPU so shaders read a few scalars instead of
+		reducing the spectrum per pixel.
+*/
+
+#ifndef __ANIMAL3D_DEMOAUDIOFEATURES_H
+#define __ANIMAL3D_DEMOAUDIOFEATURES_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoAudioFeatures				a3_DemoAudioFeatures;
+	typedef struct a3_DemoAudioFeatureExtractor		a3_DemoAudioFeatureExtractor;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed storage sizes; nothing is allocated
+	enum a3_DemoAudioFeaturesMaxCounts
+	{
+		demoAudioFeatures_binMax = 4097,			// bins of an 8192-sample transform
+	};
+
+
+	// one hop's features
+	struct a3_DemoAudioFeatures
+	{
+		float rms;									// root mean square of the waveform
+		float zeroCrossingRate;						// fraction of neighboring samples that change sign
+		float centroid;								// magnitude-weighted mean frequency, Hz
+		float rolloff;								// frequency below which 'rolloffFraction' of the power lies, Hz
+		float flatness;								// geometric over arithmetic mean of power; 1 is noise, 0 is a pure tone
+		float flux;									// mean rise in magnitude per bin since the previous hop
+	};
+
+
+	// feature extractor
+	// one per analysis thread; keeps the previous spectrum for flux
+	struct a3_DemoAudioFeatureExtractor
+	{
+		float previous[demoAudioFeatures_binMax];	// magnitudes from last hop
+		unsigned int bins;							// spectrum length
+		float hzPerBin;								// sample rate / transform size
+		float rolloffFraction;						// share of power under the rolloff frequency
+		unsigned int hop;							// hops processed
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// reset extractor for magnitude spectra of 'bins' values (transform
+	//	size / 2 + 1, at most binMax) at a sample rate
+	int a3demo_initAudioFeatureExtractor(a3_DemoAudioFeatureExtractor *extractor_out, const unsigned int bins, const float sampleRate);
+
+	// compute every feature for one hop: a magnitude spectrum and the
+	//	waveform it was taken from (any length); the spectrum is read once,
+	//	the waveform once
+	//	returns 1 if computed
+	int a3demo_extractAudioFeatures(a3_DemoAudioFeatureExtractor *extractor, const float *spectrum, const float *wave, const unsigned int waveCount, a3_DemoAudioFeatures *features_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOAUDIOFEATURES_H
@@ -0,0 +1,462 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioSource.c
+	Audio source, WAV reader and null device implementation.
+*/
+
+#include "a3_DemoAudioSource.h"
+
+
+//-----------------------------------------------------------------------------
+
+// platform clock
+#ifdef _WIN32
+#include <Windows.h>
+#else	// !_WIN32
+#include <time.h>
+#endif	// _WIN32
+
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_readAudioSourceWave(const a3_DemoAudioSource *source, float *left_out, float *right_out, const unsigned int count)
+{
+	unsigned int position;
+	if (source && left_out && right_out && count)
+	{
+		// one position for both channels, so they cannot come from 
+		//	different moments
+		if (source->waveAtFunc && a3demo_getAudioSourcePosition(source, &position) > 0)
+			return a3demo_readAudioSourceWaveAt(source, left_out, right_out, position, count);
+		if (source->waveFunc && source->waveFunc(source->data, left_out, count, 0) > 0)
+		{
+			// mono sounds have no second channel
+			if (source->waveFunc(source->data, right_out, count, 1) <= 0)
+				memcpy(right_out, left_out, sizeof(float) * count);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_readAudioSourcePCM16(const a3_DemoAudioSource *source, short *left_out, short *right_out, const unsigned int count)
+{
+	unsigned int position;
+	if (source && left_out && right_out && count)
+	{
+		if (source->pcm16AtFunc && a3demo_getAudioSourcePosition(source, &position) > 0)
+			return a3demo_readAudioSourcePCM16At(source, left_out, right_out, position, count);
+		if (source->pcm16Func && source->pcm16Func(source->data, left_out, count, 0) > 0)
+		{
+			if (source->pcm16Func(source->data, right_out, count, 1) <= 0)
+				memcpy(right_out, left_out, sizeof(short) * count);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_readAudioSourceWaveAt(const a3_DemoAudioSource *source, float *left_out, float *right_out, const unsigned int position, const unsigned int count)
+{
+	if (source && left_out && right_out && count)
+	{
+		if (source->waveAtFunc && source->waveAtFunc(source->data, left_out, position, count, 0) > 0)
+		{
+			if (source->waveAtFunc(source->data, right_out, position, count, 1) <= 0)
+				memcpy(right_out, left_out, sizeof(float) * count);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_readAudioSourcePCM16At(const a3_DemoAudioSource *source, short *left_out, short *right_out, const unsigned int position, const unsigned int count)
+{
+	if (source && left_out && right_out && count)
+	{
+		if (source->pcm16AtFunc && source->pcm16AtFunc(source->data, left_out, position, count, 0) > 0)
+		{
+			if (source->pcm16AtFunc(source->data, right_out, position, count, 1) <= 0)
+				memcpy(right_out, left_out, sizeof(short) * count);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_getAudioSourcePosition(const a3_DemoAudioSource *source, unsigned int *position_out)
+{
+	if (source && source->positionFunc && position_out)
+		return source->positionFunc(source->data, position_out);
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// little-endian fields
+#define a3demo_waveU16(p)	((unsigned int)(p)[0] | (unsigned int)(p)[1] << 8)
+#define a3demo_waveU32(p)	(a3demo_waveU16(p) | a3demo_waveU16((p) + 2) << 16)
+
+
+int a3demo_openWaveFile(a3_DemoWaveFile *wave_out, const char *filePath)
+{
+	if (wave_out && !wave_out->pcm && filePath && *filePath)
+	{
+		a3_DemoFileMapping *const file = wave_out->file;
+		const unsigned char *ptr, *end, *fmt = 0, *data = 0;
+		unsigned int chunkSize, fmtSize = 0, dataSize = 0, tag, bits;
+
+		if (a3demo_mapFile(file, filePath, 1) <= 0)
+			return 0;
+		ptr = (const unsigned char *)file->view;
+		end = ptr + file->size;
+
+		// walk chunks after the RIFF header; every chunk is padded to an
+		//	even size and only 'fmt ' and 'data' are of interest
+		if (file->size >= 12 && !memcmp(ptr, "RIFF", 4) && !memcmp(ptr + 8, "WAVE", 4))
+		{
+			for (ptr += 12; end - ptr >= 8 && !(fmt && data); ptr += 8 + chunkSize + (chunkSize & 1))
+			{
+				chunkSize = a3demo_waveU32(ptr + 4);
+				if (!memcmp(ptr, "fmt ", 4))
+				{
+					fmt = ptr + 8;
+					fmtSize = chunkSize;
+				}
+				else if (!memcmp(ptr, "data", 4))
+				{
+					// writers that stream sometimes leave the size unset
+					data = ptr + 8;
+					dataSize = (unsigned int)(end - data) < chunkSize ? (unsigned int)(end - data) : chunkSize;
+				}
+				if ((unsigned int)(end - ptr) - 8 < chunkSize)
+					break;
+			}
+		}
+
+		if (fmt && data && fmtSize >= 16 && (unsigned int)(end - fmt) >= fmtSize)
+		{
+			// extensible format stores the real tag in its sub-format
+			tag = a3demo_waveU16(fmt);
+			if (tag == 0xfffe && fmtSize >= 40)
+				tag = a3demo_waveU16(fmt + 24);
+			wave_out->channelCount = a3demo_waveU16(fmt + 2);
+			wave_out->sampleRate = a3demo_waveU32(fmt + 4);
+			wave_out->blockAlign = a3demo_waveU16(fmt + 12);
+			bits = a3demo_waveU16(fmt + 14);
+
+			if (wave_out->channelCount && wave_out->sampleRate &&
+				wave_out->blockAlign == wave_out->channelCount * (bits / 8) &&
+				((tag == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) || (tag == 3 && bits == 32)))
+			{
+				wave_out->format = tag == 3 ? a3wave_float32 : (a3_DemoWaveFormat)(bits / 8 - 1);
+				wave_out->frameCount = dataSize / wave_out->blockAlign;
+				wave_out->pcm = data;
+				return 1;
+			}
+		}
+
+		a3demo_unmapFile(file);
+		memset(wave_out, 0, sizeof(a3_DemoWaveFile));
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_closeWaveFile(a3_DemoWaveFile *wave)
+{
+	if (wave)
+	{
+		if (wave->pcm)
+		{
+			a3demo_unmapFile(wave->file);
+			memset(wave, 0, sizeof(a3_DemoWaveFile));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+const void *a3demo_getWaveFileFrame(const a3_DemoWaveFile *wave, const unsigned int index)
+{
+	if (wave && wave->pcm && index < wave->frameCount)
+		return wave->pcm + (size_t)index * wave->blockAlign;
+	return 0;
+}
+
+int a3demo_readWaveFile(const a3_DemoWaveFile *wave, float *samples_out, const int first, const unsigned int count, const unsigned int channel)
+{
+	if (wave && wave->pcm && samples_out && channel < wave->channelCount)
+	{
+		const unsigned int stride = wave->blockAlign;
+		const long long begin = first > 0 ? first : 0;
+		const long long stop = (long long)first + count < (long long)wave->frameCount ? (long long)first + count : (long long)wave->frameCount;
+		const unsigned int lead = (unsigned int)(begin - first);
+		const unsigned int inside = stop > begin ? (unsigned int)(stop - begin) : 0;
+		const unsigned char *in;
+		float *out, *const end = samples_out + lead + inside;
+
+		// zero outside the track
+		if (inside)
+		{
+			memset(samples_out, 0, sizeof(float) * lead);
+			memset(end, 0, sizeof(float) * (count - lead - inside));
+		}
+		else
+		{
+			memset(samples_out, 0, sizeof(float) * count);
+			return 0;
+		}
+
+		in = wave->pcm + (size_t)begin * stride;
+		out = samples_out + lead;
+		switch (wave->format)
+		{
+		case a3wave_pcm8:
+			for (in += channel; out < end; ++out, in += stride)
+				*out = (float)((int)in[0] - 128) * (1.0f / 128.0f);
+			break;
+		case a3wave_pcm16:
+			for (in += channel * 2; out < end; ++out, in += stride)
+				*out = (float)(short)a3demo_waveU16(in) * (1.0f / 32768.0f);
+			break;
+		case a3wave_pcm24:
+			// sign comes from shifting the top byte into place
+			for (in += channel * 3; out < end; ++out, in += stride)
+				*out = (float)((int)((unsigned int)in[0] << 8 | (unsigned int)in[1] << 16 | (unsigned int)in[2] << 24) >> 8) * (1.0f / 8388608.0f);
+			break;
+		case a3wave_pcm32:
+			for (in += channel * 4; out < end; ++out, in += stride)
+				*out = (float)(int)a3demo_waveU32(in) * (1.0f / 2147483648.0f);
+			break;
+		case a3wave_float32:
+			for (in += channel * 4; out < end; ++out, in += stride)
+				memcpy(out, in, sizeof(float));
+			break;
+		}
+		return (int)inside;
+	}
+	return -1;
+}
+
+
+int a3demo_readWaveFilePCM16(const a3_DemoWaveFile *wave, short *samples_out, const int first, const unsigned int count, const unsigned int channel)
+{
+	if (wave && wave->pcm && wave->format == a3wave_pcm16 && samples_out && channel < wave->channelCount)
+	{
+		const unsigned int stride = wave->blockAlign;
+		const long long begin = first > 0 ? first : 0;
+		const long long stop = (long long)first + count < (long long)wave->frameCount ? (long long)first + count : (long long)wave->frameCount;
+		const unsigned int lead = (unsigned int)(begin - first);
+		const unsigned int inside = stop > begin ? (unsigned int)(stop - begin) : 0;
+		const unsigned char *in;
+		short *out, *const end = samples_out + lead + inside;
+
+		if (!inside)
+		{
+			memset(samples_out, 0, sizeof(short) * count);
+			return 0;
+		}
+		memset(samples_out, 0, sizeof(short) * lead);
+		memset(end, 0, sizeof(short) * (count - lead - inside));
+		for (in = wave->pcm + (size_t)begin * stride + channel * 2, out = samples_out + lead; out < end; ++out, in += stride)
+			*out = (short)a3demo_waveU16(in);
+		return (int)inside;
+	}
+	return -1;
+}
+
+
+// decoder read function for a WAV file
+int a3demo_readWaveFileStereo(a3_DemoWaveFile *wave, float *left_out, float *right_out, const unsigned int first, const unsigned int count)
+{
+	const int result = a3demo_readWaveFile(wave, left_out, (int)first, count, 0);
+	if (wave->channelCount > 1)
+		a3demo_readWaveFile(wave, right_out, (int)first, count, 1);
+	else
+		memcpy(right_out, left_out, sizeof(float) * count);
+	return result;
+}
+
+int a3demo_setWaveFileDecoder(a3_DemoAudioDecoder *decoder_out, a3_DemoWaveFile *wave)
+{
+	if (decoder_out && wave && wave->pcm)
+	{
+		decoder_out->readFunc = (a3_DemoAudioDecoderReadFunc)a3demo_readWaveFileStereo;
+		decoder_out->data = wave;
+		decoder_out->sampleRate = wave->sampleRate;
+		decoder_out->channelCount = wave->channelCount;
+		decoder_out->length = wave->frameCount;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+// seconds on a monotonic clock; safe to call from any thread
+double a3demo_nullDeviceClock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else	// !_WIN32
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1.0e-9;
+#endif	// _WIN32
+}
+
+// unclamped position
+double a3demo_nullDevicePosition(const a3_DemoNullDevice *device)
+{
+	if (device->playing && device->speed > 0.0)
+		return device->startPosition + (a3demo_nullDeviceClock() - device->startTime) * device->speed * (double)device->wave->sampleRate;
+	return device->startPosition;
+}
+
+// move the clock's origin to now, keeping the position
+void a3demo_nullDeviceRebase(a3_DemoNullDevice *device)
+{
+	const double position = a3demo_nullDevicePosition(device);
+	device->startTime = a3demo_nullDeviceClock();
+	device->startPosition = position;
+}
+
+
+// source functions; reads take the position the caller snapshotted, so
+//	both channels of one read come from the same window
+int a3demo_readNullDeviceWaveAt(a3_DemoNullDevice *device, float *samples_out, const unsigned int position, const unsigned int count, const unsigned int channel)
+{
+	if (device->wave && channel < device->wave->channelCount)
+	{
+		// window that ends at the playback position
+		a3demo_readWaveFile(device->wave, samples_out, (int)position - (int)count, count, channel);
+		return 1;
+	}
+	return 0;
+}
+
+int a3demo_readNullDevicePCM16At(a3_DemoNullDevice *device, short *samples_out, const unsigned int position, const unsigned int count, const unsigned int channel)
+{
+	if (device->wave && channel < device->wave->channelCount)
+		return a3demo_readWaveFilePCM16(device->wave, samples_out, (int)position - (int)count, count, channel) >= 0;
+	return 0;
+}
+
+int a3demo_getNullDeviceSourcePosition(a3_DemoNullDevice *device, unsigned int *position_out)
+{
+	if (device->wave)
+	{
+		*position_out = a3demo_getNullDevicePosition(device);
+		return 1;
+	}
+	return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initNullDevice(a3_DemoNullDevice *device_out, const a3_DemoWaveFile *wave, const double speed)
+{
+	if (device_out && wave && wave->pcm && speed >= 0.0)
+	{
+		memset(device_out, 0, sizeof(a3_DemoNullDevice));
+		device_out->wave = wave;
+		device_out->speed = speed;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_playNullDevice(a3_DemoNullDevice *device, const int playing)
+{
+	if (device && device->wave)
+	{
+		a3demo_nullDeviceRebase(device);
+		device->playing = playing;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setNullDeviceSpeed(a3_DemoNullDevice *device, const double speed)
+{
+	if (device && device->wave && speed >= 0.0)
+	{
+		a3demo_nullDeviceRebase(device);
+		device->speed = speed;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_advanceNullDevice(a3_DemoNullDevice *device, const unsigned int samples)
+{
+	if (device && device->wave)
+	{
+		device->startPosition += (double)samples;
+		return 1;
+	}
+	return -1;
+}
+
+unsigned int a3demo_getNullDevicePosition(const a3_DemoNullDevice *device)
+{
+	if (device && device->wave)
+	{
+		const double position = a3demo_nullDevicePosition(device);
+		return position < (double)device->wave->frameCount ? (unsigned int)position : device->wave->frameCount;
+	}
+	return 0;
+}
+
+int a3demo_setNullDeviceSource(a3_DemoAudioSource *source_out, a3_DemoNullDevice *device)
+{
+	if (source_out && device && device->wave)
+	{
+		source_out->waveFunc = 0;
+		source_out->positionFunc = (a3_DemoAudioSourcePositionFunc)a3demo_getNullDeviceSourcePosition;
+		source_out->pcm16Func = 0;
+		source_out->waveAtFunc = (a3_DemoAudioSourceWaveAtFunc)a3demo_readNullDeviceWaveAt;
+		source_out->pcm16AtFunc = device->wave->format == a3wave_pcm16 ? (a3_DemoAudioSourcePCM16AtFunc)a3demo_readNullDevicePCM16At : 0;
+		source_out->data = device;
+		source_out->sampleRate = device->wave->sampleRate;
+		source_out->channelCount = device->wave->channelCount;
+		return 1;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,209 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoAudioSource.h
+	Where analysis gets its samples: a playback source interface (what is
+		being heard right now) and a decoder interface (the whole track, for
+		building the analysis cache). Built in: a memory-mapped WAV reader
+		and a "null" output device that plays a WAV on a clock without any
+		sound hardware, in real time or faster.
+*/
+
+#ifndef __ANIMAL3D_DEMOAUDIOSOURCE_H
+#define __ANIMAL3D_DEMOAUDIOSOURCE_H
+
+
+#include "a3_DemoFileMapping.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoAudioSource		a3_DemoAudioSource;
+	typedef struct a3_DemoAudioDecoder		a3_DemoAudioDecoder;
+	typedef enum a3_DemoWaveFormat			a3_DemoWaveFormat;
+	typedef struct a3_DemoWaveFile			a3_DemoWaveFile;
+	typedef struct a3_DemoNullDevice		a3_DemoNullDevice;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// read the newest 'count' samples heard on a channel (0 = left, 1 = right)
+	//	returns 1 if read, 0 if the channel does not exist or nothing plays
+	typedef int(*a3_DemoAudioSourceWaveFunc)(void *data, float *samples_out, const unsigned int count, const unsigned int channel);
+
+	// same as the wave function, as int16 PCM without conversion
+	typedef int(*a3_DemoAudioSourcePCM16Func)(void *data, short *samples_out, const unsigned int count, const unsigned int channel);
+
+	// read the 'count' samples on a channel that end at 'position', a value
+	//	from the position function; lets every channel of a read share one
+	//	position instead of each asking for the newest samples
+	typedef int(*a3_DemoAudioSourceWaveAtFunc)(void *data, float *samples_out, const unsigned int position, const unsigned int count, const unsigned int channel);
+	typedef int(*a3_DemoAudioSourcePCM16AtFunc)(void *data, short *samples_out, const unsigned int position, const unsigned int count, const unsigned int channel);
+
+	// current playback position in samples
+	//	returns 1 if known, 0 if not
+	typedef int(*a3_DemoAudioSourcePositionFunc)(void *data, unsigned int *position_out);
+
+	// decode 'count' frames starting at frame 'first' into left and right
+	//	lanes (mono fills both); frames past the end are zero
+	//	returns number of frames that were in the track
+	typedef int(*a3_DemoAudioDecoderReadFunc)(void *data, float *left_out, float *right_out, const unsigned int first, const unsigned int count);
+
+
+	// playback source; called from the analysis thread, so backends must
+	//	be safe to read while the main thread runs
+	struct a3_DemoAudioSource
+	{
+		a3_DemoAudioSourceWaveFunc waveFunc;
+		a3_DemoAudioSourcePositionFunc positionFunc;
+		a3_DemoAudioSourcePCM16Func pcm16Func;	// null unless the backend holds int16 PCM
+		a3_DemoAudioSourceWaveAtFunc waveAtFunc;	// null unless the backend can read at a position
+		a3_DemoAudioSourcePCM16AtFunc pcm16AtFunc;	// int16 read at a position, if the backend has both
+		void *data;								// backend passed to every function
+		unsigned int sampleRate;
+		unsigned int channelCount;
+	};
+
+	// whole-track decoder
+	struct a3_DemoAudioDecoder
+	{
+		a3_DemoAudioDecoderReadFunc readFunc;
+		void *data;
+		unsigned int sampleRate;
+		unsigned int channelCount;
+		unsigned int length;					// frames in track
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// sample encodings the WAV reader converts from
+	enum a3_DemoWaveFormat
+	{
+		a3wave_pcm8,							// unsigned
+		a3wave_pcm16,
+		a3wave_pcm24,
+		a3wave_pcm32,
+		a3wave_float32,
+	};
+
+
+	// open WAV file; samples are read straight out of the mapping, nothing
+	//	is decoded up front
+	struct a3_DemoWaveFile
+	{
+		a3_DemoFileMapping file[1];
+		const unsigned char *pcm;				// first frame of the data chunk
+		unsigned int frameCount;
+		unsigned int sampleRate;
+		unsigned int channelCount;
+		unsigned int blockAlign;				// bytes per frame
+		a3_DemoWaveFormat format;
+	};
+
+
+	// output device that plays nothing, only keeps time
+	//	position = startPosition + (clock - startTime) * speed * sampleRate
+	struct a3_DemoNullDevice
+	{
+		const a3_DemoWaveFile *wave;
+		double speed;							// 1 is real time, 4 is four times as fast; 0 only moves on advance
+		double startTime;						// clock reading when position was startPosition
+		double startPosition;					// samples
+		int playing;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// read both channels of a source; mono sources fill both lanes
+	//	sources that can read at a position take it once for both channels,
+	//	others read each channel's newest samples back to back
+	//	returns 1 if read, 0 if the source has nothing
+	int a3demo_readAudioSourceWave(const a3_DemoAudioSource *source, float *left_out, float *right_out, const unsigned int count);
+
+	// read both channels of a source as int16, for the integer spectrum
+	//	engine; returns 0 if the source does not hold int16 PCM
+	int a3demo_readAudioSourcePCM16(const a3_DemoAudioSource *source, short *left_out, short *right_out, const unsigned int count);
+
+	// read both channels ending at a position taken from the source
+	//	returns 1 if read, 0 if the source cannot read at a position
+	int a3demo_readAudioSourceWaveAt(const a3_DemoAudioSource *source, float *left_out, float *right_out, const unsigned int position, const unsigned int count);
+	int a3demo_readAudioSourcePCM16At(const a3_DemoAudioSource *source, short *left_out, short *right_out, const unsigned int position, const unsigned int count);
+
+	// current playback position of a source
+	int a3demo_getAudioSourcePosition(const a3_DemoAudioSource *source, unsigned int *position_out);
+
+
+	// map a WAV file and find its format and data chunks
+	//	handles 8/16/24/32-bit integer and 32-bit float PCM, plain or
+	//	extensible format chunk, any channel count
+	//	returns 1 if opened, 0 if missing or not a supported WAV
+	int a3demo_openWaveFile(a3_DemoWaveFile *wave_out, const char *filePath);
+	int a3demo_closeWaveFile(a3_DemoWaveFile *wave);
+
+	// address of a frame inside the mapping (no copy, no conversion)
+	const void *a3demo_getWaveFileFrame(const a3_DemoWaveFile *wave, const unsigned int index);
+
+	// convert 'count' samples of one channel to float, starting at frame
+	//	'first'; frames outside the track (including negative) are zero
+	//	returns number of frames that were in the track
+	int a3demo_readWaveFile(const a3_DemoWaveFile *wave, float *samples_out, const int first, const unsigned int count, const unsigned int channel);
+
+	// copy 'count' samples of one channel of a 16-bit WAV as they are
+	//	returns number of frames that were in the track, -1 if not 16-bit
+	int a3demo_readWaveFilePCM16(const a3_DemoWaveFile *wave, short *samples_out, const int first, const unsigned int count, const unsigned int channel);
+
+	// WAV file as a whole-track decoder
+	int a3demo_setWaveFileDecoder(a3_DemoAudioDecoder *decoder_out, a3_DemoWaveFile *wave);
+
+
+	// set up a stopped device playing a WAV file at a speed
+	int a3demo_initNullDevice(a3_DemoNullDevice *device_out, const a3_DemoWaveFile *wave, const double speed);
+
+	// start or pause the clock, change its speed, or step it by hand;
+	//	called from the thread that owns the device; a source read made
+	//	during the call may see the position from before it
+	int a3demo_playNullDevice(a3_DemoNullDevice *device, const int playing);
+	int a3demo_setNullDeviceSpeed(a3_DemoNullDevice *device, const double speed);
+	int a3demo_advanceNullDevice(a3_DemoNullDevice *device, const unsigned int samples);
+
+	// current position in samples, clamped to the end of the track
+	unsigned int a3demo_getNullDevicePosition(const a3_DemoNullDevice *device);
+
+	// null device as a playback source; the source holds the device's address,
+	//	reads at a position and reads int16 directly when the WAV is 16-bit
+	int a3demo_setNullDeviceSource(a3_DemoAudioSource *source_out, a3_DemoNullDevice *device);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOAUDIOSOURCE_H
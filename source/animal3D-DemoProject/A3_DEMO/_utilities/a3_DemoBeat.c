@@ -0,0 +1,279 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBeat.c
+	Onset detector and beat tracker implementation.
+*/
+
+#include "a3_DemoBeat.h"
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// autocorrelation of the newest envelope: mean removed, zero padded to twice
+//	its length so lags do not wrap, power spectrum, back to time
+// the power spectrum is real and even, so transforming it forward again
+//	gives the same result as the inverse and only one config is needed
+void a3demo_beatAutocorrelate(a3_DemoBeatTracker *tracker)
+{
+	const unsigned int newest = tracker->hop;
+	kiss_fft_scalar *const acf = tracker->acfTime;
+	kiss_fft_cpx *const freq = tracker->acfFreq;
+	float mean = 0.0f;
+	unsigned int i;
+
+	for (i = 0; i < demoBeat_envelopeSize; ++i)
+		mean += tracker->envelope[i];
+	mean /= (float)demoBeat_envelopeSize;
+
+	// oldest first
+	for (i = 0; i < demoBeat_envelopeSize; ++i)
+		acf[i] = tracker->envelope[(newest + 1 + i) & (demoBeat_envelopeSize - 1)] - mean;
+	memset(acf + demoBeat_envelopeSize, 0, sizeof(kiss_fft_scalar) * (demoBeat_acfSize - demoBeat_envelopeSize));
+	kiss_fftr(tracker->acfConfig, acf, freq);
+
+	acf[0] = freq[0].r * freq[0].r;
+	for (i = 1; i <= demoBeat_acfSize / 2; ++i)
+		acf[i] = acf[demoBeat_acfSize - i] = freq[i].r * freq[i].r + freq[i].i * freq[i].i;
+	kiss_fftr(tracker->acfConfig, acf, freq);
+
+	// lag i is the real part of bin i
+	for (i = 0; i <= demoBeat_acfSize / 2; ++i)
+		acf[i] = freq[i].r;
+}
+
+// beat period with the strongest autocorrelation, counting its double
+//	too so the tracker does not settle on half the tempo, and preferring
+//	tempos near 120 BPM when two related periods score about the same
+//	returns 0 if the envelope is flat
+float a3demo_beatBestPeriod(a3_DemoBeatTracker *tracker)
+{
+	const kiss_fft_scalar *const acf = tracker->acfTime;
+	const float preferred = (float)(tracker->hopRate * 0.5);
+	unsigned int i, best = 0;
+	float score, bestScore = 0.0f, octaves, a, b, c, denom;
+
+	if (acf[0] <= 0.0f)
+		return 0.0f;
+	for (i = tracker->periodMin; i <= tracker->periodMax; ++i)
+	{
+		// neighbors together, since a period between two lags splits its peak
+		score = acf[i - 1] + acf[i] + acf[i + 1];
+		if (2 * i < demoBeat_acfSize / 2)
+			score += 0.5f * (acf[2 * i - 1] + acf[2 * i] + acf[2 * i + 1]);
+		octaves = log2f((float)i / preferred);
+		score *= expf(-0.5f * octaves * octaves);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = i;
+		}
+	}
+	if (!best)
+		return 0.0f;
+	tracker->tempoStrength = acf[best] / acf[0];
+
+	// parabola through the peak and its neighbors for a fractional period
+	a = acf[best - 1];
+	b = acf[best];
+	c = acf[best + 1];
+	denom = a - 2.0f * b + c;
+	return (float)best + (denom < 0.0f ? 0.5f * (a - c) / denom : 0.0f);
+}
+
+// hops since the last beat according to the envelope: the offset whose
+//	comb of beats (one every period, looking back) collects the most flux
+unsigned int a3demo_beatCombOffset(const a3_DemoBeatTracker *tracker)
+{
+	const unsigned int period = (unsigned int)(tracker->period + 0.5f);
+	unsigned int offset, j, best = 0;
+	float score, bestScore = -1.0f;
+
+	for (offset = 0; offset < period; ++offset)
+	{
+		for (j = 0, score = 0.0f; j < demoBeat_combBeats; ++j)
+			score += tracker->envelope[(tracker->hop - offset - j * period) & (demoBeat_envelopeSize - 1)];
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = offset;
+		}
+	}
+	return best;
+}
+
+// new tempo from the envelope, then pull the grid toward the beats in it
+void a3demo_beatLock(a3_DemoBeatTracker *tracker)
+{
+	float period, target, err;
+
+	a3demo_beatAutocorrelate(tracker);
+	period = a3demo_beatBestPeriod(tracker);
+
+	// weak periodicity (speech, silence, a breakdown) leaves the grid
+	//	running at its last tempo
+	if (period <= 0.0f || tracker->tempoStrength < 0.1f)
+		return;
+	tracker->period += 0.25f * (period - tracker->period);
+
+	// phase this hop should start from, so that after advancing it reads
+	//	hops-since-beat over period
+	target = ((float)a3demo_beatCombOffset(tracker) - 1.0f) / tracker->period;
+	err = target - tracker->beatPhase;
+	err -= floorf(err + 0.5f);
+	tracker->beatPhase += tracker->lockGain * err;
+	tracker->beatPhase -= floorf(tracker->beatPhase);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initBeatTracker(a3_DemoBeatTracker *tracker_out, const double hopRate, const unsigned int bandCount)
+{
+	if (tracker_out && hopRate > 0.0 && bandCount && bandCount <= demoBeat_bandMax)
+	{
+		const double hopsPerMinute = 60.0 * hopRate;
+		double periodMin, periodMax;
+		size_t fftMemorySize = sizeof(tracker_out->fftMemory);
+
+		memset(tracker_out, 0, sizeof(a3_DemoBeatTracker));
+		tracker_out->acfConfig = kiss_fftr_alloc(demoBeat_acfSize, 0, tracker_out->fftMemory, &fftMemorySize);
+		if (!tracker_out->acfConfig)
+			return -1;
+
+		tracker_out->compression = 100.0f;
+		tracker_out->thresholdScale = 1.5f;
+		tracker_out->thresholdOffset = 0.05f;
+		tracker_out->tempoMin = 60.0f;
+		tracker_out->tempoMax = 200.0f;
+		tracker_out->lockGain = 0.2f;
+		tracker_out->hopRate = hopRate;
+		tracker_out->bandCount = bandCount;
+
+		// tempo range in hops; the comb must fit in the envelope and the
+		//	parabola needs a neighbor on each side
+		periodMin = floor(hopsPerMinute / tracker_out->tempoMax);
+		periodMax = ceil(hopsPerMinute / tracker_out->tempoMin);
+		tracker_out->periodMin = periodMin > 2.0 ? (unsigned int)periodMin : 2;
+		tracker_out->periodMax = periodMax < (double)demoBeat_periodMax ? (unsigned int)periodMax : demoBeat_periodMax;
+		if (tracker_out->periodMax > demoBeat_envelopeSize / (demoBeat_combBeats + 1))
+			tracker_out->periodMax = demoBeat_envelopeSize / (demoBeat_combBeats + 1);
+		if (tracker_out->periodMax <= tracker_out->periodMin)
+			tracker_out->periodMax = tracker_out->periodMin + 1;
+
+		// 50 ms between onsets at most
+		tracker_out->gapMin = hopRate > 20.0 ? (unsigned int)(0.05 * hopRate) : 1;
+
+		// start at 120 BPM until the envelope says otherwise
+		tracker_out->period = (float)(hopsPerMinute / 120.0);
+		tracker_out->tempo = 120.0f;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_updateBeatTracker(a3_DemoBeatTracker *tracker, const float *bands)
+{
+	if (tracker && tracker->hopRate > 0.0 && bands)
+	{
+		float *const previous = tracker->previous;
+		const unsigned int window = tracker->hop < demoBeat_fluxWindow ? tracker->hop + 1 : demoBeat_fluxWindow;
+		float *const slot = tracker->fluxWindow + tracker->hop % demoBeat_fluxWindow;
+		float flux = 0.0f, compressed, rise;
+		unsigned int i;
+
+		// spectral flux: how much the compressed bands rose since last hop
+		for (i = 0; i < tracker->bandCount; ++i)
+		{
+			compressed = logf(1.0f + tracker->compression * bands[i]);
+			rise = compressed - previous[i];
+			if (rise > 0.0f)
+				flux += rise;
+			previous[i] = compressed;
+		}
+		flux = tracker->hop ? flux / (float)tracker->bandCount : 0.0f;
+		tracker->envelope[tracker->hop & (demoBeat_envelopeSize - 1)] = flux;
+
+		// adaptive threshold follows the recent average
+		tracker->fluxSum += flux - *slot;
+		*slot = flux;
+		tracker->flux[2] = tracker->flux[1];
+		tracker->flux[1] = tracker->flux[0];
+		tracker->flux[0] = flux;
+		tracker->threshold[1] = tracker->threshold[0];
+		tracker->threshold[0] = tracker->fluxSum / (float)window * tracker->thresholdScale + tracker->thresholdOffset;
+		tracker->onsetStrength = flux / tracker->threshold[0];
+
+		// previous hop is an onset if it is a local peak above its threshold
+		//	and far enough from the last one
+		tracker->onset = tracker->hop >= 2
+			&& tracker->flux[1] > tracker->threshold[1]
+			&& tracker->flux[1] > tracker->flux[2]
+			&& tracker->flux[1] >= tracker->flux[0]
+			&& (tracker->onsetTotal == 0 || tracker->hop - 1 - tracker->onsetHop >= tracker->gapMin);
+		if (tracker->onset)
+		{
+			tracker->onsetHop = tracker->hop - 1;
+			++tracker->onsetTotal;
+		}
+
+		// tempo and phase once the envelope holds a few beats
+		if (tracker->hop >= demoBeat_envelopeSize / 2 && tracker->hop % demoBeat_tempoInterval == 0)
+			a3demo_beatLock(tracker);
+
+		// advance beat grid
+		tracker->beatPhase += 1.0f / tracker->period;
+		tracker->beat = tracker->beatPhase >= 1.0f;
+		if (tracker->beat)
+		{
+			tracker->beatPhase -= floorf(tracker->beatPhase);
+			++tracker->beatCount;
+		}
+		tracker->tempo = (float)(60.0 * tracker->hopRate) / tracker->period;
+
+		++tracker->hop;
+		return tracker->onset;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_predictBeat(float *phase_out, float *secondsToBeat_out_opt, const float beatPhase, const float tempo, const double secondsAhead)
+{
+	if (phase_out && tempo > 0.0f)
+	{
+		const double beatsPerSecond = (double)tempo / 60.0;
+		const double beats = (double)beatPhase + secondsAhead * beatsPerSecond;
+		const double passed = floor(beats);
+		*phase_out = (float)(beats - passed);
+		if (secondsToBeat_out_opt)
+			*secondsToBeat_out_opt = (float)((1.0 - (beats - passed)) / beatsPerSecond);
+		return passed > 0.0 ? (int)passed : 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
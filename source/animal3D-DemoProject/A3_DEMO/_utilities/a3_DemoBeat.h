@@ -0,0 +1,137 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoBeat.h
+	Streaming spectral-flux onset detector and beat tracker; runs once per
+		analysis hop on band magnitudes. Tempo comes from the autocorrelation
+		of the onset envelope, and the beat grid is phase-locked to it so
+		beats can be predicted ahead of the audio.
+*/
+
+#ifndef __ANIMAL3D_DEMOBEAT_H
+#define __ANIMAL3D_DEMOBEAT_H
+
+
+// kissfft real transform for autocorrelation
+#include "kissfft/tools/kiss_fftr.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoBeatTracker		a3_DemoBeatTracker;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed storage sizes; nothing is allocated
+	enum a3_DemoBeatMaxCounts
+	{
+		demoBeat_bandMax = 256,				// bands per hop
+		demoBeat_fluxWindow = 32,			// hops averaged for the adaptive threshold
+		demoBeat_envelopeSize = 512,		// hops of onset envelope kept for tempo (power of two)
+		demoBeat_acfSize = 1024,			// autocorrelation transform size; twice the envelope so it does not wrap
+		demoBeat_periodMax = 256,			// longest beat period in hops
+		demoBeat_combBeats = 4,				// beats of envelope the phase lock looks back over
+		demoBeat_tempoInterval = 8,			// hops between tempo and phase updates
+		demoBeat_fftMemory = 12288,			// bytes for the transform config
+	};
+
+
+	// onset detector and beat tracker
+	// one per analysis thread; the 'out' members are refreshed every hop
+	struct a3_DemoBeatTracker
+	{
+		// detection settings
+		float compression;								// bands go through log(1 + compression * band)
+		float thresholdScale;							// onset when flux > mean * scale + offset
+		float thresholdOffset;
+		float tempoMin, tempoMax;						// beats per minute tracked
+		float lockGain;									// share of the phase error corrected per update
+
+		// hop timing
+		double hopRate;									// hops per second
+		unsigned int hop;								// hops processed
+		unsigned int periodMin, periodMax;				// tempo range as beat periods in hops
+		unsigned int gapMin;							// fewest hops between onsets
+
+		// spectral flux and adaptive threshold
+		float previous[demoBeat_bandMax];				// compressed bands from last hop
+		float fluxWindow[demoBeat_fluxWindow];			// recent flux values
+		float fluxSum;									// sum of fluxWindow
+		float flux[3];									// flux at this hop and the two before
+		float threshold[2];								// threshold at this hop and the one before
+		unsigned int bandCount;
+		unsigned int onsetHop;							// hop of the most recent onset
+
+		// tempo: autocorrelation of the flux envelope, done every few hops
+		float envelope[demoBeat_envelopeSize];			// flux ring, indexed by hop
+		kiss_fft_scalar acfTime[demoBeat_acfSize];		// transform input, then autocorrelation
+		kiss_fft_cpx acfFreq[demoBeat_acfSize / 2 + 1];
+		kiss_fftr_cfg acfConfig;						// placed in fftMemory
+		double fftMemory[demoBeat_fftMemory / sizeof(double)];
+		float period;									// current beat period in hops
+		float tempoStrength;							// autocorrelation at the period over its value at 0
+
+		// outputs
+		float onsetStrength;							// flux relative to threshold, > 1 at onsets
+		float beatPhase;								// 0 on the beat, rising to 1 just before the next
+		float tempo;									// beats per minute
+		unsigned int onsetTotal;						// onsets since start
+		unsigned int beatCount;							// beats since start
+		int onset;										// set on hops that detected an onset
+		int beat;										// set on hops where a beat fell
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// reset tracker for a hop rate and number of bands per hop
+	int a3demo_initBeatTracker(a3_DemoBeatTracker *tracker_out, const double hopRate, const unsigned int bandCount);
+
+	// feed one hop of band magnitudes; updates the outputs
+	//	peaks are picked one hop late, so an onset is reported on the hop
+	//	after the one it happened on; the beat grid is not delayed
+	//	cost per hop is bounded: the autocorrelation (two transforms of
+	//	acfSize) runs once every tempoInterval hops
+	//	returns 1 if an onset was detected on this hop, 0 if not
+	int a3demo_updateBeatTracker(a3_DemoBeatTracker *tracker, const float *bands);
+
+	// extend a beat grid 'secondsAhead' into the future, e.g. to where it
+	//	will be when a frame analyzed now reaches the screen
+	//	phase_out receives the grid phase then; secondsToBeat_out_opt the
+	//	time from then to the following beat
+	//	returns the number of beats passed on the way
+	int a3demo_predictBeat(float *phase_out, float *secondsToBeat_out_opt, const float beatPhase, const float tempo, const double secondsAhead);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOBEAT_H
@@ -0,0 +1,230 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoChroma.c
+	Chroma and key estimate implementation.
+*/
+
+#include "a3_DemoChroma.h"
+
+#include <string.h>
+#include <math.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define A3_DEMOCHROMA_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+// chroma power below this is silence
+#define a3demo_chromaPowerFloor		1.0e-12f
+
+// Krumhansl-Kessler key profiles: how well each pitch class fits a major
+//	or minor key on C, from listening tests
+const float a3demo_chromaMajorProfile[demoChroma_pitchCount] = { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+const float a3demo_chromaMinorProfile[demoChroma_pitchCount] = { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+
+// copy a profile rotated to a tonic, centered and scaled to unit length,
+//	so a dot product with centered chroma is a correlation
+void a3demo_chromaSetProfile(float *profile_out, const float *profile, const unsigned int tonic)
+{
+	float mean = 0.0f, length = 0.0f;
+	unsigned int i;
+	for (i = 0; i < demoChroma_pitchCount; ++i)
+		mean += profile[i];
+	mean /= (float)demoChroma_pitchCount;
+	for (i = 0; i < demoChroma_pitchCount; ++i)
+	{
+		profile_out[(i + tonic) % demoChroma_pitchCount] = profile[i] - mean;
+		length += (profile[i] - mean) * (profile[i] - mean);
+	}
+	length = 1.0f / sqrtf(length);
+	for (i = 0; i < demoChroma_pitchCount; ++i)
+		profile_out[i] *= length;
+}
+
+// pitch class below a frequency and how far it is towards the next, 0 to 1
+unsigned int a3demo_chromaPitch(const float hz, float *fraction_out)
+{
+	// MIDI note number, so 0 is a C
+	const float note = 12.0f * log2f(hz / 440.0f) + 69.0f;
+	const float below = floorf(note);
+	*fraction_out = note - below;
+	return (unsigned int)below % demoChroma_pitchCount;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initChromaAnalyzer(a3_DemoChromaAnalyzer *analyzer_out, const unsigned int bins, const float sampleRate, const double hopRate, const float minHz, const float maxHz, const float keyTime)
+{
+	if (analyzer_out && bins >= 2 && bins <= demoChroma_binMax && sampleRate > 0.0f && hopRate > 0.0 && minHz > 0.0f && maxHz > minHz && keyTime > 0.0f)
+	{
+		const float hzPerBin = sampleRate / (float)(2 * (bins - 1));
+		unsigned int first = (unsigned int)ceilf(minHz / hzPerBin), last = (unsigned int)(maxHz / hzPerBin);
+		unsigned int count[demoChroma_pitchCount] = { 0 };
+		unsigned int i, c;
+		float fraction;
+
+		memset(analyzer_out, 0, sizeof(a3_DemoChromaAnalyzer));
+		if (first < 1)
+			first = 1;
+		if (last > bins - 1)
+			last = bins - 1;
+
+		// count entries per class, then lay them out grouped by class
+		for (i = first; i <= last; ++i)
+		{
+			c = a3demo_chromaPitch((float)i * hzPerBin, &fraction);
+			++count[c];
+			++count[(c + 1) % demoChroma_pitchCount];
+		}
+		for (c = 0; c < demoChroma_pitchCount; ++c)
+			analyzer_out->start[c + 1] = (unsigned short)(analyzer_out->start[c] + count[c]);
+		memset(count, 0, sizeof(count));
+		for (i = first; i <= last; ++i)
+		{
+			c = a3demo_chromaPitch((float)i * hzPerBin, &fraction);
+			analyzer_out->bin[analyzer_out->start[c] + count[c]] = (unsigned short)i;
+			analyzer_out->weight[analyzer_out->start[c] + count[c]++] = 1.0f - fraction;
+			c = (c + 1) % demoChroma_pitchCount;
+			analyzer_out->bin[analyzer_out->start[c] + count[c]] = (unsigned short)i;
+			analyzer_out->weight[analyzer_out->start[c] + count[c]++] = fraction;
+		}
+
+		for (c = 0; c < demoChroma_pitchCount; ++c)
+		{
+			a3demo_chromaSetProfile(analyzer_out->profile[c], a3demo_chromaMajorProfile, c);
+			a3demo_chromaSetProfile(analyzer_out->profile[c + demoChroma_pitchCount], a3demo_chromaMinorProfile, c);
+		}
+
+		analyzer_out->smoothing = (float)(1.0 - exp(-1.0 / (keyTime * hopRate)));
+		analyzer_out->keyMargin = 0.05f;
+		analyzer_out->bins = bins;
+		analyzer_out->key = -1;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_updateChromaAnalyzer(a3_DemoChromaAnalyzer *analyzer, const float *spectrum)
+{
+	if (analyzer && analyzer->bins && spectrum)
+	{
+		const unsigned int bins = analyzer->bins;
+		const float *const weight = analyzer->weight;
+		const unsigned short *const bin = analyzer->bin;
+		float *const power = analyzer->power;
+		float chroma[demoChroma_pitchCount], centered[demoChroma_pitchCount];
+		float sum, peak, mean, length, score, best;
+		unsigned int i, j, c, k;
+
+		// power spectrum first, so the map only gathers and scales
+#ifdef A3_DEMOCHROMA_SSE
+		__m128 v, s0, s1, s2;
+		for (i = 0; i + 4 <= bins; i += 4)
+		{
+			v = _mm_loadu_ps(spectrum + i);
+			_mm_storeu_ps(power + i, _mm_mul_ps(v, v));
+		}
+#else	// !A3_DEMOCHROMA_SSE
+		i = 0;
+#endif	// A3_DEMOCHROMA_SSE
+		for (; i < bins; ++i)
+			power[i] = spectrum[i] * spectrum[i];
+
+		// fold into pitch classes and into the slow history the key uses
+		peak = 0.0f;
+		for (c = 0; c < demoChroma_pitchCount; ++c)
+		{
+			for (j = analyzer->start[c], sum = 0.0f; j < analyzer->start[c + 1]; ++j)
+				sum += weight[j] * power[bin[j]];
+			chroma[c] = sum;
+			analyzer->history[c] += analyzer->smoothing * (sum - analyzer->history[c]);
+			if (sum > peak)
+				peak = sum;
+		}
+
+		// shaders get magnitudes scaled so the strongest class is 1
+		if (peak > a3demo_chromaPowerFloor)
+			for (c = 0, peak = 1.0f / sqrtf(peak); c < demoChroma_pitchCount; ++c)
+				analyzer->chroma[c] = sqrtf(chroma[c]) * peak;
+		else
+			memset(analyzer->chroma, 0, sizeof(analyzer->chroma));
+
+		// correlate the centered history with every key template; a key
+		//	only changes when another one fits clearly better
+		for (c = 0, mean = 0.0f; c < demoChroma_pitchCount; ++c)
+			mean += analyzer->history[c];
+		mean /= (float)demoChroma_pitchCount;
+		for (c = 0, length = 0.0f; c < demoChroma_pitchCount; ++c)
+		{
+			centered[c] = analyzer->history[c] - mean;
+			length += centered[c] * centered[c];
+		}
+		if (mean > a3demo_chromaPowerFloor && length > 0.0f)
+		{
+			length = 1.0f / sqrtf(length);
+			for (c = 0; c < demoChroma_pitchCount; ++c)
+				centered[c] *= length;
+
+#ifdef A3_DEMOCHROMA_SSE
+			// twelve classes are three lanes of four
+			s0 = _mm_loadu_ps(centered);
+			s1 = _mm_loadu_ps(centered + 4);
+			s2 = _mm_loadu_ps(centered + 8);
+#endif	// A3_DEMOCHROMA_SSE
+			for (k = 0, best = -2.0f; k < demoChroma_keyCount; ++k)
+			{
+#ifdef A3_DEMOCHROMA_SSE
+				v = _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(s0, _mm_loadu_ps(analyzer->profile[k])),
+					_mm_mul_ps(s1, _mm_loadu_ps(analyzer->profile[k] + 4))),
+					_mm_mul_ps(s2, _mm_loadu_ps(analyzer->profile[k] + 8)));
+				v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+				v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+				score = _mm_cvtss_f32(v);
+#else	// !A3_DEMOCHROMA_SSE
+				for (c = 0, score = 0.0f; c < demoChroma_pitchCount; ++c)
+					score += centered[c] * analyzer->profile[k][c];
+#endif	// A3_DEMOCHROMA_SSE
+				analyzer->keyScore[k] = score;
+				if (score > best)
+				{
+					best = score;
+					i = k;
+				}
+			}
+			if (analyzer->key < 0 || best > analyzer->keyScore[analyzer->key] + analyzer->keyMargin)
+				analyzer->key = (int)i;
+			analyzer->keyStrength = analyzer->keyScore[analyzer->key];
+		}
+
+		++analyzer->hop;
+		return analyzer->key;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoChroma.h
+	Pitch-class energy (chroma) from a magnitude spectrum through a
+		precomputed sparse bin map, and a smoothed estimate of the key it
+		suggests.
+*/
+
+#ifndef __ANIMAL3D_DEMOCHROMA_H
+#define __ANIMAL3D_DEMOCHROMA_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoChromaAnalyzer	a3_DemoChromaAnalyzer;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed storage sizes; nothing is allocated
+	enum a3_DemoChromaMaxCounts
+	{
+		demoChroma_binMax = 4097,				// bins of an 8192-sample transform
+		demoChroma_entryMax = demoChroma_binMax * 2,	// every bin feeds at most two pitch classes
+		demoChroma_pitchCount = 12,				// C, C#, D ... B
+		demoChroma_keyCount = 24,				// 0-11 major on C..B, 12-23 minor on C..B
+	};
+
+
+	// chroma analyzer
+	// the map lists, per pitch class, the bins that feed it and how much;
+	//	a bin between two semitones is shared between them
+	// one per analysis thread
+	struct a3_DemoChromaAnalyzer
+	{
+		float power[demoChroma_binMax];			// squared magnitudes of the current hop
+		float weight[demoChroma_entryMax];		// map entries, grouped by pitch class
+		unsigned short bin[demoChroma_entryMax];
+		unsigned short start[demoChroma_pitchCount + 1];	// entries of class c are start[c] to start[c + 1]
+		float profile[demoChroma_keyCount][demoChroma_pitchCount];	// key templates, zero mean, unit length
+		float chroma[demoChroma_pitchCount];	// latest hop, largest class is 1
+		float history[demoChroma_pitchCount];	// chroma power averaged over 'keyTime'
+		float keyScore[demoChroma_keyCount];	// correlation of history with each template
+		float smoothing;						// history update weight per hop
+		float keyMargin;						// score a new key needs over the current one
+		unsigned int bins;						// spectrum length
+		unsigned int hop;						// hops processed
+		int key;								// current key, -1 before there is any pitched sound
+		float keyStrength;						// its score; near 1 is clearly tonal
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// reset analyzer for magnitude spectra of 'bins' values (transform
+	//	size / 2 + 1, at most binMax) at a sample rate, arriving 'hopRate'
+	//	times per second; the key follows about 'keyTime' seconds of sound
+	//	(bins below minHz or above maxHz are left out)
+	int a3demo_initChromaAnalyzer(a3_DemoChromaAnalyzer *analyzer_out, const unsigned int bins, const float sampleRate, const double hopRate, const float minHz, const float maxHz, const float keyTime);
+
+	// fold one hop's spectrum into chroma and update the key estimate
+	//	returns key
+	int a3demo_updateChromaAnalyzer(a3_DemoChromaAnalyzer *analyzer, const float *spectrum);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOCHROMA_H
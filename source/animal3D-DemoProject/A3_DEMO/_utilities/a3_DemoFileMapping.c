@@ -0,0 +1,126 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoFileMapping.c
+	File mapping implementation.
+*/
+
+#include "a3_DemoFileMapping.h"
+
+
+//-----------------------------------------------------------------------------
+
+// platform file mapping
+#ifdef _WIN32
+#include <Windows.h>
+#else	// !_WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif	// _WIN32
+
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_mapFile(a3_DemoFileMapping *mapping_out, const char *filePath, const int sequential)
+{
+	if (mapping_out && !mapping_out->view && filePath && *filePath)
+	{
+		void *view = 0;
+		unsigned int size = 0;
+
+#ifdef _WIN32
+		const DWORD access = sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+		HANDLE file, mapping = 0;
+		LARGE_INTEGER fileSize;
+		file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | access, 0);
+		if (file == INVALID_HANDLE_VALUE)
+			return 0;
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart < 0x80000000)
+		{
+			size = (unsigned int)fileSize.QuadPart;
+			mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+			if (mapping)
+				view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		}
+		if (!view)
+		{
+			if (mapping)
+				CloseHandle(mapping);
+			CloseHandle(file);
+			return 0;
+		}
+		mapping_out->file = file;
+		mapping_out->mapping = mapping;
+#else	// !_WIN32
+		struct stat fileStat;
+		const int file = open(filePath, O_RDONLY);
+		if (file < 0)
+			return 0;
+		if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0 && fileStat.st_size < 0x80000000)
+		{
+			size = (unsigned int)fileStat.st_size;
+			view = mmap(0, size, PROT_READ, MAP_SHARED, file, 0);
+			if (view == MAP_FAILED)
+				view = 0;
+		}
+
+		// mapping stays valid after the descriptor is closed
+		close(file);
+		if (!view)
+			return 0;
+		madvise(view, size, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+		mapping_out->file = mapping_out->mapping = 0;
+#endif	// _WIN32
+
+		mapping_out->view = view;
+		mapping_out->size = size;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_unmapFile(a3_DemoFileMapping *mapping)
+{
+	if (mapping)
+	{
+		if (mapping->view)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(mapping->view);
+			CloseHandle((HANDLE)mapping->mapping);
+			CloseHandle((HANDLE)mapping->file);
+#else	// !_WIN32
+			munmap(mapping->view, mapping->size);
+#endif	// _WIN32
+			memset(mapping, 0, sizeof(a3_DemoFileMapping));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
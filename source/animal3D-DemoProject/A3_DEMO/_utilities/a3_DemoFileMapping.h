@@ -0,0 +1,69 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoFileMapping.h
+	Read-only memory mapping of a whole file.
+*/
+
+#ifndef __ANIMAL3D_DEMOFILEMAPPING_H
+#define __ANIMAL3D_DEMOFILEMAPPING_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoFileMapping		a3_DemoFileMapping;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// mapped file; pages are read in by the OS as they are touched
+	struct a3_DemoFileMapping
+	{
+		void *view;								// start of mapping
+		void *file, *mapping;					// platform handles
+		unsigned int size;						// bytes mapped
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// map a file for reading; 'sequential' hints that it will be read front
+	//	to back (streaming) rather than at random
+	//	returns 1 if mapped, 0 if the file is missing, empty or 2 GB or more
+	int a3demo_mapFile(a3_DemoFileMapping *mapping_out, const char *filePath, const int sequential);
+
+	// release mapping
+	int a3demo_unmapFile(a3_DemoFileMapping *mapping);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOFILEMAPPING_H
@@ -0,0 +1,351 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGraphicsState.c
+	Graphics state cache implementation.
+*/
+
+#include "a3_DemoGraphicsState.h"
+
+
+// OpenGL
+#ifdef _WIN32
+#include <Windows.h>
+#include <GL/glew.h>
+#else	// !_WIN32
+#include <OpenGL/gl3.h>
+#endif	// _WIN32
+
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// count one call of a kind as sent or dropped
+//	returns 'sent'
+int a3demo_graphicsCount(a3_DemoGraphicsState *state, const a3_DemoGraphicsStateKind kind, const int sent)
+{
+	if (sent)
+		++state->issued[kind];
+	else
+		++state->skipped[kind];
+	return sent;
+}
+
+// enable or disable a capability unless it already is
+//	returns 1 if GL was called
+int a3demo_graphicsEnable(a3_DemoGraphicsState *state, const a3_DemoGraphicsStateKind kind, const int capability, int *current, const int enable)
+{
+	if (*current != enable)
+	{
+		if (enable)
+			glEnable(capability);
+		else
+			glDisable(capability);
+		*current = enable;
+		return a3demo_graphicsCount(state, kind, 1);
+	}
+	return a3demo_graphicsCount(state, kind, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_invalidateGraphicsState(a3_DemoGraphicsState *state)
+{
+	if (state)
+	{
+		state->program = 0;
+		memset(state->texture, 0, sizeof(state->texture));
+		memset(state->uniformBuffer, 0, sizeof(state->uniformBuffer));
+		memset(state->uniformOffset, 0, sizeof(state->uniformOffset));
+		memset(state->uniformSize, 0, sizeof(state->uniformSize));
+		state->vertexArray = 0;
+		state->indexBuffer = 0;
+		state->framebuffer = 0;
+		state->viewport[0] = state->viewport[1] = state->viewport[2] = state->viewport[3] = -1;
+		state->depthType = -1;
+		state->depthTest = state->depthFunc = -1;
+		state->cullFace = state->cullMode = -1;
+		state->blend = state->blendSrc = state->blendDst = -1;
+		state->known = 0;
+		state->textureKnown = 0;
+		state->uniformKnown = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_resetGraphicsStateStats(a3_DemoGraphicsState *state)
+{
+	if (state)
+	{
+		memset(state->issued, 0, sizeof(state->issued));
+		memset(state->skipped, 0, sizeof(state->skipped));
+		return 1;
+	}
+	return -1;
+}
+
+unsigned int a3demo_getGraphicsStateIssued(const a3_DemoGraphicsState *state)
+{
+	unsigned int i, total = 0;
+	if (state)
+		for (i = 0; i < demoGraphicsState_kindCount; ++i)
+			total += state->issued[i];
+	return total;
+}
+
+unsigned int a3demo_getGraphicsStateSkipped(const a3_DemoGraphicsState *state)
+{
+	unsigned int i, total = 0;
+	if (state)
+		for (i = 0; i < demoGraphicsState_kindCount; ++i)
+			total += state->skipped[i];
+	return total;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_setGraphicsProgram(a3_DemoGraphicsState *state, const a3_ShaderProgram *program)
+{
+	if (state)
+	{
+		const unsigned int bit = 1u << a3gfx_program;
+		if ((state->known & bit) && state->program == program)
+			return a3demo_graphicsCount(state, a3gfx_program, 0);
+
+		if (program)
+			a3shaderProgramActivate(program);
+		else
+			a3shaderProgramDeactivate();
+		state->program = program;
+		state->known |= bit;
+		return a3demo_graphicsCount(state, a3gfx_program, 1);
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsTexture(a3_DemoGraphicsState *state, const a3_Texture *texture, const a3_TextureUnit unit)
+{
+	if (state && (unsigned int)unit < a3tex_unitMax)
+	{
+		const unsigned int bit = 1u << unit;
+		if ((state->textureKnown & bit) && state->texture[unit] == texture)
+			return a3demo_graphicsCount(state, a3gfx_texture, 0);
+
+		if (texture)
+			a3textureActivate(texture, unit);
+		else
+			a3textureDeactivate(unit);
+		state->texture[unit] = texture;
+		state->textureKnown |= bit;
+		return a3demo_graphicsCount(state, a3gfx_texture, 1);
+	}
+	return -1;
+}
+
+int a3demo_forgetGraphicsTexture(a3_DemoGraphicsState *state, const a3_TextureUnit unit)
+{
+	if (state && (unsigned int)unit < a3tex_unitMax)
+	{
+		state->textureKnown &= ~(1u << unit);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsUniformRange(a3_DemoGraphicsState *state, const a3_UniformBuffer *buffer, const unsigned int binding, const unsigned int offset, const unsigned int size)
+{
+	if (state && buffer && binding < demoGraphicsState_uniformBindingMax && size && offset + size <= buffer->size)
+	{
+		const unsigned int bit = 1u << binding;
+		if ((state->uniformKnown & bit) && state->uniformBuffer[binding] == buffer &&
+			state->uniformOffset[binding] == offset && state->uniformSize[binding] == size)
+			return a3demo_graphicsCount(state, a3gfx_uniformBuffer, 0);
+
+		glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer->handle->handle, offset, size);
+		state->uniformBuffer[binding] = buffer;
+		state->uniformOffset[binding] = offset;
+		state->uniformSize[binding] = size;
+		state->uniformKnown |= bit;
+		return a3demo_graphicsCount(state, a3gfx_uniformBuffer, 1);
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsDrawable(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable)
+{
+	if (state && drawable && drawable->vertexArray)
+	{
+		const unsigned int bit = 1u << a3gfx_vertexArray;
+		if ((state->known & bit) && state->vertexArray == drawable->vertexArray && state->indexBuffer == drawable->indexBuffer)
+			return a3demo_graphicsCount(state, a3gfx_vertexArray, 0);
+
+		a3vertexActivateDrawable(drawable);
+		state->vertexArray = drawable->vertexArray;
+		state->indexBuffer = drawable->indexBuffer;
+		state->known |= bit;
+		return a3demo_graphicsCount(state, a3gfx_vertexArray, 1);
+	}
+	return -1;
+}
+
+int a3demo_drawGraphicsDrawable(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable)
+{
+	if (a3demo_setGraphicsDrawable(state, drawable) >= 0)
+	{
+		// primitive and index type are stored as GL enums
+		if (drawable->indexBuffer)
+			glDrawElements(drawable->primitive, drawable->count, drawable->indexType, drawable->indexing);
+		else
+			glDrawArrays(drawable->primitive, drawable->first, drawable->count);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_drawGraphicsDrawableInstanced(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable, const unsigned int instanceCount)
+{
+	if (!instanceCount)
+		return 0;
+	if (a3demo_setGraphicsDrawable(state, drawable) >= 0)
+	{
+		if (drawable->indexBuffer)
+			glDrawElementsInstanced(drawable->primitive, drawable->count, drawable->indexType, drawable->indexing, instanceCount);
+		else
+			glDrawArraysInstanced(drawable->primitive, drawable->first, drawable->count, instanceCount);
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsFramebuffer(a3_DemoGraphicsState *state, const a3_Framebuffer *framebuffer)
+{
+	if (state && framebuffer)
+	{
+		const unsigned int bit = 1u << a3gfx_framebuffer;
+		if ((state->known & bit) && state->framebuffer == framebuffer)
+			return a3demo_graphicsCount(state, a3gfx_framebuffer, 0);
+
+		a3framebufferActivate(framebuffer);
+		state->framebuffer = framebuffer;
+		state->known |= bit;
+		state->depthTest = state->depthFunc = -1;
+		return a3demo_graphicsCount(state, a3gfx_framebuffer, 1);
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsDefaultFramebuffer(a3_DemoGraphicsState *state, const a3_FramebufferDepthType depthType, const int x, const int y, const unsigned int width, const unsigned int height)
+{
+	if (state)
+	{
+		const unsigned int bit = 1u << a3gfx_framebuffer;
+		if ((state->known & bit) && !state->framebuffer && state->depthType == (int)depthType &&
+			state->viewport[0] == x && state->viewport[1] == y &&
+			state->viewport[2] == (int)width && state->viewport[3] == (int)height)
+			return a3demo_graphicsCount(state, a3gfx_framebuffer, 0);
+
+		a3framebufferDeactivateSetViewport(depthType, x, y, width, height);
+		state->framebuffer = 0;
+		state->depthType = (int)depthType;
+		state->viewport[0] = x;
+		state->viewport[1] = y;
+		state->viewport[2] = (int)width;
+		state->viewport[3] = (int)height;
+		state->known |= bit;
+		state->depthTest = state->depthFunc = -1;
+		return a3demo_graphicsCount(state, a3gfx_framebuffer, 1);
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsDepth(a3_DemoGraphicsState *state, const int depthTest, const int depthFunc)
+{
+	if (state)
+	{
+		const int enable = depthTest != 0;
+		int sent = a3demo_graphicsEnable(state, a3gfx_depth, GL_DEPTH_TEST, &state->depthTest, enable);
+		if (enable)
+		{
+			if (state->depthFunc != depthFunc)
+			{
+				glDepthFunc(depthFunc);
+				state->depthFunc = depthFunc;
+				sent = a3demo_graphicsCount(state, a3gfx_depth, 1);
+			}
+			else
+				a3demo_graphicsCount(state, a3gfx_depth, 0);
+		}
+		return sent;
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsCull(a3_DemoGraphicsState *state, const int cullFace, const int cullMode)
+{
+	if (state)
+	{
+		const int enable = cullFace != 0;
+		int sent = a3demo_graphicsEnable(state, a3gfx_cull, GL_CULL_FACE, &state->cullFace, enable);
+		if (enable)
+		{
+			if (state->cullMode != cullMode)
+			{
+				glCullFace(cullMode);
+				state->cullMode = cullMode;
+				sent = a3demo_graphicsCount(state, a3gfx_cull, 1);
+			}
+			else
+				a3demo_graphicsCount(state, a3gfx_cull, 0);
+		}
+		return sent;
+	}
+	return -1;
+}
+
+int a3demo_setGraphicsBlend(a3_DemoGraphicsState *state, const int blend, const int blendSrc, const int blendDst)
+{
+	if (state)
+	{
+		const int enable = blend != 0;
+		int sent = a3demo_graphicsEnable(state, a3gfx_blend, GL_BLEND, &state->blend, enable);
+		if (enable)
+		{
+			if (state->blendSrc != blendSrc || state->blendDst != blendDst)
+			{
+				glBlendFunc(blendSrc, blendDst);
+				state->blendSrc = blendSrc;
+				state->blendDst = blendDst;
+				sent = a3demo_graphicsCount(state, a3gfx_blend, 1);
+			}
+			else
+				a3demo_graphicsCount(state, a3gfx_blend, 0);
+		}
+		return sent;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoGraphicsState.h
+	Shadow copy of the bound GL state in front of the a3graphics calls:
+		program, texture per unit, vertex array, framebuffer, and depth,
+		cull and blend settings. Requests that match what is bound are
+		dropped before they reach the driver, and both outcomes are counted.
+*/
+
+#ifndef __ANIMAL3D_DEMOGRAPHICSSTATE_H
+#define __ANIMAL3D_DEMOGRAPHICSSTATE_H
+
+
+//-----------------------------------------------------------------------------
+// animal3D framework includes
+
+#include "animal3D/a3graphics/a3_ShaderProgram.h"
+#include "animal3D/a3graphics/a3_Texture.h"
+#include "animal3D/a3graphics/a3_VertexDrawable.h"
+#include "animal3D/a3graphics/a3_Framebuffer.h"
+#include "animal3D/a3graphics/a3_UniformBuffer.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef enum a3_DemoGraphicsStateKind	a3_DemoGraphicsStateKind;
+	typedef struct a3_DemoGraphicsState		a3_DemoGraphicsState;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// kinds of state tracked; one counter pair each
+	enum a3_DemoGraphicsStateKind
+	{
+		a3gfx_program,
+		a3gfx_texture,
+		a3gfx_vertexArray,
+		a3gfx_framebuffer,
+		a3gfx_depth,
+		a3gfx_cull,
+		a3gfx_blend,
+		a3gfx_uniformBuffer,
+
+		demoGraphicsState_kindCount
+	};
+
+
+	// limits
+	enum a3_DemoGraphicsStateMaxCounts
+	{
+		demoGraphicsState_uniformBindingMax = 8,	// uniform buffer slots tracked
+	};
+
+
+	// what is bound, as far as calls made through the cache know
+	// a binding is only trusted once the cache has made it itself: 'known'
+	//	has a bit per kind (and 'textureKnown' one per unit) for bindings,
+	//	and settings read -1 until set; until then every request goes
+	//	through
+	// depth, cull and blend values are GL enums (GL_LEQUAL, GL_BACK...)
+	// the default framebuffer is null, with its own viewport
+	struct a3_DemoGraphicsState
+	{
+		const a3_ShaderProgram *program;
+		const a3_Texture *texture[a3tex_unitMax];
+		const a3_UniformBuffer *uniformBuffer[demoGraphicsState_uniformBindingMax];
+		unsigned int uniformOffset[demoGraphicsState_uniformBindingMax];
+		unsigned int uniformSize[demoGraphicsState_uniformBindingMax];
+		const a3_VertexArrayDescriptor *vertexArray;
+		const a3_IndexBuffer *indexBuffer;			// element buffer goes with the vertex array
+		const a3_Framebuffer *framebuffer;
+		int viewport[4];							// default framebuffer: x, y, width, height
+		int depthType;								// default framebuffer: a3_FramebufferDepthType
+		int depthTest, depthFunc;
+		int cullFace, cullMode;
+		int blend, blendSrc, blendDst;
+		unsigned int known;
+		unsigned int textureKnown;
+		unsigned int uniformKnown;					// one bit per uniform buffer slot
+		unsigned int issued[demoGraphicsState_kindCount];	// calls sent to GL
+		unsigned int skipped[demoGraphicsState_kindCount];	// calls dropped because nothing would change
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// forget what is bound (e.g. after code outside the cache touched GL);
+	//	counters are kept
+	int a3demo_invalidateGraphicsState(a3_DemoGraphicsState *state);
+
+	// zero the counters, e.g. once per frame
+	int a3demo_resetGraphicsStateStats(a3_DemoGraphicsState *state);
+
+	// total calls sent and dropped over every kind
+	unsigned int a3demo_getGraphicsStateIssued(const a3_DemoGraphicsState *state);
+	unsigned int a3demo_getGraphicsStateSkipped(const a3_DemoGraphicsState *state);
+
+	// bind a program; null deactivates
+	//	each set function returns 1 if GL was called, 0 if skipped
+	int a3demo_setGraphicsProgram(a3_DemoGraphicsState *state, const a3_ShaderProgram *program);
+
+	// bind a texture to a unit; null deactivates the unit
+	int a3demo_setGraphicsTexture(a3_DemoGraphicsState *state, const a3_Texture *texture, const a3_TextureUnit unit);
+
+	// forget a unit after binding to it some other way (e.g. a framebuffer
+	//	target)
+	int a3demo_forgetGraphicsTexture(a3_DemoGraphicsState *state, const a3_TextureUnit unit);
+
+	// bind a range of a uniform buffer to a slot; blocks bound to the slot
+	//	read from 'offset', which must be a multiple of the driver's
+	//	alignment (see a3_DemoUniformStream)
+	int a3demo_setGraphicsUniformRange(a3_DemoGraphicsState *state, const a3_UniformBuffer *buffer, const unsigned int binding, const unsigned int offset, const unsigned int size);
+
+	// bind a drawable's vertex array and element buffer; drawables that
+	//	share both (e.g. meshes in one split buffer) do not rebind
+	int a3demo_setGraphicsDrawable(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable);
+
+	// bind a drawable as above and draw it; the draw call is issued here
+	//	from the drawable's own range, so it does not depend on which
+	//	drawable a3graphics last activated
+	//	returns 1 if drawn
+	int a3demo_drawGraphicsDrawable(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable);
+
+	// same, drawing 'instanceCount' copies in one call
+	//	returns 1 if drawn, 0 if the count is zero
+	int a3demo_drawGraphicsDrawableInstanced(a3_DemoGraphicsState *state, const a3_VertexDrawable *drawable, const unsigned int instanceCount);
+
+	// bind a framebuffer, or the default one with a viewport; switching
+	//	framebuffers may change depth state, so depth is forgotten
+	int a3demo_setGraphicsFramebuffer(a3_DemoGraphicsState *state, const a3_Framebuffer *framebuffer);
+	int a3demo_setGraphicsDefaultFramebuffer(a3_DemoGraphicsState *state, const a3_FramebufferDepthType depthType, const int x, const int y, const unsigned int width, const unsigned int height);
+
+	// fixed-function settings; the function or face is left alone while
+	//	the test is disabled
+	int a3demo_setGraphicsDepth(a3_DemoGraphicsState *state, const int depthTest, const int depthFunc);
+	int a3demo_setGraphicsCull(a3_DemoGraphicsState *state, const int cullFace, const int cullMode);
+	int a3demo_setGraphicsBlend(a3_DemoGraphicsState *state, const int blend, const int blendSrc, const int blendDst);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOGRAPHICSSTATE_H
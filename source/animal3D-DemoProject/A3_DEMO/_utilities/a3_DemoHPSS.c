@@ -0,0 +1,287 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoHPSS.c
+	Harmonic/percussive separation implementation.
+*/
+
+#include "a3_DemoHPSS.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// heap positions: 0 is the median, 1, 2, 3... the min-heap of the upper
+//	half (children of i at 2i and 2i+1), -1, -2, -3... the max-heap of the
+//	lower half (children of i at 2i and 2i-1); parent is i / 2 either way
+
+#define a3demo_medianAt(median, i)	((median)->value[(median)->heap[i]])
+
+// swap two heap positions and keep the ring's back references
+void a3demo_medianSwap(a3_DemoSlidingMedian *median, const int i, const int j)
+{
+	const unsigned char t = median->heap[i];
+	median->heap[i] = median->heap[j];
+	median->heap[j] = t;
+	median->pos[median->heap[i]] = (signed char)i;
+	median->pos[median->heap[j]] = (signed char)j;
+}
+
+// move the value at i toward the top of the upper heap (through the median)
+//	returns 1 if it became the median
+int a3demo_medianUpperUp(a3_DemoSlidingMedian *median, int i)
+{
+	while (i > 0 && a3demo_medianAt(median, i) < a3demo_medianAt(median, i / 2))
+	{
+		a3demo_medianSwap(median, i, i / 2);
+		i /= 2;
+	}
+	return i == 0;
+}
+
+int a3demo_medianLowerUp(a3_DemoSlidingMedian *median, int i)
+{
+	while (i < 0 && a3demo_medianAt(median, i / 2) < a3demo_medianAt(median, i))
+	{
+		a3demo_medianSwap(median, i, i / 2);
+		i /= 2;
+	}
+	return i == 0;
+}
+
+// move the value at i (or the median) down into the upper heap
+void a3demo_medianUpperDown(a3_DemoSlidingMedian *median, int i)
+{
+	const int last = (int)median->size / 2;
+	int c;
+	for (c = i ? 2 * i : 1; c <= last; c = 2 * i)
+	{
+		if (i && c < last && a3demo_medianAt(median, c + 1) < a3demo_medianAt(median, c))
+			++c;
+		if (!(a3demo_medianAt(median, c) < a3demo_medianAt(median, i)))
+			break;
+		a3demo_medianSwap(median, i, c);
+		i = c;
+	}
+}
+
+void a3demo_medianLowerDown(a3_DemoSlidingMedian *median, int i)
+{
+	const int last = -(int)median->size / 2;
+	int c;
+	for (c = i ? 2 * i : -1; c >= last; c = 2 * i)
+	{
+		if (i && c > last && a3demo_medianAt(median, c) < a3demo_medianAt(median, c - 1))
+			--c;
+		if (!(a3demo_medianAt(median, i) < a3demo_medianAt(median, c)))
+			break;
+		a3demo_medianSwap(median, i, c);
+		i = c;
+	}
+}
+
+
+// point a median's arrays at storage and size it
+void a3demo_medianPlace(a3_DemoSlidingMedian *median, float *value, signed char *pos, unsigned char *heap, const unsigned int size)
+{
+	median->value = value;
+	median->pos = pos;
+	median->heap = heap + size / 2;
+	median->size = size;
+	median->next = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_resetSlidingMedian(a3_DemoSlidingMedian *median, const float value)
+{
+	if (median && median->value)
+	{
+		// equal values satisfy both heaps in any order; alternate slots
+		//	between the halves so the ring order does not matter
+		int i, p;
+		for (i = 0; i < (int)median->size; ++i)
+		{
+			p = (i + 1) / 2;
+			p = (i & 1) ? -p : p;
+			median->value[i] = value;
+			median->pos[i] = (signed char)p;
+			median->heap[p] = (unsigned char)i;
+		}
+		median->next = 0;
+		return 1;
+	}
+	return -1;
+}
+
+float a3demo_pushSlidingMedian(a3_DemoSlidingMedian *median, const float value)
+{
+	const unsigned int slot = median->next;
+	const int p = median->pos[slot];
+	const float old = median->value[slot];
+
+	median->value[slot] = value;
+	median->next = slot + 1 < median->size ? slot + 1 : 0;
+
+	// the new value only has to move within the half it landed in, unless
+	//	it crosses the median, in which case the median moves to the
+	//	other half
+	if (p > 0)
+	{
+		if (old < value)
+			a3demo_medianUpperDown(median, p);
+		else if (a3demo_medianUpperUp(median, p))
+			a3demo_medianLowerDown(median, 0);
+	}
+	else if (p < 0)
+	{
+		if (value < old)
+			a3demo_medianLowerDown(median, p);
+		else if (a3demo_medianLowerUp(median, p))
+			a3demo_medianUpperDown(median, 0);
+	}
+	else
+	{
+		a3demo_medianLowerDown(median, 0);
+		a3demo_medianUpperDown(median, 0);
+	}
+	return a3demo_medianAt(median, 0);
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createHPSS(a3_DemoHPSS *hpss_out, const unsigned int bins, const unsigned int harmonicSize, const unsigned int percussiveSize)
+{
+	if (hpss_out && bins && harmonicSize && percussiveSize)
+	{
+		if (!hpss_out->block)
+		{
+			// odd windows have a middle value
+			const unsigned int h = (harmonicSize | 1) < demoHPSS_windowMax ? (harmonicSize | 1) : demoHPSS_windowMax;
+			const unsigned int p = (percussiveSize | 1) < demoHPSS_windowMax ? (percussiveSize | 1) : demoHPSS_windowMax;
+			const size_t slots = (size_t)bins * h + p;
+			const size_t medianSize = sizeof(a3_DemoSlidingMedian) * bins;
+			const size_t valueSize = sizeof(float) * (slots + bins + bins);
+			char *block = (char *)malloc(medianSize + valueSize + slots + slots);
+			float *value;
+			signed char *pos;
+			unsigned char *heap;
+			unsigned int i;
+
+			if (block)
+			{
+				hpss_out->block = block;
+				hpss_out->harmonicMedian = (a3_DemoSlidingMedian *)block;
+				value = (float *)(block + medianSize);
+				hpss_out->harmonic = value + slots;
+				hpss_out->percussive = hpss_out->harmonic + bins;
+				pos = (signed char *)(block + medianSize + valueSize);
+				heap = (unsigned char *)(pos + slots);
+
+				for (i = 0; i < bins; ++i, value += h, pos += h, heap += h)
+				{
+					a3demo_medianPlace(hpss_out->harmonicMedian + i, value, pos, heap, h);
+					a3demo_resetSlidingMedian(hpss_out->harmonicMedian + i, 0.0f);
+				}
+				a3demo_medianPlace(hpss_out->percussiveMedian, value, pos, heap, p);
+
+				hpss_out->bins = bins;
+				hpss_out->harmonicSize = h;
+				hpss_out->percussiveSize = p;
+				memset(hpss_out->harmonic, 0, sizeof(float) * (bins + bins));
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseHPSS(a3_DemoHPSS *hpss)
+{
+	if (hpss)
+	{
+		if (hpss->block)
+		{
+			free(hpss->block);
+			memset(hpss, 0, sizeof(a3_DemoHPSS));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_separateHPSS(a3_DemoHPSS *hpss, const float *spectrum)
+{
+	if (hpss && hpss->block && spectrum)
+	{
+		a3_DemoSlidingMedian *const across = hpss->percussiveMedian;
+		const unsigned int bins = hpss->bins, half = hpss->percussiveSize / 2;
+		float *const harmonic = hpss->harmonic, *const percussive = hpss->percussive;
+		float h, p, x, sum;
+		unsigned int i;
+
+		// harmonic estimate: each bin's median over time
+		for (i = 0; i < bins; ++i)
+			harmonic[i] = a3demo_pushSlidingMedian(hpss->harmonicMedian + i, spectrum[i]);
+
+		// percussive estimate: median over the bins around each one; the
+		//	window is slid along, so it runs half a window ahead of the bin
+		//	being estimated and past the ends it sees zeros
+		a3demo_resetSlidingMedian(across, 0.0f);
+		for (i = 0; i < half; ++i)
+			a3demo_pushSlidingMedian(across, i < bins ? spectrum[i] : 0.0f);
+		for (i = 0; i < bins; ++i)
+			percussive[i] = a3demo_pushSlidingMedian(across, i + half < bins ? spectrum[i + half] : 0.0f);
+
+		// soft (Wiener) masks: each part gets the share of power its
+		//	estimate claims
+		for (i = 0; i < bins; ++i)
+		{
+			h = harmonic[i] * harmonic[i];
+			p = percussive[i] * percussive[i];
+			sum = h + p;
+			x = spectrum[i];
+			if (sum > 0.0f)
+			{
+				harmonic[i] = x * h / sum;
+				percussive[i] = x * p / sum;
+			}
+			else
+			{
+				harmonic[i] = 0.5f * x;
+				percussive[i] = 0.5f * x;
+			}
+		}
+		return (int)bins;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
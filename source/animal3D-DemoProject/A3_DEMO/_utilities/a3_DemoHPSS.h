@@ -0,0 +1,116 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoHPSS.h
+	Streaming harmonic/percussive separation: median filtering of the
+		spectrogram along time (sustained, tonal energy) and along
+		frequency (broadband hits), using sliding medians that update in
+		O(log n) per value instead of re-sorting.
+*/
+
+#ifndef __ANIMAL3D_DEMOHPSS_H
+#define __ANIMAL3D_DEMOHPSS_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSlidingMedian		a3_DemoSlidingMedian;
+	typedef struct a3_DemoHPSS				a3_DemoHPSS;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// limits
+	enum a3_DemoHPSSMaxCounts
+	{
+		demoHPSS_windowMax = 255,				// longest median window (odd)
+	};
+
+
+	// median of the last 'size' values pushed (size odd)
+	// values sit in a ring; a max-heap of the lower half and a min-heap of
+	//	the upper half share one array with the median between them, and
+	//	every ring slot knows where it is in the heaps, so replacing the
+	//	oldest value only moves it up or down its heap
+	struct a3_DemoSlidingMedian
+	{
+		float *value;							// ring of values [size]
+		signed char *pos;						// heap position of each ring slot, 0 is the median [size]
+		unsigned char *heap;					// ring slot at each heap position, centered on the median [size]
+		unsigned int size;
+		unsigned int next;						// ring slot replaced by the next push
+	};
+
+
+	// harmonic/percussive separator
+	// harmonic estimate is each bin's median over the last harmonicSize
+	//	hops; percussive estimate is each hop's median over percussiveSize
+	//	neighboring bins; soft masks built from the two split the spectrum
+	// all storage lives in one block allocated on create; separating does
+	//	not allocate
+	struct a3_DemoHPSS
+	{
+		a3_DemoSlidingMedian *harmonicMedian;	// one per bin [bins]
+		a3_DemoSlidingMedian percussiveMedian[1];	// slid across the bins every hop
+		float *harmonic;						// harmonic part of the latest spectrum [bins]
+		float *percussive;						// percussive part of the latest spectrum [bins]
+		void *block;							// single allocation for all of the above
+		unsigned int bins;
+		unsigned int harmonicSize;				// hops
+		unsigned int percussiveSize;			// bins
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// fill a sliding median's window with one value
+	int a3demo_resetSlidingMedian(a3_DemoSlidingMedian *median, const float value);
+
+	// replace the oldest value with a new one
+	//	returns the median of the window
+	float a3demo_pushSlidingMedian(a3_DemoSlidingMedian *median, const float value);
+
+
+	// create and release separator for spectra of 'bins' values
+	//	window sizes are rounded up to odd and limited to windowMax
+	int a3demo_createHPSS(a3_DemoHPSS *hpss_out, const unsigned int bins, const unsigned int harmonicSize, const unsigned int percussiveSize);
+	int a3demo_releaseHPSS(a3_DemoHPSS *hpss);
+
+	// split one hop's magnitude spectrum into 'harmonic' and 'percussive',
+	//	which add up to it; the harmonic estimate lags by about half its
+	//	window, the percussive one does not lag
+	//	returns number of bins written
+	int a3demo_separateHPSS(a3_DemoHPSS *hpss, const float *spectrum);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOHPSS_H
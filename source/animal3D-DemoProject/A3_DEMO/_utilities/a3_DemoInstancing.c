@@ -0,0 +1,161 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoInstancing.c
+	Instanced drawing implementation.
+*/
+
+#include "a3_DemoInstancing.h"
+
+#include "animal3D/a3graphics/a3_VertexDrawable.h"
+
+
+// OpenGL
+#ifdef _WIN32
+#include <Windows.h>
+#include <GL/glew.h>
+#else	// !_WIN32
+#include <OpenGL/gl3.h>
+#endif	// _WIN32
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createInstanceBatch(a3_DemoInstanceBatch *batch_out, const unsigned int capacity)
+{
+	if (batch_out && !batch_out->block && capacity)
+	{
+		batch_out->block = malloc(sizeof(a3_DemoInstance) * capacity);
+		if (batch_out->block)
+		{
+			batch_out->instance = (a3_DemoInstance *)batch_out->block;
+			batch_out->count = 0;
+			batch_out->capacity = capacity;
+			memset(batch_out->instance, 0, sizeof(a3_DemoInstance) * capacity);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseInstanceBatch(a3_DemoInstanceBatch *batch)
+{
+	if (batch && batch->block)
+	{
+		free(batch->block);
+		memset(batch, 0, sizeof(*batch));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_resetInstanceBatch(a3_DemoInstanceBatch *batch)
+{
+	if (batch && batch->block)
+	{
+		batch->count = 0;
+		return 1;
+	}
+	return -1;
+}
+
+a3_DemoInstance *a3demo_pushInstance(a3_DemoInstanceBatch *batch)
+{
+	if (batch && batch->block && batch->count < batch->capacity)
+		return (batch->instance + batch->count++);
+	return 0;
+}
+
+int a3demo_createInstanceBuffer(a3_VertexBuffer *buffer_out, const a3_DemoInstanceBatch *batch)
+{
+	if (buffer_out && batch && batch->block)
+	{
+		const unsigned int size = sizeof(a3_DemoInstance) * batch->capacity;
+		if (a3bufferCreate(buffer_out, a3buffer_vertex, size, 0) > 0)
+		{
+			// respecify as streamed; contents change every frame
+			glBindBuffer(GL_ARRAY_BUFFER, buffer_out->handle->handle);
+			glBufferData(GL_ARRAY_BUFFER, size, 0, GL_STREAM_DRAW);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_attachInstanceBuffer(const a3_VertexArrayDescriptor *vertexArray, const a3_VertexBuffer *buffer)
+{
+	if (vertexArray && vertexArray->handle->handle && buffer && buffer->handle->handle)
+	{
+		const GLsizei stride = sizeof(a3_DemoInstance);
+		unsigned int i;
+
+		glBindVertexArray(vertexArray->handle->handle);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer->handle->handle);
+
+		// a mat4 attribute is four vec4 columns in consecutive locations
+		for (i = 0; i < 4; ++i)
+		{
+			glEnableVertexAttribArray(a3instance_modelMat + i);
+			glVertexAttribPointer(a3instance_modelMat + i, 4, GL_FLOAT, GL_FALSE, stride, (void *)(offsetof(a3_DemoInstance, modelMat) + sizeof(a3vec4) * i));
+			glVertexAttribDivisor(a3instance_modelMat + i, 1);
+		}
+		glEnableVertexAttribArray(a3instance_color);
+		glVertexAttribPointer(a3instance_color, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(a3_DemoInstance, color));
+		glVertexAttribDivisor(a3instance_color, 1);
+		glEnableVertexAttribArray(a3instance_audio);
+		glVertexAttribPointer(a3instance_audio, 4, GL_FLOAT, GL_FALSE, stride, (void *)offsetof(a3_DemoInstance, phase));
+		glVertexAttribDivisor(a3instance_audio, 1);
+
+		// the array's own buffers stay as they were; leave nothing bound 
+		//	and tell the framework so, or it may skip its next activation
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+		a3vertexDeactivateDrawable();
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_uploadInstanceBatch(const a3_DemoInstanceBatch *batch, a3_VertexBuffer *buffer)
+{
+	if (batch && batch->block && buffer && buffer->handle->handle && sizeof(a3_DemoInstance) * batch->capacity <= buffer->size)
+	{
+		if (batch->count)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, buffer->handle->handle);
+			glBufferData(GL_ARRAY_BUFFER, buffer->size, 0, GL_STREAM_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(a3_DemoInstance) * batch->count, batch->instance);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		return (int)batch->count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
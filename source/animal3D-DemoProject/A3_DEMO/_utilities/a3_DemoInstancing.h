@@ -0,0 +1,124 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoInstancing.h
+	Instanced drawing: per-instance transform, color and audio response
+		are staged each frame and streamed into a vertex buffer read with
+		attribute divisors, so many copies of one drawable take one call.
+*/
+
+#ifndef __ANIMAL3D_DEMOINSTANCING_H
+#define __ANIMAL3D_DEMOINSTANCING_H
+
+
+//-----------------------------------------------------------------------------
+// animal3D framework includes
+
+#include "animal3D/a3graphics/a3_VertexBuffer.h"
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoInstance			a3_DemoInstance;
+	typedef struct a3_DemoInstanceBatch		a3_DemoInstanceBatch;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// attribute locations the instance data is read from; chosen from
+	//	slots the tangent basis format leaves empty:
+	//
+	//	layout (location = 3) in vec4 aInstanceColor;
+	//	layout (location = 4) in vec4 aInstanceAudio;
+	//	layout (location = 12) in mat4 aInstanceModelMat;	// 12 to 15
+	enum a3_DemoInstanceAttribute
+	{
+		a3instance_color = a3attrib_color,
+		a3instance_audio = a3attrib_colorSecondary,
+		a3instance_modelMat = a3attrib_texcoord4,		// one location per column
+	};
+
+
+	// one instance, as laid out in the vertex buffer
+	struct a3_DemoInstance
+	{
+		a3mat4 modelMat;
+		a3vec4 color;
+		float phase;								// offset into the beat, 0 to 1
+		float band;									// audio band it follows, 0 to bandCount - 1
+		float amount;								// how far it moves with the music
+		float reserved;
+	};
+
+	// instances staged for one frame
+	// storage lives in one block allocated on create; pushing does not
+	//	allocate
+	struct a3_DemoInstanceBatch
+	{
+		a3_DemoInstance *instance;					// staged instances [capacity]
+		void *block;
+		unsigned int count, capacity;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create and release staging for 'capacity' instances
+	int a3demo_createInstanceBatch(a3_DemoInstanceBatch *batch_out, const unsigned int capacity);
+	int a3demo_releaseInstanceBatch(a3_DemoInstanceBatch *batch);
+
+	// start a new frame
+	int a3demo_resetInstanceBatch(a3_DemoInstanceBatch *batch);
+
+	// next instance to fill, null if full
+	a3_DemoInstance *a3demo_pushInstance(a3_DemoInstanceBatch *batch);
+
+	// create a vertex buffer that holds a full batch and is respecified
+	//	every frame
+	int a3demo_createInstanceBuffer(a3_VertexBuffer *buffer_out, const a3_DemoInstanceBatch *batch);
+
+	// read a vertex array's instance attributes from a buffer, advancing
+	//	once per instance; programs that do not declare them, and drawing
+	//	without instancing, are not affected
+	//	call once after both are created
+	int a3demo_attachInstanceBuffer(const a3_VertexArrayDescriptor *vertexArray, const a3_VertexBuffer *buffer);
+
+	// send staged instances to a buffer made for the batch; the old
+	//	contents are orphaned so the driver does not wait on draws that
+	//	still read them
+	//	returns number of instances uploaded
+	int a3demo_uploadInstanceBatch(const a3_DemoInstanceBatch *batch, a3_VertexBuffer *buffer);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOINSTANCING_H
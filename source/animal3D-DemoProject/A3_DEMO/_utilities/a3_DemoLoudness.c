@@ -0,0 +1,222 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoLoudness.c
+	Loudness meter implementation.
+*/
+
+#include "a3_DemoLoudness.h"
+
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// gating and display limits
+#define a3demo_loudnessGateAbsolute		-70.0f
+#define a3demo_loudnessGateRelative		-10.0f
+#define a3demo_loudnessBinWidth			0.25f
+
+// loudness of a mean square, floored at the absolute gate
+float a3demo_loudnessOf(const double power)
+{
+	const double lufs = power > 0.0 ? -0.691 + 10.0 * log10(power) : a3demo_loudnessGateAbsolute;
+	return lufs > a3demo_loudnessGateAbsolute ? (float)lufs : a3demo_loudnessGateAbsolute;
+}
+
+// mean square of a histogram bin's center
+double a3demo_loudnessBinPower(const unsigned int bin)
+{
+	const double lufs = a3demo_loudnessGateAbsolute + a3demo_loudnessBinWidth * ((double)bin + 0.5);
+	return pow(10.0, (lufs + 0.691) * 0.1);
+}
+
+
+// K-weighting stages; analog prototypes from BS.1770 taken through the
+//	bilinear transform, so any sample rate gets the same curve
+void a3demo_loudnessShelf(a3_DemoBiquad *shelf, const double sampleRate)
+{
+	const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+	const double k = tan(3.14159265358979323846 * f0 / sampleRate);
+	const double vh = pow(10.0, gainDb / 20.0), vb = pow(vh, 0.4996667741545416);
+	const double a0 = 1.0 + k / q + k * k;
+	shelf->b0 = (vh + vb * k / q + k * k) / a0;
+	shelf->b1 = 2.0 * (k * k - vh) / a0;
+	shelf->b2 = (vh - vb * k / q + k * k) / a0;
+	shelf->a1 = 2.0 * (k * k - 1.0) / a0;
+	shelf->a2 = (1.0 - k / q + k * k) / a0;
+}
+
+void a3demo_loudnessHighpass(a3_DemoBiquad *highpass, const double sampleRate)
+{
+	const double f0 = 38.13547087602444, q = 0.5003270373238773;
+	const double k = tan(3.14159265358979323846 * f0 / sampleRate);
+	const double a0 = 1.0 + k / q + k * k;
+	highpass->b0 = 1.0;
+	highpass->b1 = -2.0;
+	highpass->b2 = 1.0;
+	highpass->a1 = 2.0 * (k * k - 1.0) / a0;
+	highpass->a2 = (1.0 - k / q + k * k) / a0;
+}
+
+// run one channel's sample through a section
+double a3demo_loudnessBiquad(a3_DemoBiquad *biquad, const unsigned int channel, const double x)
+{
+	const double y = biquad->b0 * x + biquad->z1[channel];
+	biquad->z1[channel] = biquad->b1 * x - biquad->a1 * y + biquad->z2[channel];
+	biquad->z2[channel] = biquad->b2 * x - biquad->a2 * y;
+	return y;
+}
+
+
+// a 100 ms sub-block is done: slide both windows, gate the 400 ms block
+//	ending here, refresh the outputs and the gain
+void a3demo_loudnessBlock(a3_DemoLoudnessMeter *meter)
+{
+	const unsigned int slot = meter->blockCount % demoLoudness_shortTermBlocks;
+	const double power = meter->blockSum / (double)meter->blockSize;
+	double *const blockPower = meter->blockPower;
+	double sum, count, threshold;
+	float reference, gainDb, errorDb;
+	unsigned int i, first;
+
+	// ring holds zeros until it fills, which reads as silence
+	meter->shortTermSum += power - blockPower[slot];
+	meter->momentarySum += power - blockPower[(slot + demoLoudness_shortTermBlocks - demoLoudness_momentaryBlocks) % demoLoudness_shortTermBlocks];
+	blockPower[slot] = power;
+	meter->blockSum = 0.0;
+	meter->blockFill = 0;
+	++meter->blockCount;
+
+	// running sums drift; start them over once per lap of the ring
+	if (slot == demoLoudness_shortTermBlocks - 1)
+	{
+		for (i = 0, sum = 0.0; i < demoLoudness_shortTermBlocks; ++i)
+			sum += blockPower[i];
+		meter->shortTermSum = sum;
+		for (i = 0, sum = 0.0; i < demoLoudness_momentaryBlocks; ++i)
+			sum += blockPower[demoLoudness_shortTermBlocks - 1 - i];
+		meter->momentarySum = sum;
+	}
+	meter->momentary = a3demo_loudnessOf(meter->momentarySum / (double)demoLoudness_momentaryBlocks);
+	meter->shortTerm = a3demo_loudnessOf(meter->shortTermSum / (double)demoLoudness_shortTermBlocks);
+
+	// momentary windows are the gating blocks (400 ms, 75% overlap)
+	if (meter->blockCount >= demoLoudness_momentaryBlocks && meter->momentary > a3demo_loudnessGateAbsolute)
+	{
+		i = (unsigned int)((meter->momentary - a3demo_loudnessGateAbsolute) / a3demo_loudnessBinWidth);
+		++meter->histogram[i < demoLoudness_histogramBins ? i : demoLoudness_histogramBins - 1];
+		++meter->gatedCount;
+	}
+
+	// integrated: mean of blocks above the absolute gate sets the relative
+	//	gate, then mean of blocks above that
+	if (meter->gatedCount)
+	{
+		for (i = 0, sum = count = 0.0; i < demoLoudness_histogramBins; ++i)
+			if (meter->histogram[i])
+			{
+				sum += (double)meter->histogram[i] * a3demo_loudnessBinPower(i);
+				count += (double)meter->histogram[i];
+			}
+		threshold = a3demo_loudnessOf(sum / count) + a3demo_loudnessGateRelative;
+		first = threshold > a3demo_loudnessGateAbsolute ? (unsigned int)((threshold - a3demo_loudnessGateAbsolute) / a3demo_loudnessBinWidth) : 0;
+		for (i = first, sum = count = 0.0; i < demoLoudness_histogramBins; ++i)
+			if (meter->histogram[i])
+			{
+				sum += (double)meter->histogram[i] * a3demo_loudnessBinPower(i);
+				count += (double)meter->histogram[i];
+			}
+		meter->integrated = count > 0.0 ? a3demo_loudnessOf(sum / count) : a3demo_loudnessGateAbsolute;
+	}
+
+	// gain follows the integrated loudness once it has a few seconds to go
+	//	on, short-term before that; silence leaves it where it is
+	reference = meter->gatedCount >= demoLoudness_shortTermBlocks ? meter->integrated : meter->shortTerm;
+	if (reference > a3demo_loudnessGateAbsolute)
+	{
+		gainDb = 20.0f * log10f(meter->gain);
+		errorDb = meter->target - reference - gainDb;
+		gainDb += meter->gainRate * errorDb;
+		meter->gain = powf(10.0f, gainDb * 0.05f);
+		if (meter->gain < meter->gainMin)
+			meter->gain = meter->gainMin;
+		else if (meter->gain > meter->gainMax)
+			meter->gain = meter->gainMax;
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_initLoudnessMeter(a3_DemoLoudnessMeter *meter_out, const float sampleRate, const unsigned int channelCount)
+{
+	if (meter_out && sampleRate >= 1000.0f && channelCount && channelCount <= demoLoudness_channelMax)
+	{
+		memset(meter_out, 0, sizeof(a3_DemoLoudnessMeter));
+		meter_out->target = -14.0f;
+		meter_out->gainMin = 0.1f;
+		meter_out->gainMax = 10.0f;
+		meter_out->gainRate = 0.05f;
+		a3demo_loudnessShelf(meter_out->shelf, (double)sampleRate);
+		a3demo_loudnessHighpass(meter_out->highpass, (double)sampleRate);
+		meter_out->channelCount = channelCount;
+		meter_out->blockSize = (unsigned int)(sampleRate * 0.1f + 0.5f);
+		meter_out->momentary = meter_out->shortTerm = meter_out->integrated = a3demo_loudnessGateAbsolute;
+		meter_out->gain = 1.0f;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_updateLoudnessMeter(a3_DemoLoudnessMeter *meter, const float *left, const float *right, const unsigned int count)
+{
+	if (meter && meter->blockSize && left && (right || meter->channelCount == 1))
+	{
+		a3_DemoBiquad *const shelf = meter->shelf, *const highpass = meter->highpass;
+		const unsigned int blockCount = meter->blockCount;
+		double y, sum = meter->blockSum;
+		unsigned int i;
+
+		for (i = 0; i < count; ++i)
+		{
+			y = a3demo_loudnessBiquad(highpass, 0, a3demo_loudnessBiquad(shelf, 0, (double)left[i]));
+			sum += y * y;
+			if (meter->channelCount > 1)
+			{
+				y = a3demo_loudnessBiquad(highpass, 1, a3demo_loudnessBiquad(shelf, 1, (double)right[i]));
+				sum += y * y;
+			}
+			if (++meter->blockFill == meter->blockSize)
+			{
+				meter->blockSum = sum;
+				a3demo_loudnessBlock(meter);
+				sum = 0.0;
+			}
+		}
+		meter->blockSum = sum;
+		return (int)(meter->blockCount - blockCount);
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoLoudness.h
+	Streaming loudness meter after ITU-R BS.1770 / EBU R128 (K-weighting,
+		momentary, short-term and gated integrated loudness) and the
+		automatic gain that brings any track to the same visual level.
+*/
+
+#ifndef __ANIMAL3D_DEMOLOUDNESS_H
+#define __ANIMAL3D_DEMOLOUDNESS_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoBiquad			a3_DemoBiquad;
+	typedef struct a3_DemoLoudnessMeter		a3_DemoLoudnessMeter;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// fixed storage sizes; nothing is allocated
+	enum a3_DemoLoudnessMaxCounts
+	{
+		demoLoudness_channelMax = 2,
+		demoLoudness_momentaryBlocks = 4,		// 100 ms sub-blocks in the 400 ms momentary window
+		demoLoudness_shortTermBlocks = 30,		// 100 ms sub-blocks in the 3 s short-term window
+		demoLoudness_histogramBins = 300,		// quarter-LU bins from the absolute gate up to +5 LUFS
+	};
+
+
+	// second order section, transposed direct form II
+	struct a3_DemoBiquad
+	{
+		double b0, b1, b2, a1, a2;
+		double z1[demoLoudness_channelMax], z2[demoLoudness_channelMax];
+	};
+
+
+	// loudness meter
+	// one per analysis thread; feed it every sample once, in order
+	// sample filtering aside, work per 100 ms block is constant: windows
+	//	are running sums and gating uses a fixed histogram
+	struct a3_DemoLoudnessMeter
+	{
+		// settings
+		float target;									// LUFS the gain aims for
+		float gainMin, gainMax;							// gain limits, linear
+		float gainRate;									// share of the gain error (in dB) corrected per block
+
+		// K-weighting
+		a3_DemoBiquad shelf[1];							// head effects: +4 dB above 1.5 kHz
+		a3_DemoBiquad highpass[1];						// RLB curve: roll off below 38 Hz
+		unsigned int channelCount;
+
+		// 100 ms sub-blocks
+		unsigned int blockSize;							// samples per sub-block
+		unsigned int blockFill;							// samples in the current one
+		double blockSum;								// weighted squares in the current one, all channels
+		double blockPower[demoLoudness_shortTermBlocks];	// mean square of recent sub-blocks, ring
+		double momentarySum, shortTermSum;				// running sums over the two windows
+		unsigned int blockCount;						// sub-blocks completed
+
+		// gating: 400 ms blocks every 100 ms, binned by loudness
+		unsigned int histogram[demoLoudness_histogramBins];
+		unsigned int gatedCount;						// blocks above the absolute gate
+
+		// outputs, LUFS (-70 when too quiet to measure)
+		float momentary;
+		float shortTerm;
+		float integrated;
+		float gain;										// multiply linear magnitudes by this
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// reset meter for a sample rate and 1 or 2 channels
+	int a3demo_initLoudnessMeter(a3_DemoLoudnessMeter *meter_out, const float sampleRate, const unsigned int channelCount);
+
+	// feed 'count' samples per channel (right is ignored for one channel)
+	//	returns the number of 100 ms blocks completed
+	int a3demo_updateLoudnessMeter(a3_DemoLoudnessMeter *meter, const float *left, const float *right, const unsigned int count);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOLOUDNESS_H
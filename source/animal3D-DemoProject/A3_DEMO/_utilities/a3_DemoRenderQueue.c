@@ -0,0 +1,322 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRenderQueue.c
+	Render queue implementation.
+*/
+
+#include "a3_DemoRenderQueue.h"
+
+
+// OpenGL
+#ifdef _WIN32
+#include <Windows.h>
+#include <GL/glew.h>
+#else	// !_WIN32
+#include <OpenGL/gl3.h>
+#endif	// _WIN32
+
+
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// key fields, from the top bit down
+#define a3demo_renderKeyField(value, bits, shift)	((unsigned long long)((value) & ((1u << (bits)) - 1u)) << (shift))
+
+
+int a3demo_resetRenderQueue(a3_DemoRenderQueue *queue)
+{
+	if (queue)
+	{
+		queue->count = 0;
+		queue->batchCount = 0;
+		queue->sorted = 1;
+		return 1;
+	}
+	return -1;
+}
+
+a3_DemoRenderPacket *a3demo_pushRenderPacket(a3_DemoRenderQueue *queue, const unsigned int layer, const float depth, const a3_DemoStateShaderProgram *program, const a3_VertexDrawable *drawable, const a3_Texture *texture0_opt, const a3_Texture *texture1_opt)
+{
+	if (queue && queue->count < demoRenderQueue_packetMax && layer < demoRenderQueue_layerMax &&
+		program && drawable && drawable->vertexArray)
+	{
+		const unsigned int index = queue->count++;
+		a3_DemoRenderPacket *const packet = queue->packet + index;
+
+		// NaN goes to the front
+		const float d = !(depth > 0.0f) ? 0.0f : depth < 1.0f ? depth : 1.0f;
+
+		queue->key[index] =
+			a3demo_renderKeyField(layer, 4, 60) |
+			a3demo_renderKeyField(program->program->handle->handle, 12, 48) |
+			a3demo_renderKeyField(drawable->vertexArray->handle->handle, 12, 36) |
+			a3demo_renderKeyField(texture0_opt ? texture0_opt->handle->handle : 0, 10, 26) |
+			a3demo_renderKeyField(texture1_opt ? texture1_opt->handle->handle : 0, 10, 16) |
+			a3demo_renderKeyField((unsigned int)(d * 65535.0f), 16, 0);
+		queue->sorted = 0;
+
+		packet->program = program;
+		packet->drawable = drawable;
+		packet->texture[0] = texture0_opt;
+		packet->texture[1] = texture1_opt;
+		return packet;
+	}
+	return 0;
+}
+
+int a3demo_sortRenderQueue(a3_DemoRenderQueue *queue)
+{
+	if (queue)
+	{
+		const unsigned long long *const key = queue->key;
+		const unsigned int count = queue->count;
+		unsigned int histogram[8][256];
+		unsigned short *src = queue->order, *dst = queue->orderTemp, *swap;
+		unsigned int i, b, sum, digit;
+
+		// histograms of every key byte in one pass
+		memset(histogram, 0, sizeof(histogram));
+		for (i = 0; i < count; ++i)
+		{
+			src[i] = (unsigned short)i;
+			for (b = 0; b < 8; ++b)
+				++histogram[b][(key[i] >> (b * 8)) & 0xff];
+		}
+
+		// least significant byte first; each pass is stable, so earlier
+		//	bytes stay in order within equal later ones
+		for (b = 0; b < 8; ++b)
+		{
+			// every key has the same byte here, e.g. the layer when there
+			//	is only one: nothing to move
+			if (!count || histogram[b][(key[0] >> (b * 8)) & 0xff] == count)
+				continue;
+
+			for (digit = 0, sum = 0; digit < 256; ++digit)
+			{
+				i = histogram[b][digit];
+				histogram[b][digit] = sum;
+				sum += i;
+			}
+			for (i = 0; i < count; ++i)
+			{
+				digit = (key[src[i]] >> (b * 8)) & 0xff;
+				dst[histogram[b][digit]++] = src[i];
+			}
+			swap = src;
+			src = dst;
+			dst = swap;
+		}
+		if (src != queue->order)
+			memcpy(queue->order, src, sizeof(*src) * count);
+
+		queue->sorted = 1;
+		return (int)count;
+	}
+	return -1;
+}
+
+int a3demo_getMultiDrawIndirectSupport()
+{
+#ifdef GL_VERSION_4_3
+	GLint major = 0, minor = 0, count = 0, i;
+	const char *name;
+
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if (major > 4 || (major == 4 && minor >= 3))
+	{
+		// draw index in the shader
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (i = 0; i < count; ++i)
+		{
+			name = (const char *)glGetStringi(GL_EXTENSIONS, i);
+			if (name && !strcmp(name, "GL_ARB_shader_draw_parameters"))
+				return 1;
+		}
+	}
+#endif	// GL_VERSION_4_3
+
+	// headers or driver too old
+	return 0;
+}
+
+// packets that can share one indirect call: indexed, and needing exactly 
+//	the same state
+int a3demo_renderPacketsBatch(const a3_DemoRenderPacket *packet0, const a3_DemoRenderPacket *packet1)
+{
+	const a3_VertexDrawable *const drawable0 = packet0->drawable, *const drawable1 = packet1->drawable;
+	return (drawable0->indexBuffer && packet0->program == packet1->program &&
+		drawable0->vertexArray == drawable1->vertexArray && drawable0->indexBuffer == drawable1->indexBuffer &&
+		drawable0->primitive == drawable1->primitive && drawable0->indexType == drawable1->indexType &&
+		packet0->texture[0] == packet1->texture[0] && packet0->texture[1] == packet1->texture[1]);
+}
+
+int a3demo_stageRenderQueue(a3_DemoRenderQueue *queue, a3_DemoUniformStream *stream, const unsigned int drawMax)
+{
+	if (queue && stream && drawMax && drawMax <= demoRenderBatch_drawMax)
+	{
+		const a3_DemoRenderPacket *packet, *lead = 0;
+		const a3_VertexDrawable *drawable;
+		a3_DemoRenderBatch *batch = 0;
+		a3_DemoDrawCommand *command;
+		unsigned char *object;
+		unsigned int i, j, indexSize;
+
+		// runs and their commands, in draw order
+		queue->batchCount = 0;
+		for (i = 0; i < queue->count; ++i)
+		{
+			packet = queue->packet + (queue->sorted ? queue->order[i] : i);
+			drawable = packet->drawable;
+			if (!batch || batch->count == drawMax || !a3demo_renderPacketsBatch(lead, packet))
+			{
+				batch = queue->batch + queue->batchCount++;
+				batch->first = i;
+				batch->count = 0;
+				lead = packet;
+			}
+			++batch->count;
+
+			// index type is a GL enum; offsets into the shared index 
+			//	buffer are whole indices
+			indexSize = drawable->indexType == GL_UNSIGNED_INT ? 4 : drawable->indexType == GL_UNSIGNED_SHORT ? 2 : 1;
+			command = queue->command + i;
+			command->count = drawable->count;
+			command->instanceCount = 1;
+			command->firstIndex = (unsigned int)((size_t)drawable->indexing / indexSize);
+			command->baseVertex = 0;
+			command->baseInstance = 0;
+		}
+
+		// each run's blocks start on a bindable offset and follow each 
+		//	other as a std140 array; runs whose program does not declare 
+		//	the object block get none
+		for (j = 0; j < queue->batchCount; ++j)
+		{
+			batch = queue->batch + j;
+			batch->objectOffset = 0;
+			packet = queue->packet + (queue->sorted ? queue->order[batch->first] : batch->first);
+			if (packet->program->ubObject < 0)
+				continue;
+			object = (unsigned char *)a3demo_reserveUniformStream(stream, sizeof(a3_DemoObjectBlock) * batch->count, &batch->objectOffset);
+			if (!object)
+			{
+				queue->batchCount = 0;
+				return -1;
+			}
+			for (i = batch->first; i < batch->first + batch->count; ++i, object += sizeof(a3_DemoObjectBlock))
+				memcpy(object, &queue->packet[queue->sorted ? queue->order[i] : i].object, sizeof(a3_DemoObjectBlock));
+		}
+		return (int)queue->batchCount;
+	}
+	return -1;
+}
+
+int a3demo_drawRenderQueue(const a3_DemoRenderQueue *queue, a3_DemoGraphicsState *state, const a3_UniformBuffer *objectBuffer, const unsigned int objectBinding, a3_VertexBuffer *commandBuffer_opt, a3_DemoRenderProgramFunc programFunc_opt, const void *data, a3_DemoRenderQueueStats *stats_out_opt)
+{
+	if (queue && state && objectBuffer)
+	{
+		const unsigned int objectRange = sizeof(a3_DemoObjectBlock) * demoRenderBatch_drawMax;
+		const a3_DemoStateShaderProgram *program;
+		const a3_DemoRenderPacket *packet;
+		const a3_DemoRenderBatch *batch;
+		a3_DemoRenderQueueStats stats = { 0 };
+		const unsigned int vertexArrayIssued = state->issued[a3gfx_vertexArray];
+		unsigned int i, unit, indirect = 0, naive = 0;
+
+		// a run of several draws has one block range, so it can only be 
+		//	drawn indirectly
+		for (i = 0; i < queue->batchCount; ++i)
+			if (queue->batch[i].count > 1)
+				indirect = 1;
+		if (indirect)
+		{
+#ifdef GL_VERSION_4_3
+			if (!commandBuffer_opt || sizeof(a3_DemoDrawCommand) * queue->count > commandBuffer_opt->size)
+				return -1;
+
+			// every run's commands in one upload
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer_opt->handle->handle);
+			glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(a3_DemoDrawCommand) * queue->count, queue->command);
+#else	// !GL_VERSION_4_3
+			return -1;
+#endif	// GL_VERSION_4_3
+		}
+
+		for (i = 0; i < queue->batchCount; ++i)
+		{
+			batch = queue->batch + i;
+			packet = queue->packet + (queue->sorted ? queue->order[batch->first] : batch->first);
+			program = packet->program;
+			naive += 2 * batch->count;
+
+			if (a3demo_setGraphicsProgram(state, program->program) > 0)
+			{
+				if (programFunc_opt)
+					programFunc_opt(data, program);
+				++stats.programBinds;
+			}
+			for (unit = 0; unit < demoRenderPacket_textureCount; ++unit)
+			{
+				if (packet->texture[unit])
+				{
+					naive += batch->count;
+					if (a3demo_setGraphicsTexture(state, packet->texture[unit], (a3_TextureUnit)(a3tex_unit00 + unit)) > 0)
+						++stats.textureBinds;
+				}
+			}
+
+			if (program->ubObject >= 0)
+				a3demo_setGraphicsUniformRange(state, objectBuffer, objectBinding, batch->objectOffset, objectRange);
+			if (batch->count > 1)
+			{
+#ifdef GL_VERSION_4_3
+				a3demo_setGraphicsDrawable(state, packet->drawable);
+				glMultiDrawElementsIndirect(packet->drawable->primitive, packet->drawable->indexType,
+					(const void *)(sizeof(a3_DemoDrawCommand) * batch->first), batch->count, 0);
+#endif	// GL_VERSION_4_3
+			}
+			else
+				a3demo_drawGraphicsDrawable(state, packet->drawable);
+			stats.objects += batch->count;
+			++stats.draws;
+		}
+
+#ifdef GL_VERSION_4_3
+		if (indirect)
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+#endif	// GL_VERSION_4_3
+
+		if (stats_out_opt)
+		{
+			stats.vertexArrayBinds = state->issued[a3gfx_vertexArray] - vertexArrayIssued;
+			stats.bindsSkipped = naive - stats.programBinds - stats.textureBinds - stats.vertexArrayBinds;
+			*stats_out_opt = stats;
+		}
+		return (int)stats.objects;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,196 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoRenderQueue.h
+	Render queue: draws are submitted as packets, radix-sorted by a key
+		packed from the state they need, then issued in order so that
+		objects sharing a program, vertex array or textures bind them once.
+		Per-object uniforms are staged as blocks in draw order. Runs of
+		packets that need the same state are drawn together: one multi-
+		draw indirect call per run where the driver supports it, reading
+		each object's block by draw index, one draw each otherwise.
+*/
+
+#ifndef __ANIMAL3D_DEMORENDERQUEUE_H
+#define __ANIMAL3D_DEMORENDERQUEUE_H
+
+
+//-----------------------------------------------------------------------------
+// animal3D framework includes
+
+#include "animal3D/a3graphics/a3_VertexDrawable.h"
+#include "animal3D/a3graphics/a3_Texture.h"
+#include "animal3D/a3math/A3DM.h"
+
+#include "a3_DemoShaderProgram.h"
+#include "a3_DemoGraphicsState.h"
+#include "a3_DemoSceneBlock.h"
+#include "a3_DemoUniformStream.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoRenderPacket		a3_DemoRenderPacket;
+	typedef struct a3_DemoDrawCommand		a3_DemoDrawCommand;
+	typedef struct a3_DemoRenderBatch		a3_DemoRenderBatch;
+	typedef struct a3_DemoRenderQueueStats	a3_DemoRenderQueueStats;
+	typedef struct a3_DemoRenderQueue		a3_DemoRenderQueue;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// limits
+	enum a3_DemoRenderQueueMaxCounts
+	{
+		demoRenderQueue_packetMax = 1024,
+		demoRenderQueue_layerMax = 16,
+		demoRenderPacket_textureCount = 2,		// units 0 and 1: diffuse and specular maps
+		demoRenderBatch_drawMax = 128,			// draws per run; object blocks in the GLSL array
+	};
+
+
+	// one draw: the state it needs and its per-object uniforms
+	struct a3_DemoRenderPacket
+	{
+		a3_DemoObjectBlock object;
+		const a3_DemoStateShaderProgram *program;
+		const a3_VertexDrawable *drawable;
+		const a3_Texture *texture[demoRenderPacket_textureCount];	// null leaves the unit as it is
+	};
+
+	// GL's DrawElementsIndirectCommand
+	struct a3_DemoDrawCommand
+	{
+		unsigned int count;
+		unsigned int instanceCount;
+		unsigned int firstIndex;
+		int baseVertex;
+		unsigned int baseInstance;
+	};
+
+	// consecutive packets (in draw order) that share program, vertex 
+	//	array, index buffer, primitive and textures; their object blocks 
+	//	are one array in the uniform stream, in the same order:
+	//
+	//	layout (std140) uniform uObject
+	//	{
+	//		ObjectData objects[128];	// demoRenderBatch_drawMax
+	//	};
+	//	... objects[gl_DrawIDARB] ...
+	struct a3_DemoRenderBatch
+	{
+		unsigned int first;						// index into 'order' and 'command'
+		unsigned int count;
+		unsigned int objectOffset;				// where staging put the first block
+	};
+
+	// what drawing a queue cost, against binding everything for every draw
+	struct a3_DemoRenderQueueStats
+	{
+		unsigned int objects;					// packets drawn
+		unsigned int draws;						// draw calls issued for them
+		unsigned int programBinds;
+		unsigned int vertexArrayBinds;
+		unsigned int textureBinds;
+		unsigned int bindsSkipped;				// binds the same draws would make unsorted and unfiltered
+	};
+
+
+	// packets in submission order and their keys; sorting fills 'order'
+	// key, most significant first:
+	//	layer (4 bits) | program (12) | vertex array (12) | texture 0 (10) |
+	//	texture 1 (10) | depth (16)
+	//	object names are cut to fit, so two may share a key field; drawing
+	//	compares the objects themselves and stays correct, only the sort
+	//	gets a little worse
+	// fixed storage; submitting and sorting do not allocate
+	struct a3_DemoRenderQueue
+	{
+		a3_DemoRenderPacket packet[demoRenderQueue_packetMax];
+		unsigned long long key[demoRenderQueue_packetMax];
+		unsigned short order[demoRenderQueue_packetMax];		// packet indices, sorted by key
+		unsigned short orderTemp[demoRenderQueue_packetMax];	// radix sort ping-pong
+		a3_DemoRenderBatch batch[demoRenderQueue_packetMax];
+		a3_DemoDrawCommand command[demoRenderQueue_packetMax];	// one per packet, in draw order
+		unsigned int count;
+		unsigned int batchCount;
+		int sorted;
+	};
+
+
+	// called when drawing switches to a program, after it is bound, to send
+	//	uniforms that do not change per object
+	typedef void(*a3_DemoRenderProgramFunc)(const void *data, const a3_DemoStateShaderProgram *program);
+
+
+//-----------------------------------------------------------------------------
+
+	// empty a queue
+	int a3demo_resetRenderQueue(a3_DemoRenderQueue *queue);
+
+	// add a draw; layers are drawn in order, and within a layer and state
+	//	group, lower depth first (0 near, 1 far; pass 1 - depth to draw back
+	//	to front)
+	//	returns the packet to fill with per-object uniforms, null if full
+	a3_DemoRenderPacket *a3demo_pushRenderPacket(a3_DemoRenderQueue *queue, const unsigned int layer, const float depth, const a3_DemoStateShaderProgram *program, const a3_VertexDrawable *drawable, const a3_Texture *texture0_opt, const a3_Texture *texture1_opt);
+
+	// order packets by key (stable LSD radix sort, one pass per key byte
+	//	that is not the same for every packet)
+	//	returns number of packets sorted
+	int a3demo_sortRenderQueue(a3_DemoRenderQueue *queue);
+
+	// whether the driver can draw a run with one indirect call and give 
+	//	the shader its draw index (GL 4.3 with ARB_shader_draw_parameters)
+	int a3demo_getMultiDrawIndirectSupport();
+
+	// group packets into runs of up to 'drawMax' (1 for a draw per 
+	//	object) and copy their object blocks into a uniform stream, each 
+	//	run's blocks packed together in the order the queue draws; runs 
+	//	whose program has no object block are not staged
+	//	the stream needs room past the last run for a full run's range, 
+	//	since every run binds demoRenderBatch_drawMax blocks
+	//	returns number of runs, -1 if the stream is too small
+	int a3demo_stageRenderQueue(a3_DemoRenderQueue *queue, a3_DemoUniformStream *stream, const unsigned int drawMax);
+
+	// draw every run from the last staging, in key order, through a 
+	//	graphics state cache, which
+	//	drops binds that match the previous run (or whatever was bound
+	//	before the queue started); each staged run binds its object blocks
+	//	from 'objectBuffer' to 'objectBinding'; runs of more than one draw
+	//	are issued from 'commandBuffer' with one indirect call, so it is 
+	//	only optional if the queue was staged one draw per run
+	//	returns number of objects drawn
+	int a3demo_drawRenderQueue(const a3_DemoRenderQueue *queue, a3_DemoGraphicsState *state, const a3_UniformBuffer *objectBuffer, const unsigned int objectBinding, a3_VertexBuffer *commandBuffer_opt, a3_DemoRenderProgramFunc programFunc_opt, const void *data, a3_DemoRenderQueueStats *stats_out_opt);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMORENDERQUEUE_H
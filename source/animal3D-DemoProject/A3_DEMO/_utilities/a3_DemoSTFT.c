@@ -0,0 +1,230 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSTFT.c
+	Multi-resolution transform implementation.
+*/
+
+#include "a3_DemoSTFT.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSTFT(a3_DemoSTFT *stft_out, const unsigned int *sizes, const unsigned int resolutionCount, const unsigned int channels, const unsigned int hop, const a3_DemoSpectrumWindow windowType)
+{
+	if (stft_out && sizes && resolutionCount && resolutionCount <= demoSTFT_resolutionMax && channels && channels <= demoSpectrum_lanesMax && hop)
+	{
+		if (!stft_out->block)
+		{
+			const unsigned int ringSize = sizes[0];
+			float *block;
+			unsigned int i;
+
+			// longest first, and a hop no longer than the shortest window
+			for (i = 1; i < resolutionCount; ++i)
+				if (sizes[i] > sizes[i - 1])
+					return -1;
+			if (hop > sizes[resolutionCount - 1])
+				return -1;
+
+			block = (float *)malloc(sizeof(float) * 2 * channels * ringSize);
+			if (block)
+			{
+				memset(stft_out->resolution, 0, sizeof(stft_out->resolution));
+				memset(stft_out->bands, 0, sizeof(stft_out->bands));
+				for (i = 0; i < resolutionCount; ++i)
+					if (a3demo_createSpectrumBatch(stft_out->resolution + i, sizes[i], channels, windowType, a3spectrum_magnitude) <= 0)
+					{
+						while (i--)
+							a3demo_releaseSpectrumBatch(stft_out->resolution + i);
+						free(block);
+						return 0;
+					}
+
+				stft_out->block = block;
+				stft_out->ring = block;
+				stft_out->input = block + channels * ringSize;
+				stft_out->resolutionCount = resolutionCount;
+				stft_out->channels = channels;
+				stft_out->ringSize = ringSize;
+				stft_out->head = 0;
+				stft_out->hop = hop;
+				stft_out->bandCount = 0;
+				memset(block, 0, sizeof(float) * 2 * channels * ringSize);
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseSTFT(a3_DemoSTFT *stft)
+{
+	if (stft)
+	{
+		if (stft->block)
+		{
+			unsigned int i;
+			for (i = 0; i < stft->resolutionCount; ++i)
+			{
+				a3demo_releaseSpectrumBatch(stft->resolution + i);
+				a3demo_releaseSpectrumBands(stft->bands + i);
+			}
+			free(stft->block);
+			memset(stft, 0, sizeof(a3_DemoSTFT));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSTFTBands(a3_DemoSTFT *stft, const unsigned int count, const float sampleRate, const float minHz, const float maxHz, const a3_DemoSpectrumBandScale scale, const float *crossoverHz)
+{
+	if (stft && stft->block && !stft->bandCount && crossoverHz)
+	{
+		const a3_DemoSpectrumBands *table = stft->bands;
+		const float hzPerBin = sampleRate / (float)stft->ringSize;
+		const float *weight;
+		float center, sum;
+		unsigned int i, j, r;
+
+		for (r = 0; r < stft->resolutionCount; ++r)
+			if (a3demo_createSpectrumBands(stft->bands + r, count, stft->resolution[r].bins, sampleRate, minHz, maxHz, scale) <= 0)
+			{
+				while (r--)
+					a3demo_releaseSpectrumBands(stft->bands + r);
+				return -1;
+			}
+
+		// band centers from the finest table, as the weighted mean of
+		//	their bins; each band goes to the first resolution reaching it
+		for (r = 0; r + 1 < stft->resolutionCount; ++r)
+			stft->crossoverHz[r] = crossoverHz[r];
+		stft->crossoverHz[r] = 0.5f * sampleRate;
+		for (i = 0, weight = table->weight; i < count; weight += table->length[i++])
+		{
+			for (j = 0, center = sum = 0.0f; j < table->length[i]; ++j)
+			{
+				center += weight[j] * (float)(table->start[i] + j);
+				sum += weight[j];
+			}
+			center = center / sum * hzPerBin;
+			for (r = 0; r + 1 < stft->resolutionCount && center >= stft->crossoverHz[r]; ++r);
+			stft->bandResolution[i] = (unsigned char)r;
+		}
+		stft->bandCount = count;
+		return (int)count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_pushSTFT(a3_DemoSTFT *stft, const float *samples, const unsigned int count)
+{
+	if (stft && stft->block && samples)
+	{
+		const unsigned int ringSize = stft->ringSize;
+		const unsigned int skip = count > ringSize ? count - ringSize : 0;
+		const unsigned int take = count - skip;
+		const unsigned int first = ringSize - stft->head < take ? ringSize - stft->head : take;
+		unsigned int c;
+
+		// only the newest ringSize samples can matter; copy in at most two
+		//	pieces around the wrap
+		for (c = 0; c < stft->channels; ++c)
+		{
+			const float *const in = samples + c * count + skip;
+			float *const ring = stft->ring + c * ringSize;
+			memcpy(ring + stft->head, in, sizeof(float) * first);
+			memcpy(ring, in + first, sizeof(float) * (take - first));
+		}
+		stft->head = (stft->head + take) & (ringSize - 1);
+		return (int)take;
+	}
+	return -1;
+}
+
+int a3demo_computeSTFT(a3_DemoSTFT *stft, const unsigned int transformMask)
+{
+	if (stft && stft->block)
+	{
+		const unsigned int ringSize = stft->ringSize;
+		a3_DemoSpectrumBatch *engine;
+		unsigned int r, c, size, begin, first, count = 0;
+
+		for (r = 0; r < stft->resolutionCount; ++r)
+		{
+			// newest 'size' samples end at the head
+			engine = stft->resolution + r;
+			size = engine->size;
+			begin = (stft->head + ringSize - size) & (ringSize - 1);
+			first = ringSize - begin < size ? ringSize - begin : size;
+			for (c = 0; c < stft->channels; ++c)
+			{
+				const float *const ring = stft->ring + c * ringSize;
+				float *const samples = engine->samples + c * size;
+				memcpy(samples, ring + begin, sizeof(float) * first);
+				memcpy(samples + first, ring, sizeof(float) * (size - first));
+			}
+			if (transformMask & (1u << r))
+			{
+				a3demo_computeSpectrumBatch(engine, 0);
+				++count;
+			}
+		}
+		return (int)count;
+	}
+	return -1;
+}
+
+int a3demo_applySTFTBands(const a3_DemoSTFT *stft, const unsigned int channel, float *values_out)
+{
+	if (stft && stft->bandCount && channel < stft->channels && values_out)
+	{
+		float values[demoSpectrumBands_countMax];
+		const unsigned int count = stft->bandCount;
+		unsigned int r, i;
+
+		// whole table per resolution, then keep the bands it owns; tables
+		//	are sparse, so the waste is small
+		for (r = 0; r < stft->resolutionCount; ++r)
+		{
+			a3demo_applySpectrumBands(stft->bands + r, stft->resolution[r].spectrum + channel * stft->resolution[r].bins, values);
+			for (i = 0; i < count; ++i)
+				if (stft->bandResolution[i] == r)
+					values_out[i] = values[i];
+		}
+		return (int)count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSTFT.h
+	Multi-resolution short-time Fourier transform: a ring of recent
+		samples framed by several window sizes at once, with each band
+		read from the size that suits it (long windows for bass, short
+		windows for highs).
+*/
+
+#ifndef __ANIMAL3D_DEMOSTFT_H
+#define __ANIMAL3D_DEMOSTFT_H
+
+
+#include "a3_DemoSpectrum.h"
+#include "a3_DemoSpectrumBands.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSTFT				a3_DemoSTFT;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// limits
+	enum a3_DemoSTFTMaxCounts
+	{
+		demoSTFT_resolutionMax = 4,
+	};
+
+
+	// multi-resolution transform
+	// every resolution is a batched engine over the same channels; on
+	//	compute each one frames the newest 'size' samples of the ring, so
+	//	all windows end on the same sample and successive frames overlap
+	//	by size - hop
+	// band tables are built per resolution, and each band is read from
+	//	the longest resolution whose crossover lies above its center
+	// ring storage lives in one block allocated on create; engines and
+	//	band tables own theirs; computing does not allocate
+	struct a3_DemoSTFT
+	{
+		a3_DemoSpectrumBatch resolution[demoSTFT_resolutionMax];	// engines, longest window first
+		a3_DemoSpectrumBands bands[demoSTFT_resolutionMax];		// band table per resolution
+		float crossoverHz[demoSTFT_resolutionMax];	// bands centered below this use the resolution
+		unsigned char bandResolution[demoSpectrumBands_countMax];	// resolution each band is read from
+		float *ring;							// newest samples per channel [channels][ringSize]
+		float *input;							// staging for callers: room for ringSize samples per channel
+		void *block;							// single allocation for ring and staging
+		unsigned int resolutionCount;
+		unsigned int channels;
+		unsigned int ringSize;					// longest window
+		unsigned int head;						// ring index the next sample goes to
+		unsigned int hop;						// samples between frames
+		unsigned int bandCount;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create and release transform for 'channels' signals, framed by
+	//	each size in 'sizes' (powers of two, longest first) every 'hop'
+	//	samples
+	int a3demo_createSTFT(a3_DemoSTFT *stft_out, const unsigned int *sizes, const unsigned int resolutionCount, const unsigned int channels, const unsigned int hop, const a3_DemoSpectrumWindow windowType);
+	int a3demo_releaseSTFT(a3_DemoSTFT *stft);
+
+	// build band tables for every resolution; crossoverHz gives one
+	//	frequency per resolution but the last, which takes the rest
+	//	returns number of bands
+	int a3demo_createSTFTBands(a3_DemoSTFT *stft, const unsigned int count, const float sampleRate, const float minHz, const float maxHz, const a3_DemoSpectrumBandScale scale, const float *crossoverHz);
+
+	// append 'count' samples of every channel, laid out one channel after
+	//	another [channels][count]; pushing at least ringSize replaces all
+	int a3demo_pushSTFT(a3_DemoSTFT *stft, const float *samples, const unsigned int count);
+
+	// frame the newest samples into every resolution's engine and
+	//	transform the ones whose bit is set in 'transformMask' (others get
+	//	samples only, e.g. when their spectrum comes from elsewhere)
+	//	returns number of resolutions transformed
+	int a3demo_computeSTFT(a3_DemoSTFT *stft, const unsigned int transformMask);
+
+	// bands of one channel, each from its own resolution
+	//	returns number of bands written
+	int a3demo_applySTFTBands(const a3_DemoSTFT *stft, const unsigned int channel, float *values_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSTFT_H
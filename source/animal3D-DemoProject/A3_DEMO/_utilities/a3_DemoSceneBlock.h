@@ -0,0 +1,96 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSceneBlock.h
+	Scene uniforms as std140 blocks: one per frame, and one per object
+		that every object's draw selects by binding its range of a shared
+		buffer.
+*/
+
+#ifndef __ANIMAL3D_DEMOSCENEBLOCK_H
+#define __ANIMAL3D_DEMOSCENEBLOCK_H
+
+
+// math library
+#include "animal3D/a3math/A3DM.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoFrameBlock		a3_DemoFrameBlock;
+	typedef struct a3_DemoObjectBlock		a3_DemoObjectBlock;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// CPU copy of the 'uFrame' block; written once per frame:
+	//
+	//	layout (std140) uniform uFrame
+	//	{
+	//		mat4 viewProjectionMat;		// offset 0
+	//		vec4 lightPos_world;		// offset 64
+	//		vec4 eyePos_world;			// offset 80
+	//		float time;					// offset 96
+	//		float resolutionX;
+	//		float resolutionY;
+	//		float reserved;
+	//	} frame;
+	//
+	//	audio has its own per-frame block, uAudio (a3_DemoAudioBlock)
+	struct a3_DemoFrameBlock
+	{
+		a3mat4 viewProjectionMat;
+		a3vec4 lightPos_world;
+		a3vec4 eyePos_world;
+		float time;
+		float resolutionX, resolutionY;				// window size in pixels
+		float reserved;								// pads the block to a whole vec4
+	};
+
+	// CPU copy of the 'uObject' block; one per draw:
+	//
+	//	layout (std140) uniform uObject
+	//	{
+	//		mat4 modelViewProjectionMat;	// offset 0
+	//		vec4 lightPos_obj;				// offset 64
+	//		vec4 eyePos_obj;				// offset 80
+	//	} object;
+	struct a3_DemoObjectBlock
+	{
+		a3mat4 modelViewProjectionMat;
+		a3vec4 lightPos_obj;						// light position relative to object
+		a3vec4 eyePos_obj;							// eye position relative to object
+	};
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSCENEBLOCK_H
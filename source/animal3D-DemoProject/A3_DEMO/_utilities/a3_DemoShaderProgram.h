@@ -46,10 +46,11 @@ extern "C"
 
 //-----------------------------------------------------------------------------
 
-	// maximum number of uniforms in a program
+	// maximum number of uniforms and uniform blocks in a program
 	enum a3_DemoShaderProgramMaxCounts
 	{
 		demoStateMaxCount_shaderProgramUniform = 16,
+		demoStateMaxCount_shaderProgramUniformBlock = 4,
 	};
 
 
@@ -77,12 +78,20 @@ extern "C"
 
 					// Uniforms used for music visualization - Vedant
 					uTime,
-					uSpectrumData,
-					uWaveData,
+					uTex_spectrogram,			// band history; one row per update
 					uResX,
 					uResY;
 			};
 		};
+		union {
+			int uniformBlockLocation[demoStateMaxCount_shaderProgramUniformBlock];
+			struct {
+				int
+					ubAudio,					// per-frame audio data (a3_DemoAudioBlock)
+					ubFrame,					// per-frame scene data (a3_DemoFrameBlock)
+					ubObject;					// per-draw object data (a3_DemoObjectBlock)
+			};
+		};
 	};
 
 
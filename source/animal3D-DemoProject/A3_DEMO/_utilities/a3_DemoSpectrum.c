@@ -0,0 +1,341 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrum.c
+	Real-input spectrum engine implementation.
+*/
+
+#include "a3_DemoSpectrum.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// round byte count up to 16 so every sub-array stays SIMD-aligned
+#define a3demo_spectrumAlign(bytes)	(((bytes) + 15) & ~(size_t)15)
+
+
+// fill window table; returns sum of window
+float a3demo_spectrumFillWindow(float *window, const unsigned int size, const a3_DemoSpectrumWindow windowType)
+{
+	const double twoPi = 6.283185307179586476925286766559;
+	const double n = (double)size, halfN = 0.5 * n;
+	double sum = 0.0, w, t;
+	unsigned int i;
+
+	for (i = 0; i < size; ++i)
+	{
+		t = twoPi * (double)i / n;
+		switch (windowType)
+		{
+		case a3spectrum_windowTriangle:
+			w = 1.0 - fabs(((double)i - halfN) / halfN);
+			break;
+		case a3spectrum_windowHann:
+			w = 0.5 - 0.5 * cos(t);
+			break;
+		case a3spectrum_windowHamming:
+			w = 0.54 - 0.46 * cos(t);
+			break;
+		case a3spectrum_windowBlackman:
+			w = 0.42 - 0.5 * cos(t) + 0.08 * cos(t + t);
+			break;
+		default:
+			w = 1.0;
+			break;
+		}
+		window[i] = (float)w;
+		sum += w;
+	}
+	return (float)sum;
+}
+
+
+// convert transform output to the requested scale
+//	real and imaginary parts are read 'stride' floats apart
+void a3demo_spectrumScale(float *out, const float *re, const float *im, const unsigned int stride, const unsigned int bins, const float scale, const a3_DemoSpectrumOutput outputType)
+{
+	const float scaleSq = scale * scale;
+	const float floorPower = 1.0e-12f;	// -120 dB
+	float *const end = out + bins;
+	float power;
+
+	switch (outputType)
+	{
+	case a3spectrum_power:
+		for (; out < end; ++out, re += stride, im += stride)
+			*out = (*re * *re + *im * *im) * scaleSq;
+		break;
+	case a3spectrum_decibel:
+		for (; out < end; ++out, re += stride, im += stride)
+		{
+			power = (*re * *re + *im * *im) * scaleSq;
+			*out = 10.0f * log10f(power > floorPower ? power : floorPower);
+		}
+		break;
+	default:
+		for (; out < end; ++out, re += stride, im += stride)
+			*out = sqrtf(*re * *re + *im * *im) * scale;
+		break;
+	}
+}
+
+
+// average bins down to a fixed count (Nyquist bin is dropped)
+void a3demo_spectrumResample(const float *in, const unsigned int bins, float *values_out, const unsigned int count)
+{
+	const unsigned int linear = bins - 1;
+	unsigned int i, j, first, last;
+	float sum;
+
+	for (i = 0; i < count; ++i)
+	{
+		// linear range of bins covered by this output value
+		first = i * linear / count;
+		last = (i + 1) * linear / count;
+		if (last <= first)
+			last = first + 1;
+		for (j = first, sum = 0.0f; j < last; ++j)
+			sum += in[j];
+		values_out[i] = sum / (float)(last - first);
+	}
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSpectrum(a3_DemoSpectrum *spectrum_out, const unsigned int size, const a3_DemoSpectrumWindow windowType, const a3_DemoSpectrumOutput outputType)
+{
+	if (spectrum_out && size >= demoSpectrum_sizeMin && size <= demoSpectrum_sizeMax && !(size & (size - 1)))
+	{
+		if (!spectrum_out->block)
+		{
+			const unsigned int bins = size / 2 + 1;
+			size_t cfgSize = 0, windowSize, inputSize, freqSize, spectrumSize;
+			char *block;
+			float windowSum;
+
+			// ask kissfft how much space the config needs, then place it
+			//	in the same block as everything else
+			kiss_fftr_alloc((int)size, 0, 0, &cfgSize);
+			cfgSize = a3demo_spectrumAlign(cfgSize);
+			windowSize = a3demo_spectrumAlign(sizeof(float) * size);
+			inputSize = windowSize;
+			freqSize = a3demo_spectrumAlign(sizeof(kiss_fft_cpx) * bins);
+			spectrumSize = a3demo_spectrumAlign(sizeof(float) * bins);
+
+			block = (char *)malloc(cfgSize + windowSize + inputSize + freqSize + spectrumSize);
+			if (block)
+			{
+				spectrum_out->block = block;
+				spectrum_out->cfg = kiss_fftr_alloc((int)size, 0, block, &cfgSize);
+				block += cfgSize;
+				spectrum_out->window = (float *)block;
+				block += windowSize;
+				spectrum_out->input = (float *)block;
+				block += inputSize;
+				spectrum_out->freq = (kiss_fft_cpx *)block;
+				block += freqSize;
+				spectrum_out->spectrum = (float *)block;
+
+				spectrum_out->size = size;
+				spectrum_out->bins = bins;
+				spectrum_out->windowType = windowType;
+				spectrum_out->outputType = outputType;
+
+				// a full-scale sine then reads 1 regardless of window or size
+				windowSum = a3demo_spectrumFillWindow(spectrum_out->window, size, windowType);
+				spectrum_out->scale = 2.0f / windowSum;
+
+				memset(spectrum_out->input, 0, inputSize);
+				memset(spectrum_out->spectrum, 0, spectrumSize);
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseSpectrum(a3_DemoSpectrum *spectrum)
+{
+	if (spectrum)
+	{
+		if (spectrum->block)
+		{
+			free(spectrum->block);
+			memset(spectrum, 0, sizeof(a3_DemoSpectrum));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_computeSpectrum(a3_DemoSpectrum *spectrum, const float *samples_opt)
+{
+	if (spectrum && spectrum->block)
+	{
+		const float *const window = spectrum->window;
+		const float *const samples = samples_opt ? samples_opt : spectrum->input;
+		float *const input = spectrum->input;
+		unsigned int i;
+
+		// window
+		for (i = 0; i < spectrum->size; ++i)
+			input[i] = samples[i] * window[i];
+
+		// transform
+		kiss_fftr(spectrum->cfg, input, spectrum->freq);
+
+		// scale
+		a3demo_spectrumScale(spectrum->spectrum, &spectrum->freq->r, &spectrum->freq->i, 2, spectrum->bins, spectrum->scale, spectrum->outputType);
+		return (int)spectrum->bins;
+	}
+	return -1;
+}
+
+int a3demo_resampleSpectrum(const a3_DemoSpectrum *spectrum, float *values_out, const unsigned int count)
+{
+	if (spectrum && spectrum->block && values_out && count)
+	{
+		a3demo_spectrumResample(spectrum->spectrum, spectrum->bins, values_out, count);
+		return (int)count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSpectrumBatch(a3_DemoSpectrumBatch *batch_out, const unsigned int size, const unsigned int lanes, const a3_DemoSpectrumWindow windowType, const a3_DemoSpectrumOutput outputType)
+{
+	if (batch_out && size >= demoSpectrum_sizeMin && size <= demoSpectrum_sizeMax && !(size & (size - 1)) && lanes && lanes <= demoSpectrum_lanesMax)
+	{
+		if (!batch_out->block)
+		{
+			const unsigned int bins = size / 2 + 1;
+			size_t cfgSize = 0, windowSize, samplesSize, freqSize, spectrumSize;
+			char *block;
+			float windowSum;
+
+			// same single-block layout as the single engine
+			kiss_fftr_batch_alloc((int)size, (int)lanes, 0, &cfgSize);
+			cfgSize = a3demo_spectrumAlign(cfgSize);
+			windowSize = a3demo_spectrumAlign(sizeof(float) * size);
+			samplesSize = a3demo_spectrumAlign(sizeof(float) * size * lanes);
+			freqSize = a3demo_spectrumAlign(sizeof(float) * 2 * bins * lanes);
+			spectrumSize = a3demo_spectrumAlign(sizeof(float) * bins * lanes);
+
+			block = (char *)malloc(cfgSize + windowSize + samplesSize + samplesSize + freqSize + spectrumSize);
+			if (block)
+			{
+				batch_out->block = block;
+				batch_out->cfg = kiss_fftr_batch_alloc((int)size, (int)lanes, block, &cfgSize);
+				block += cfgSize;
+				batch_out->window = (float *)block;
+				block += windowSize;
+				batch_out->samples = (float *)block;
+				block += samplesSize;
+				batch_out->input = (float *)block;
+				block += samplesSize;
+				batch_out->freq = (float *)block;
+				block += freqSize;
+				batch_out->spectrum = (float *)block;
+
+				batch_out->size = size;
+				batch_out->bins = bins;
+				batch_out->lanes = lanes;
+				batch_out->windowType = windowType;
+				batch_out->outputType = outputType;
+
+				windowSum = a3demo_spectrumFillWindow(batch_out->window, size, windowType);
+				batch_out->scale = 2.0f / windowSum;
+
+				memset(batch_out->samples, 0, samplesSize);
+				memset(batch_out->spectrum, 0, spectrumSize);
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseSpectrumBatch(a3_DemoSpectrumBatch *batch)
+{
+	if (batch)
+	{
+		if (batch->block)
+		{
+			free(batch->block);
+			memset(batch, 0, sizeof(a3_DemoSpectrumBatch));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_computeSpectrumBatch(a3_DemoSpectrumBatch *batch, const float *samples_opt)
+{
+	if (batch && batch->block)
+	{
+		const float *const window = batch->window;
+		const float *const samples = samples_opt ? samples_opt : batch->samples;
+		const float *lane;
+		float *input;
+		const unsigned int size = batch->size, bins = batch->bins, lanes = batch->lanes;
+		unsigned int i, j;
+
+		// window and interleave: sample i of every lane sits together
+		for (j = 0, lane = samples; j < lanes; ++j, lane += size)
+			for (i = 0, input = batch->input + j; i < size; ++i, input += lanes)
+				*input = lane[i] * window[i];
+
+		// transform all lanes at once
+		kiss_fftr_batch(batch->cfg, batch->input, batch->freq);
+
+		// scale each lane into its own row
+		for (j = 0; j < lanes; ++j)
+			a3demo_spectrumScale(batch->spectrum + j * bins, batch->freq + j, batch->freq + lanes + j, 2 * lanes, bins, batch->scale, batch->outputType);
+		return (int)bins;
+	}
+	return -1;
+}
+
+int a3demo_resampleSpectrumBatch(const a3_DemoSpectrumBatch *batch, const unsigned int lane, float *values_out, const unsigned int count)
+{
+	if (batch && batch->block && lane < batch->lanes && values_out && count)
+	{
+		a3demo_spectrumResample(batch->spectrum + lane * batch->bins, batch->bins, values_out, count);
+		return (int)count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
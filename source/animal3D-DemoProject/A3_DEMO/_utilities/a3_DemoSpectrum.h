@@ -0,0 +1,161 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrum.h
+	Real-input spectrum engine built on kissfft; no dependency on FMOD.
+*/
+
+#ifndef __ANIMAL3D_DEMOSPECTRUM_H
+#define __ANIMAL3D_DEMOSPECTRUM_H
+
+
+// kissfft real transform
+#include "kissfft/tools/kiss_fftr.h"
+#include "kissfft/tools/kiss_fft_batch.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSpectrum			a3_DemoSpectrum;
+	typedef struct a3_DemoSpectrumBatch		a3_DemoSpectrumBatch;
+	typedef enum a3_DemoSpectrumWindow		a3_DemoSpectrumWindow;
+	typedef enum a3_DemoSpectrumOutput		a3_DemoSpectrumOutput;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// supported transform sizes (powers of two)
+	enum a3_DemoSpectrumSizes
+	{
+		demoSpectrum_sizeMin = 512,
+		demoSpectrum_sizeMax = 16384,
+		demoSpectrum_lanesMax = 8,
+	};
+
+	// window applied to samples before transform
+	enum a3_DemoSpectrumWindow
+	{
+		a3spectrum_windowRect,
+		a3spectrum_windowTriangle,
+		a3spectrum_windowHann,
+		a3spectrum_windowHamming,
+		a3spectrum_windowBlackman,
+	};
+
+	// spectrum output scale
+	enum a3_DemoSpectrumOutput
+	{
+		a3spectrum_magnitude,		// |X|, full-scale sine reads 1
+		a3spectrum_power,			// |X|^2
+		a3spectrum_decibel,			// 20 log10 |X|, floored
+	};
+
+
+	// spectrum engine
+	// all storage lives in one block allocated on create; computing a
+	//	spectrum does not allocate
+	// not thread-safe: give each analysis thread its own engine
+	struct a3_DemoSpectrum
+	{
+		kiss_fftr_cfg cfg;						// transform config (placed in block)
+		float *window;							// window table [size]
+		float *input;							// windowed samples [size]
+		kiss_fft_cpx *freq;						// transform output [bins]
+		float *spectrum;						// scaled output [bins]
+		void *block;							// single allocation for all of the above
+		unsigned int size;						// transform size
+		unsigned int bins;						// size / 2 + 1
+		float scale;							// magnitude normalization
+		a3_DemoSpectrumWindow windowType;
+		a3_DemoSpectrumOutput outputType;
+	};
+
+
+	// batched spectrum engine: several signals of the same size transformed
+	//	together (e.g. left, right, mid, side); costs about the same as one
+	//	signal on the single engine as long as lanes fit a SIMD register
+	struct a3_DemoSpectrumBatch
+	{
+		kiss_fftr_batch_cfg cfg;				// batched transform config (placed in block)
+		float *window;							// window table [size]
+		float *samples;							// raw samples, one signal after another [lanes][size]
+		float *input;							// windowed samples, interleaved [size][lanes]
+		float *freq;							// transform output, batch layout [bins][2][lanes]
+		float *spectrum;						// scaled output, one signal after another [lanes][bins]
+		void *block;							// single allocation for all of the above
+		unsigned int size;						// transform size
+		unsigned int bins;						// size / 2 + 1
+		unsigned int lanes;						// signals per transform
+		float scale;							// magnitude normalization
+		a3_DemoSpectrumWindow windowType;
+		a3_DemoSpectrumOutput outputType;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// fill a window table of 'size' values
+	//	returns sum of the window
+	float a3demo_spectrumFillWindow(float *window, const unsigned int size, const a3_DemoSpectrumWindow windowType);
+
+
+	// create and release engine
+	//	size must be a power of two in [sizeMin, sizeMax]
+	int a3demo_createSpectrum(a3_DemoSpectrum *spectrum_out, const unsigned int size, const a3_DemoSpectrumWindow windowType, const a3_DemoSpectrumOutput outputType);
+	int a3demo_releaseSpectrum(a3_DemoSpectrum *spectrum);
+
+	// transform 'size' samples; if samples_opt is null the samples are read
+	//	from 'input' (windowed in place)
+	//	returns number of bins written to 'spectrum'
+	int a3demo_computeSpectrum(a3_DemoSpectrum *spectrum, const float *samples_opt);
+
+	// reduce spectrum to a fixed number of linear bins by averaging
+	//	(Nyquist bin is dropped)
+	int a3demo_resampleSpectrum(const a3_DemoSpectrum *spectrum, float *values_out, const unsigned int count);
+
+
+	// create and release batched engine
+	//	lanes in [1, lanesMax]; 4 or 8 use the full SIMD width
+	int a3demo_createSpectrumBatch(a3_DemoSpectrumBatch *batch_out, const unsigned int size, const unsigned int lanes, const a3_DemoSpectrumWindow windowType, const a3_DemoSpectrumOutput outputType);
+	int a3demo_releaseSpectrumBatch(a3_DemoSpectrumBatch *batch);
+
+	// transform 'size' samples of every lane; if samples_opt is null the
+	//	samples are read from 'samples' (same layout, left untouched)
+	//	returns number of bins written per lane
+	int a3demo_computeSpectrumBatch(a3_DemoSpectrumBatch *batch, const float *samples_opt);
+
+	// reduce one lane's spectrum to a fixed number of linear bins
+	int a3demo_resampleSpectrumBatch(const a3_DemoSpectrumBatch *batch, const unsigned int lane, float *values_out, const unsigned int count);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSPECTRUM_H
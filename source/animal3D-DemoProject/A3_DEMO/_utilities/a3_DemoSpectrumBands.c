@@ -0,0 +1,268 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrumBands.c
+	Perceptual band mapping implementation.
+*/
+
+#include "a3_DemoSpectrumBands.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// every x86 target the demo builds for has SSE
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#define A3_DEMOSPECTRUMBANDS_SSE
+#include <xmmintrin.h>
+#endif	// SSE
+
+
+//-----------------------------------------------------------------------------
+
+// mel scale conversions
+#define a3demo_hzToMel(hz)	(2595.0 * log10(1.0 + (hz) / 700.0))
+#define a3demo_melToHz(mel)	(700.0 * (pow(10.0, (mel) / 2595.0) - 1.0))
+
+
+// shape of one band: center and the frequencies where its weight reaches 0
+void a3demo_spectrumBandShape(double *center_out, double *lo_out, double *hi_out, const unsigned int index, const unsigned int count, const double minHz, const double maxHz, const a3_DemoSpectrumBandScale scale)
+{
+	double step, ratio;
+
+	switch (scale)
+	{
+	case a3bands_mel:
+	{
+		// even steps in mel; neighbors' centers are the edges
+		const double minMel = a3demo_hzToMel(minHz), maxMel = a3demo_hzToMel(maxHz);
+		step = count > 1 ? (maxMel - minMel) / (double)(count - 1) : (maxMel - minMel);
+		*center_out = a3demo_melToHz(minMel + step * (double)index);
+		*lo_out = a3demo_melToHz(minMel + step * ((double)index - 1.0));
+		*hi_out = a3demo_melToHz(minMel + step * ((double)index + 1.0));
+	}	break;
+	case a3bands_constantQ:
+		// width proportional to center, so every band holds the same
+		//	fraction of an octave
+		step = count > 1 ? log(maxHz / minHz) / (double)(count - 1) : log(maxHz / minHz);
+		ratio = exp(step) - 1.0;
+		*center_out = minHz * exp(step * (double)index);
+		*lo_out = *center_out * (1.0 - ratio);
+		*hi_out = *center_out * (1.0 + ratio);
+		break;
+	default:
+		// even steps in log frequency; neighbors' centers are the edges
+		step = count > 1 ? log(maxHz / minHz) / (double)(count - 1) : log(maxHz / minHz);
+		*center_out = minHz * exp(step * (double)index);
+		*lo_out = *center_out * exp(-step);
+		*hi_out = *center_out * exp(step);
+		break;
+	}
+}
+
+// unnormalized weight of frequency f in a band
+double a3demo_spectrumBandWeight(const double f, const double center, const double lo, const double hi, const a3_DemoSpectrumBandScale scale)
+{
+	const double pi = 3.1415926535897932384626433832795;
+	if (f <= lo || f >= hi)
+		return 0.0;
+	if (scale == a3bands_constantQ)
+		return 0.5 + 0.5 * cos(pi * (f - center) / (f < center ? center - lo : hi - center));
+	return f < center ? (f - lo) / (center - lo) : (hi - f) / (hi - center);
+}
+
+// run of bins stored for one band: covers the band's support, padded to a
+//	multiple of 4 and kept inside the spectrum
+//	bands narrower than one bin interpolate between the two bins around
+//	their center instead
+unsigned int a3demo_spectrumBandRun(unsigned int *start_out, const double center, const double lo, const double hi, const double binHz, const unsigned int bins)
+{
+	const double last = (double)(bins - 1);
+	double firstBin = ceil(lo / binHz), lastBin = floor(hi / binHz);
+	unsigned int first, length;
+
+	if (lastBin - firstBin < 1.0)
+	{
+		firstBin = floor(center / binHz);
+		lastBin = firstBin + 1.0;
+	}
+	firstBin = firstBin < 0.0 ? 0.0 : firstBin > last ? last : firstBin;
+	lastBin = lastBin < firstBin ? firstBin : lastBin > last ? last : lastBin;
+	first = (unsigned int)firstBin;
+	length = ((unsigned int)lastBin - first + 4) & ~3u;
+
+	// slide back from the end, or trim if the band is wider than the spectrum
+	if (length > bins)
+		length = bins & ~3u;
+	if (first + length > bins)
+		first = bins - length;
+	*start_out = first;
+	return length;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_createSpectrumBands(a3_DemoSpectrumBands *bands_out, const unsigned int count, const unsigned int bins, const float sampleRate, const float minHz, const float maxHz, const a3_DemoSpectrumBandScale scale)
+{
+	if (bands_out && count && count <= demoSpectrumBands_countMax && bins >= 8 && sampleRate > 0.0f && minHz > 0.0f && maxHz > minHz)
+	{
+		if (!bands_out->block)
+		{
+			const double nyquist = 0.5 * (double)sampleRate;
+			const double binHz = nyquist / (double)(bins - 1);
+			const double top = (double)maxHz < nyquist ? (double)maxHz : nyquist;
+			double center, lo, hi, sum, f, w, x;
+			unsigned int i, j, first, length, nonzero;
+			size_t runSize;
+			float *weight;
+			char *block;
+
+			if (top <= (double)minHz)
+				return -1;
+
+			// first pass: how many weights are stored
+			for (i = nonzero = 0; i < count; ++i)
+			{
+				a3demo_spectrumBandShape(&center, &lo, &hi, i, count, minHz, top, scale);
+				nonzero += a3demo_spectrumBandRun(&first, center, lo, hi, binHz, bins);
+			}
+
+			runSize = sizeof(unsigned int) * count;
+			block = (char *)malloc(sizeof(float) * nonzero + runSize + runSize);
+			if (block)
+			{
+				bands_out->block = block;
+				bands_out->weight = (float *)block;
+				block += sizeof(float) * nonzero;
+				bands_out->start = (unsigned int *)block;
+				block += runSize;
+				bands_out->length = (unsigned int *)block;
+
+				bands_out->count = count;
+				bands_out->bins = bins;
+				bands_out->nonzero = nonzero;
+				bands_out->scale = scale;
+
+				// second pass: fill and normalize each band's weights
+				for (i = 0, weight = bands_out->weight; i < count; ++i, weight += length)
+				{
+					a3demo_spectrumBandShape(&center, &lo, &hi, i, count, minHz, top, scale);
+					length = a3demo_spectrumBandRun(&first, center, lo, hi, binHz, bins);
+					bands_out->start[i] = first;
+					bands_out->length[i] = length;
+					if (i == 0)
+						bands_out->minHz = (float)center;
+					if (i == count - 1)
+						bands_out->maxHz = (float)center;
+
+					for (j = 0, sum = 0.0; j < length; ++j)
+					{
+						f = (double)(first + j) * binHz;
+						w = a3demo_spectrumBandWeight(f, center, lo, hi, scale);
+						weight[j] = (float)w;
+						sum += w;
+					}
+
+					// band narrower than a bin: interpolate at its center
+					if (sum < 1.0)
+					{
+						memset(weight, 0, sizeof(float) * length);
+						x = center / binHz - (double)first;
+						j = (unsigned int)x;
+						if (j + 1 < length)
+						{
+							weight[j] = (float)(1.0 - (x - (double)j));
+							weight[j + 1] = (float)(x - (double)j);
+						}
+						else
+							weight[length - 1] = 1.0f;
+						sum = 1.0;
+					}
+					for (j = 0; j < length; ++j)
+						weight[j] = (float)((double)weight[j] / sum);
+				}
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseSpectrumBands(a3_DemoSpectrumBands *bands)
+{
+	if (bands)
+	{
+		if (bands->block)
+		{
+			free(bands->block);
+			memset(bands, 0, sizeof(a3_DemoSpectrumBands));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+int a3demo_applySpectrumBands(const a3_DemoSpectrumBands *bands, const float *spectrum, float *values_out)
+{
+	if (bands && bands->block && spectrum && values_out)
+	{
+		const float *weight = bands->weight, *in;
+		const unsigned int *start = bands->start, *length = bands->length;
+		float *const end = values_out + bands->count;
+		unsigned int j;
+
+#ifdef A3_DEMOSPECTRUMBANDS_SSE
+		__m128 sum;
+		for (; values_out < end; ++values_out, ++start, ++length)
+		{
+			in = spectrum + *start;
+			sum = _mm_setzero_ps();
+			for (j = 0; j < *length; j += 4, in += 4, weight += 4)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(in), _mm_loadu_ps(weight)));
+
+			// add the four partial sums
+			sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+			sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+			_mm_store_ss(values_out, sum);
+		}
+#else	// !A3_DEMOSPECTRUMBANDS_SSE
+		float sum;
+		for (; values_out < end; ++values_out, ++start, ++length)
+		{
+			in = spectrum + *start;
+			for (j = 0, sum = 0.0f; j < *length; ++j)
+				sum += in[j] * weight[j];
+			*values_out = sum;
+			weight += *length;
+		}
+#endif	// A3_DEMOSPECTRUMBANDS_SSE
+		return (int)bands->count;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
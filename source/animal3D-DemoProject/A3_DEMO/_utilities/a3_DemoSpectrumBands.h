@@ -0,0 +1,98 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrumBands.h
+	Reduces a linear spectrum to a small number of perceptual bands using
+		a sparse weight table built once per configuration.
+*/
+
+#ifndef __ANIMAL3D_DEMOSPECTRUMBANDS_H
+#define __ANIMAL3D_DEMOSPECTRUMBANDS_H
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSpectrumBands		a3_DemoSpectrumBands;
+	typedef enum a3_DemoSpectrumBandScale	a3_DemoSpectrumBandScale;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// limits
+	enum a3_DemoSpectrumBandsMaxCounts
+	{
+		demoSpectrumBands_countMax = 256,
+	};
+
+	// how band centers and widths are spread over the frequency range
+	enum a3_DemoSpectrumBandScale
+	{
+		a3bands_log,				// centers evenly spaced in log frequency, triangles meet at neighbors
+		a3bands_mel,				// centers evenly spaced on the mel scale, triangles meet at neighbors
+		a3bands_constantQ,			// log-spaced centers, Hann shape whose width is a fixed fraction of center
+	};
+
+
+	// band mapping table
+	// each band is a contiguous run of bins with one weight per bin; runs are
+	//	padded to multiples of 4 so every band is a whole number of SIMD
+	//	products, and weights in a band sum to 1 (band reads as an average)
+	// all storage lives in one block allocated on create
+	struct a3_DemoSpectrumBands
+	{
+		unsigned int *start;					// first bin of each band [count]
+		unsigned int *length;					// bins in each band, multiple of 4 [count]
+		float *weight;							// all bands' weights back to back [nonzero]
+		void *block;							// single allocation for all of the above
+		unsigned int count;						// number of bands
+		unsigned int bins;						// length of spectrum the table applies to
+		unsigned int nonzero;					// total stored weights
+		float minHz, maxHz;						// lowest and highest band centers
+		a3_DemoSpectrumBandScale scale;
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create and release table
+	//	bins is the spectrum length (transform size / 2 + 1), sampleRate in Hz;
+	//	band centers run from minHz to maxHz (clamped to Nyquist)
+	int a3demo_createSpectrumBands(a3_DemoSpectrumBands *bands_out, const unsigned int count, const unsigned int bins, const float sampleRate, const float minHz, const float maxHz, const a3_DemoSpectrumBandScale scale);
+	int a3demo_releaseSpectrumBands(a3_DemoSpectrumBands *bands);
+
+	// reduce a spectrum of 'bins' values to 'count' bands
+	//	returns number of bands written
+	int a3demo_applySpectrumBands(const a3_DemoSpectrumBands *bands, const float *spectrum, float *values_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSPECTRUMBANDS_H
@@ -0,0 +1,187 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrumI32.cpp
+	Integer spectrum engine implementation; C++ only because the
+		fixed-point transform is.
+*/
+
+#include "a3_DemoSpectrumI32.h"
+
+#include "kissfft/kissfft_i32.hh"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+//-----------------------------------------------------------------------------
+
+// round byte count up to 16 so every sub-array stays SIMD-aligned
+#define a3demo_spectrumAlign(bytes)	(((bytes) + 15) & ~(size_t)15)
+
+// twiddles are stored times this; products are formed in 64 bits
+#define a3demo_spectrumTwiddleScale	(1 << 30)
+
+
+//-----------------------------------------------------------------------------
+
+extern "C"
+int a3demo_createSpectrumI32(a3_DemoSpectrumI32 *spectrum_out, const unsigned int size, const a3_DemoSpectrumWindow windowType)
+{
+	if (spectrum_out && size >= demoSpectrum_sizeMin && size <= demoSpectrum_sizeMax && !(size & (size - 1)))
+	{
+		if (!spectrum_out->block)
+		{
+			const size_t windowSize = a3demo_spectrumAlign(sizeof(int) * size);
+			const size_t cpxSize = a3demo_spectrumAlign(sizeof(int) * 2 * size);
+			const size_t pcmSize = a3demo_spectrumAlign(sizeof(short) * 2 * size);
+			char *block = (char *)malloc(windowSize + cpxSize + cpxSize + pcmSize);
+			float *window;
+			float windowSum;
+			unsigned int i;
+
+			if (block)
+			{
+				spectrum_out->fft = new kissfft_i32(size, false, a3demo_spectrumTwiddleScale);
+				spectrum_out->block = block;
+				spectrum_out->window = (int *)block;
+				block += windowSize;
+				spectrum_out->input = (int *)block;
+				block += cpxSize;
+				spectrum_out->freq = (int *)block;
+				block += cpxSize;
+				spectrum_out->pcm = (short *)block;
+
+				// float table first, in the input array, for the same shape
+				//	and normalization as the float engine
+				window = (float *)spectrum_out->input;
+				windowSum = a3demo_spectrumFillWindow(window, size, windowType);
+				for (i = 0; i < size; ++i)
+					spectrum_out->window[i] = (int)floorf(window[i] * 32767.0f + 0.5f);
+
+				// a full-scale sine reads 1; samples are 1 at 32768 and the
+				//	window at 32767
+				spectrum_out->scale = 2.0f / windowSum / (32768.0f * 32767.0f);
+
+				// a bin can reach 'size' times the peak of both channels
+				//	together, a bit and a half more than the peak; round to 2
+				for (spectrum_out->guard = 0; (1u << spectrum_out->guard) < size; ++spectrum_out->guard);
+				spectrum_out->guard += 2;
+
+				spectrum_out->size = size;
+				spectrum_out->bins = size / 2 + 1;
+				spectrum_out->shift = 0;
+				memset(spectrum_out->input, 0, cpxSize);
+				memset(spectrum_out->pcm, 0, pcmSize);
+				return 1;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+extern "C"
+int a3demo_releaseSpectrumI32(a3_DemoSpectrumI32 *spectrum)
+{
+	if (spectrum)
+	{
+		if (spectrum->block)
+		{
+			delete (kissfft_i32 *)spectrum->fft;
+			free(spectrum->block);
+			memset(spectrum, 0, sizeof(a3_DemoSpectrumI32));
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
+
+extern "C"
+int a3demo_computeSpectrumI32(a3_DemoSpectrumI32 *spectrum, const short *left, const short *right, float *spectrum_out)
+{
+	if (spectrum && spectrum->block && left && right && spectrum_out)
+	{
+		typedef std::complex<int> cpx;
+		const unsigned int size = spectrum->size, bins = spectrum->bins;
+		const int *const window = spectrum->window;
+		int *const input = spectrum->input;
+		const int *const freq = spectrum->freq;
+		float *const outLeft = spectrum_out, *const outRight = outLeft + bins;
+		float *const outMid = outRight + bins, *const outSide = outMid + bins;
+		float scale, lr, li, rr, ri;
+		int peak = 0, bits, shift, v;
+		unsigned int i, j;
+
+		// window; products of int16 and Q15 fit 31 bits
+		for (i = 0; i < size; ++i)
+		{
+			input[i * 2] = v = (int)left[i] * window[i];
+			peak = v > peak ? v : -v > peak ? -v : peak;
+			input[i * 2 + 1] = v = (int)right[i] * window[i];
+			peak = v > peak ? v : -v > peak ? -v : peak;
+		}
+		if (!peak)
+		{
+			memset(spectrum_out, 0, sizeof(float) * 4 * bins);
+			spectrum->shift = 0;
+			return (int)bins;
+		}
+
+		// block exponent: put the peak just under the headroom
+		for (bits = 0; bits < 31 && (1 << bits) <= peak; ++bits);
+		shift = (31 - (int)spectrum->guard) - bits;
+		if (shift > 0)
+			for (i = 0; i < size * 2; ++i)
+				input[i] <<= shift;
+		else if (shift < 0)
+			for (i = 0, v = 1 << (-shift - 1); i < size * 2; ++i)
+				input[i] = (input[i] + v) >> -shift;
+		spectrum->shift = shift;
+
+		((const kissfft_i32 *)spectrum->fft)->transform((const cpx *)input, (cpx *)spectrum->freq);
+
+		// Z = L + iR, so L(k) = (Z(k) + Z*(n - k)) / 2 and
+		//	R(k) = (Z(k) - Z*(n - k)) / 2i; the halves go into the scale
+		scale = 0.5f * ldexpf(spectrum->scale, -shift);
+		for (i = 0; i < bins; ++i)
+		{
+			j = (size - i) & (size - 1);
+			lr = (float)freq[i * 2] + (float)freq[j * 2];
+			li = (float)freq[i * 2 + 1] - (float)freq[j * 2 + 1];
+			rr = (float)freq[i * 2 + 1] + (float)freq[j * 2 + 1];
+			ri = (float)freq[j * 2] - (float)freq[i * 2];
+			outLeft[i] = sqrtf(lr * lr + li * li) * scale;
+			outRight[i] = sqrtf(rr * rr + ri * ri) * scale;
+			outMid[i] = 0.5f * sqrtf((lr + rr) * (lr + rr) + (li + ri) * (li + ri)) * scale;
+			outSide[i] = 0.5f * sqrtf((lr - rr) * (lr - rr) + (li - ri) * (li - ri)) * scale;
+		}
+		return (int)bins;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoSpectrumI32.h
+	Integer spectrum engine: int16 stereo PCM straight into a fixed-point
+		transform (kissfft_i32), for machines where float throughput is
+		the bottleneck. Same output as the batched float engine for the
+		left, right, mid and side lanes.
+*/
+
+#ifndef __ANIMAL3D_DEMOSPECTRUMI32_H
+#define __ANIMAL3D_DEMOSPECTRUMI32_H
+
+
+// window types and size limits
+#include "a3_DemoSpectrum.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoSpectrumI32		a3_DemoSpectrumI32;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// integer spectrum engine
+	// left and right go through one complex transform as its real and
+	//	imaginary parts and are pulled apart afterwards by symmetry; mid and
+	//	side follow from those, since the transform is linear
+	// before each transform the windowed block is shifted so its peak sits
+	//	just under the headroom the transform needs (block floating point),
+	//	so quiet passages keep as many bits as loud ones
+	// all storage but the transform object lives in one block allocated on
+	//	create; computing a spectrum does not allocate
+	struct a3_DemoSpectrumI32
+	{
+		void *fft;								// kissfft_i32 transform
+		int *window;							// window table, 1 is 32767 [size]
+		int *input;								// windowed left + i right, block scaled [size][2]
+		int *freq;								// transform output [size][2]
+		short *pcm;								// int16 staging for callers, left then right [2][size]
+		void *block;							// single allocation for all of the above but fft
+		unsigned int size;						// transform size
+		unsigned int bins;						// size / 2 + 1
+		unsigned int guard;						// headroom bits the transform needs
+		float scale;							// magnitude normalization, as the float engine
+		int shift;								// block exponent of the latest transform
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// create and release engine
+	//	size must be a power of two in [sizeMin, sizeMax]
+	int a3demo_createSpectrumI32(a3_DemoSpectrumI32 *spectrum_out, const unsigned int size, const a3_DemoSpectrumWindow windowType);
+	int a3demo_releaseSpectrumI32(a3_DemoSpectrumI32 *spectrum);
+
+	// transform 'size' samples of each channel (the newest at the end) and
+	//	write left, right, mid and side magnitudes one after another
+	//	[4][bins]; full-scale sine reads 1, as a3spectrum_magnitude
+	//	returns number of bins written per lane
+	int a3demo_computeSpectrumI32(a3_DemoSpectrumI32 *spectrum, const short *left, const short *right, float *spectrum_out);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOSPECTRUMI32_H
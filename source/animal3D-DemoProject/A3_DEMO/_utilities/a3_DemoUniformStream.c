@@ -0,0 +1,135 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoUniformStream.c
+	Uniform staging implementation.
+*/
+
+#include "a3_DemoUniformStream.h"
+
+
+// OpenGL
+#ifdef _WIN32
+#include <Windows.h>
+#include <GL/glew.h>
+#else	// !_WIN32
+#include <OpenGL/gl3.h>
+#endif	// _WIN32
+
+
+#include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+unsigned int a3demo_getUniformBufferAlignment()
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	// the spec caps it at 256
+	return alignment > 0 ? (unsigned int)alignment : 256;
+}
+
+int a3demo_createUniformStream(a3_DemoUniformStream *stream_out, const unsigned int size, const unsigned int alignment)
+{
+	if (stream_out && !stream_out->block && size)
+	{
+		unsigned int align = 16;
+		while (align < alignment)
+			align <<= 1;
+
+		stream_out->block = malloc(size);
+		if (stream_out->block)
+		{
+			stream_out->data = (unsigned char *)stream_out->block;
+			stream_out->size = size;
+			stream_out->used = 0;
+			stream_out->alignment = align;
+			memset(stream_out->data, 0, size);
+			return 1;
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int a3demo_releaseUniformStream(a3_DemoUniformStream *stream)
+{
+	if (stream && stream->block)
+	{
+		free(stream->block);
+		memset(stream, 0, sizeof(*stream));
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_resetUniformStream(a3_DemoUniformStream *stream)
+{
+	if (stream && stream->block)
+	{
+		stream->used = 0;
+		return 1;
+	}
+	return -1;
+}
+
+int a3demo_pushUniformStream(a3_DemoUniformStream *stream, const void *data, const unsigned int size)
+{
+	unsigned int offset;
+	void *const dst = data ? a3demo_reserveUniformStream(stream, size, &offset) : 0;
+	if (dst)
+	{
+		memcpy(dst, data, size);
+		return (int)offset;
+	}
+	return -1;
+}
+
+void *a3demo_reserveUniformStream(a3_DemoUniformStream *stream, const unsigned int size, unsigned int *offset_out)
+{
+	if (stream && stream->block && size && offset_out)
+	{
+		const unsigned int offset = (stream->used + stream->alignment - 1) & ~(stream->alignment - 1);
+		if (offset + size <= stream->size)
+		{
+			stream->used = offset + size;
+			*offset_out = offset;
+			return (stream->data + offset);
+		}
+	}
+	return 0;
+}
+
+int a3demo_uploadUniformStream(const a3_DemoUniformStream *stream, a3_UniformBuffer *buffer)
+{
+	if (stream && stream->block && buffer && stream->used <= buffer->size)
+	{
+		if (stream->used)
+			a3bufferFillOffset(buffer, 0, 0, stream->used, stream->data, 0);
+		return (int)stream->used;
+	}
+	return -1;
+}
+
+
+//-----------------------------------------------------------------------------
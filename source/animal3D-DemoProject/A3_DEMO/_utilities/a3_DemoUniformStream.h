@@ -0,0 +1,97 @@
+/*
+	Copyright 2011-2018 Daniel S. Buckstein
+
+	Licensed under the Apache License, Version 2.0 (the "License");
+	you may not use this file except in compliance with the License.
+	You may obtain a copy of the License at
+
+		http://www.apache.org/licenses/LICENSE-2.0
+
+	Unless required by applicable law or agreed to in writing, software
+	distributed under the License is distributed on an "AS IS" BASIS,
+	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+	See the License for the specific language governing permissions and
+	limitations under the License.
+*/
+
+/*
+	animal3D SDK: Minimal 3D Animation Framework
+	By Daniel S. Buckstein
+
+	a3_DemoUniformStream.h
+	Staging for uniform blocks that are written each frame: blocks are
+		packed at the offsets the driver can bind a range at, then the
+		whole frame goes to one uniform buffer in one upload.
+*/
+
+#ifndef __ANIMAL3D_DEMOUNIFORMSTREAM_H
+#define __ANIMAL3D_DEMOUNIFORMSTREAM_H
+
+
+//-----------------------------------------------------------------------------
+// animal3D framework includes
+
+#include "animal3D/a3graphics/a3_UniformBuffer.h"
+
+
+//-----------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C"
+{
+#else	// !__cplusplus
+	typedef struct a3_DemoUniformStream		a3_DemoUniformStream;
+#endif	// __cplusplus
+
+
+//-----------------------------------------------------------------------------
+
+	// staged blocks for one frame
+	// storage lives in one block allocated on create; pushing does not
+	//	allocate
+	struct a3_DemoUniformStream
+	{
+		unsigned char *data;						// staged bytes [size]
+		void *block;
+		unsigned int size;
+		unsigned int used;							// bytes staged since reset, up to the end of the last block
+		unsigned int alignment;						// range offsets are multiples of this
+	};
+
+
+//-----------------------------------------------------------------------------
+
+	// offset alignment the driver needs for uniform buffer ranges
+	unsigned int a3demo_getUniformBufferAlignment();
+
+	// create and release staging of 'size' bytes; alignment is rounded up
+	//	to a power of two
+	int a3demo_createUniformStream(a3_DemoUniformStream *stream_out, const unsigned int size, const unsigned int alignment);
+	int a3demo_releaseUniformStream(a3_DemoUniformStream *stream);
+
+	// start a new frame
+	int a3demo_resetUniformStream(a3_DemoUniformStream *stream);
+
+	// copy a block to the next aligned offset
+	//	returns the offset, -1 if it does not fit
+	int a3demo_pushUniformStream(a3_DemoUniformStream *stream, const void *data, const unsigned int size);
+
+	// make room for 'size' bytes at the next aligned offset, to be filled
+	//	by the caller (e.g. an array of blocks bound as one range)
+	//	returns where to write, null if it does not fit
+	void *a3demo_reserveUniformStream(a3_DemoUniformStream *stream, const unsigned int size, unsigned int *offset_out);
+
+	// send everything staged to a buffer at least as large as the staging
+	//	returns bytes uploaded
+	int a3demo_uploadUniformStream(const a3_DemoUniformStream *stream, a3_UniformBuffer *buffer);
+
+
+//-----------------------------------------------------------------------------
+
+
+#ifdef __cplusplus
+}
+#endif	// __cplusplus
+
+
+#endif	// !__ANIMAL3D_DEMOUNIFORMSTREAM_H
@@ -46,6 +46,31 @@ Demo state function implementations.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+
+//-----------------------------------------------------------------------------
+
+// model transformations for meshes built along a different axis than the
+//	one the scene uses
+static const a3mat4 a3demo_convertY2Z = {
+	+1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, +1.0f, 0.0f,
+	0.0f, -1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, +1.0f,
+};
+static const a3mat4 a3demo_convertZ2Y = {
+	+1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, -1.0f, 0.0f,
+	0.0f, +1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, +1.0f,
+};
+static const a3mat4 a3demo_convertZ2X = {
+	0.0f, 0.0f, -1.0f, 0.0f,
+	0.0f, +1.0f, 0.0f, 0.0f,
+	+1.0f, 0.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 0.0f, +1.0f,
+};
 
 
 //-----------------------------------------------------------------------------
@@ -114,6 +139,15 @@ void a3demo_loadTextures(a3_DemoState *demoState)
 		a3textureCreateFromFile(tex, texFiles[i]);
 	}
 
+	// spectrogram starts silent; audio updates replace one row at a time
+	{
+		a3_TexturePixelFormatDescriptor pixelFormat[1];
+		float *const silence = (float *)calloc(demoStateSpectrogram_width * demoStateSpectrogram_height, sizeof(float));
+		a3textureCreatePixelFormatDescriptor(pixelFormat, a3tex_r32F);
+		a3textureCreateFromData(demoState->tex_spectrogram, pixelFormat, demoStateSpectrogram_width, demoStateSpectrogram_height, silence, 0);
+		free(silence);
+	}
+
 	// change settings on a per-texture basis
 	a3textureActivate(demoState->tex_checker, a3tex_unit00);
 	a3textureDefaultSettings();	// nearest filtering, repeat on both axes
@@ -138,6 +172,10 @@ void a3demo_loadTextures(a3_DemoState *demoState)
 	a3textureChangeRepeatMode(a3tex_repeatNormal, a3tex_repeatClamp);
 	a3textureChangeFilterMode(a3tex_filterLinear);
 
+	a3textureActivate(demoState->tex_spectrogram, a3tex_unit00);
+	a3textureChangeRepeatMode(a3tex_repeatClamp, a3tex_repeatNormal);	// clamp bands, wrap history
+	a3textureChangeFilterMode(a3tex_filterLinear);
+
 
 	// done
 	a3textureDeactivate(a3tex_unit00);
@@ -318,6 +356,15 @@ void a3demo_loadGeometry(a3_DemoState *demoState)
 	currentDrawable = demoState->draw_teapot;
 	sharedVertexStorage += a3geometryGenerateDrawable(currentDrawable, loadedModelsData + 0, vao, vbo_ibo, sceneCommonIndexFormat, 0, 0);
 
+	// instanced field: per-instance attributes come from their own 
+	//	streamed buffer, read by the tangent basis array with divisors
+	a3demo_createInstanceBatch(demoState->sceneInstances, demoStateMaxCount_instance);
+	a3demo_createInstanceBuffer(demoState->vbo_sceneInstances, demoState->sceneInstances);
+	a3demo_attachInstanceBuffer(demoState->vao_tangent_basis, demoState->vbo_sceneInstances);
+
+	// scene queue's indirect draw commands, one per packet
+	a3bufferCreate(demoState->vbo_sceneCommands, a3buffer_vertex, sizeof(a3_DemoDrawCommand) * demoRenderQueue_packetMax, 0);
+
 	// release data when done
 	for (i = 0; i < sceneShapesCount; ++i)
 		a3geometryReleaseData(sceneShapesData + i);
@@ -350,12 +397,18 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 
 		// Uniforms used for music visualization
 		"uTime",
-		"uSpectrumData",
-		"uWaveData",
+		"uTex_spectrogram",
 		"uResX",
 		"uResY",
 	};
 
+	// list of uniform block names: align with block list in demo struct!
+	const char *uniformBlockNames[demoStateMaxCount_shaderProgramUniformBlock] = {
+		"uAudio",
+		"uFrame",
+		"uObject",
+	};
+
 
 	// some default uniform values
 	const float defaultColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
@@ -370,6 +423,8 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 			// vertex shaders
 			// Music Visualizer - Vedant
 			a3_Shader passMusicVisualizer_transform_vs[1];
+			a3_Shader passSceneObject_transform_vs[1];
+			a3_Shader passInstanced_transform_vs[1];
 
 			// 03 HW
 			a3_Shader passEffects_transform_vs[1];
@@ -388,6 +443,8 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 			// fragment shaders
 			// Music Visualizer - Vedant
 			a3_Shader drawMusicVisualizer_fs[1];
+			a3_Shader drawSceneObject_fs[1];
+			a3_Shader drawInstanced_fs[1];
 
 			// 03 HW
 			a3_Shader drawEffects_mrt_fs[1];
@@ -422,6 +479,8 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 		// vs
 		// music-visualizer - Vedant
 		{ a3shader_vertex,		1,{ "../../../../resource/glsl/4x/vs/music-visualizer/music_visualizer_vs4x.glsl" } },
+		{ a3shader_vertex,		1,{ "../../../../resource/glsl/4x/vs/music-visualizer/passSceneObject_transform_vs4x.glsl" } },
+		{ a3shader_vertex,		1,{ "../../../../resource/glsl/4x/vs/music-visualizer/passInstanced_transform_vs4x.glsl" } },
 
 		// 03
 		{ a3shader_vertex,		1,{ "../../../../resource/glsl/4x/vs/03-framebuffer/passEffects_transform_vs4x.glsl" } },
@@ -439,6 +498,8 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 		// fs
 		// music-visualizer
 		{ a3shader_fragment,	1,{ "../../../../resource/glsl/4x/fs/music-visualizer/music_visualizer_fs4x.glsl" } },
+		{ a3shader_fragment,	1,{ "../../../../resource/glsl/4x/fs/music-visualizer/drawSceneObject_fs4x.glsl" } },
+		{ a3shader_fragment,	1,{ "../../../../resource/glsl/4x/fs/music-visualizer/drawInstanced_fs4x.glsl" } },
 
 		// 03
 		{ a3shader_fragment,	1,{ "../../../../resource/glsl/4x/fs/03-framebuffer/drawEffects_mrt_fs4x.glsl" } },
@@ -474,6 +535,18 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passMusicVisualizer_transform_vs);
 	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawMusicVisualizer_fs);
 
+	// scene object program
+	currentDemoProg = demoState->prog_drawSceneObject;
+	a3shaderProgramCreate(currentDemoProg->program);
+	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passSceneObject_transform_vs);
+	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawSceneObject_fs);
+
+	// instanced field program
+	currentDemoProg = demoState->prog_drawInstanced;
+	a3shaderProgramCreate(currentDemoProg->program);
+	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.passInstanced_transform_vs);
+	a3shaderProgramAttachShader(currentDemoProg->program, shaderList.drawInstanced_fs);
+
 	// 03 programs
 	// Effects HSL, HSV, etc.
 	currentDemoProg = demoState->prog_drawEffectsMRT;
@@ -581,16 +654,41 @@ void a3demo_loadShaders(a3_DemoState *demoState)
 			a3shaderUniformSendFloat(a3unif_vec4, uLocation, 1, defaultColor);
 		if ((uLocation = currentDemoProg->uTime) >= 0)
 			a3shaderUniformSendDouble(a3unif_single, uLocation, 1, &demoState->timer->currentTick);
-		if ((uLocation = currentDemoProg->uSpectrumData) >= 0)
-			a3shaderUniformSendFloat(a3unif_single, uLocation, 1, 0);
-		if ((uLocation = currentDemoProg->uWaveData) >= 0)
-			a3shaderUniformSendFloat(a3unif_single, uLocation, 1, 0);
+		if ((uLocation = currentDemoProg->uTex_spectrogram) >= 0)
+			a3shaderUniformSendInt(a3unif_single, uLocation, 1, defaultTexUnits + 2);
 		if ((uLocation = currentDemoProg->uResX) >= 0)
 			a3shaderUniformSendInt(a3unif_single, uLocation, 1, &demoState->windowWidth);
 		if ((uLocation = currentDemoProg->uResY) >= 0)
 			a3shaderUniformSendInt(a3unif_single, uLocation, 1, &demoState->windowHeight);
+
+		// uniform blocks read from the buffer bound to the matching slot
+		currentUnif = currentDemoProg->uniformBlockLocation;
+		for (j = 0; j < demoStateMaxCount_shaderProgramUniformBlock; ++j)
+			currentUnif[j] = uniformBlockNames[j] ? a3shaderUniformBlockGetLocation(currentDemoProg->program, uniformBlockNames[j]) : -1;
+		if ((uLocation = currentDemoProg->ubAudio) >= 0)
+			a3shaderUniformBlockBind(currentDemoProg->program, demoStateBinding_audio, uLocation);
+		if ((uLocation = currentDemoProg->ubFrame) >= 0)
+			a3shaderUniformBlockBind(currentDemoProg->program, demoStateBinding_frame, uLocation);
+		if ((uLocation = currentDemoProg->ubObject) >= 0)
+			a3shaderUniformBlockBind(currentDemoProg->program, demoStateBinding_object, uLocation);
 	}
 
+	// per-frame audio data; filled whole by each audio update
+	a3bufferCreate(demoState->ubo_audio, a3buffer_uniform, sizeof(a3_DemoAudioBlock), demoState->audioBlock);
+
+	// per-frame scene data: room for the frame block and a full queue of 
+	//	object blocks, each starting on the driver's range alignment, 
+	//	plus the tail of the last run's range
+	i = a3demo_getUniformBufferAlignment();
+	j = (sizeof(a3_DemoObjectBlock) + i - 1) / i * i;
+	a3demo_createUniformStream(demoState->sceneUniforms, j * (demoRenderQueue_packetMax + 1) + sizeof(a3_DemoObjectBlock) * demoRenderBatch_drawMax, i);
+	a3bufferCreate(demoState->ubo_scene, a3buffer_uniform, demoState->sceneUniforms->size, 0);
+
+	// the scene shaders find their object by draw index if the driver 
+	//	has one, otherwise it is always 0 and each object is its own run
+	demoState->multiDrawIndirectSupported = a3demo_getMultiDrawIndirectSupport();
+	demoState->multiDrawIndirect = demoState->multiDrawIndirectSupported;
+
 
 	//done
 	a3shaderProgramDeactivate();
@@ -639,6 +737,8 @@ void a3demo_unloadGeometry(a3_DemoState *demoState)
 		a3vertexArrayReleaseDescriptor(currentVAO++);
 	while (currentDraw < endDraw)
 		a3vertexReleaseDrawable(currentDraw++);
+
+	a3demo_releaseInstanceBatch(demoState->sceneInstances);
 }
 
 
@@ -648,8 +748,15 @@ void a3demo_unloadShaders(a3_DemoState *demoState)
 	a3_DemoStateShaderProgram *currentProg = demoState->shaderProgram,
 		*const endProg = currentProg + demoStateMaxCount_shaderProgram;
 
+	a3_UniformBuffer *currentUBO = demoState->uniformBuffer,
+		*const endUBO = currentUBO + demoStateMaxCount_uniformBuffer;
+
 	while (currentProg < endProg)
 		a3shaderProgramRelease((currentProg++)->program);
+	while (currentUBO < endUBO)
+		a3bufferRelease(currentUBO++);
+
+	a3demo_releaseUniformStream(demoState->sceneUniforms);
 }
 
 
@@ -710,6 +817,10 @@ void a3demo_initScene(a3_DemoState *demoState)
 	demoState->displayDepth = 0;
 	demoState->displayGrid = 1;
 	demoState->displayAxes = 1;
+	demoState->displayVisualizer = 1;
+
+	demoState->instanceShape = demoStateInstance_sphere;
+	demoState->instanceCount = 1024;
 
 
 	// initialize other objects 
@@ -720,6 +831,9 @@ void a3demo_initScene(a3_DemoState *demoState)
 	fmod_init(demoState);
 
 	fmod_loadAudio(demoState);
+
+	// start analysis thread
+	fmod_startAnalysis(demoState);
 }
 
 
@@ -741,6 +855,8 @@ void a3demo_refresh(a3_DemoState *demoState)
 		*const endVAO = currentVAO + demoStateMaxCount_vertexArray;
 	a3_DemoStateShaderProgram *currentProg = demoState->shaderProgram,
 		*const endProg = currentProg + demoStateMaxCount_shaderProgram;
+	a3_UniformBuffer *currentUBO = demoState->uniformBuffer,
+		*const endUBO = currentUBO + demoStateMaxCount_uniformBuffer;
 
 	while (currentFBO < endFBO)
 		a3framebufferHandleUpdateReleaseCallback(currentFBO++);
@@ -752,6 +868,8 @@ void a3demo_refresh(a3_DemoState *demoState)
 		a3vertexArrayHandleUpdateReleaseCallback(currentVAO++);
 	while (currentProg < endProg)
 		a3shaderProgramHandleUpdateReleaseCallback((currentProg++)->program);
+	while (currentUBO < endUBO)
+		a3bufferHandleUpdateReleaseCallback(currentUBO++);
 }
 
 
@@ -771,6 +889,8 @@ void a3demo_validateUnload(const a3_DemoState *demoState)
 		*const endVAO = currentVAO + demoStateMaxCount_vertexArray;
 	const a3_DemoStateShaderProgram *currentProg = demoState->shaderProgram,
 		*const endProg = currentProg + demoStateMaxCount_shaderProgram;
+	const a3_UniformBuffer *currentUBO = demoState->uniformBuffer,
+		*const endUBO = currentUBO + demoStateMaxCount_uniformBuffer;
 
 	handle = 0;
 	currentFBO = demoState->framebuffer;
@@ -806,6 +926,13 @@ void a3demo_validateUnload(const a3_DemoState *demoState)
 		handle += (currentProg++)->program->handle->handle;
 	if (handle)
 		printf("\n A3 Warning: One or more shader programs not released.");
+
+	handle = 0;
+	currentUBO = demoState->uniformBuffer;
+	while (currentUBO < endUBO)
+		handle += (currentUBO++)->handle->handle;
+	if (handle)
+		printf("\n A3 Warning: One or more uniform buffers not released.");
 }
 
 
@@ -934,12 +1061,150 @@ void a3demo_update(a3_DemoState *demoState, double dt)
 	for (i = 0; i < demoStateMaxCount_camera; ++i)
 		a3demo_updateCameraViewProjection(demoState->camera + i);
 
+	// queue draws now that transforms are final
+	a3demo_queueScene(demoState);
+	a3demo_updateInstances(demoState);
+
 	// update audio data
 	fmod_updateAudioData(demoState);
 }
 
-void a3demo_render(const a3_DemoState *demoState)
+void a3demo_queueScene(a3_DemoState *demoState)
+{
+	const int useVerticalY = demoState->verticalAxis;
+
+	// each object's mesh, the axis correction it needs, and its diffuse 
+	//	and specular maps
+	const struct {
+		const a3_DemoSceneObject *sceneObject;
+		const a3_VertexDrawable *drawable;
+		const a3mat4 *axis;
+		const a3_Texture *tex_dm, *tex_sm;
+	} objects[] = {
+		{ demoState->groundObject, demoState->draw_groundPlane, 0, demoState->tex_stone_dm, demoState->tex_stone_dm },
+		{ demoState->sphereObject, demoState->draw_sphere, useVerticalY ? &a3demo_convertZ2Y : 0, demoState->tex_earth_dm, demoState->tex_earth_sm },
+		{ demoState->cylinderObject, demoState->draw_cylinder, &a3demo_convertZ2X, demoState->tex_checker, demoState->tex_checker },
+		{ demoState->torusObject, demoState->draw_torus, &a3demo_convertZ2X, demoState->tex_earth_dm, demoState->tex_earth_sm },
+		{ demoState->teapotObject, demoState->draw_teapot, useVerticalY ? 0 : &a3demo_convertY2Z, demoState->tex_checker, demoState->tex_checker },
+	};
+
+	// visualizer, or each object lit by its own block
+	const a3_DemoStateShaderProgram *const program = demoState->displayVisualizer ? demoState->prog_drawMusicVisualizer : demoState->prog_drawSceneObject;
+	const a3_DemoCamera *const camera = demoState->sceneCamera;
+
+	a3mat4 modelMat, modelMatInv;
+	a3_DemoRenderPacket *packet;
+	a3_DemoObjectBlock object;
+	unsigned int i;
+
+	// frame block goes first so its offset is the same every frame
+	demoState->frameBlock->viewProjectionMat = camera->viewProjectionMat;
+	demoState->frameBlock->lightPos_world = demoState->lightPos_world;
+	demoState->frameBlock->eyePos_world = demoState->cameraObject->modelMat.v3;
+	demoState->frameBlock->time = (float)demoState->timer->currentTick;
+	demoState->frameBlock->resolutionX = (float)demoState->windowWidth;
+	demoState->frameBlock->resolutionY = (float)demoState->windowHeight;
+	a3demo_resetUniformStream(demoState->sceneUniforms);
+	demoState->frameBlockOffset = a3demo_pushUniformStream(demoState->sceneUniforms, demoState->frameBlock, sizeof(a3_DemoFrameBlock));
+
+	a3demo_resetRenderQueue(demoState->sceneQueue);
+	for (i = 0; i < sizeof(objects) / sizeof(*objects); ++i)
+	{
+		//	- correct "up" axis if needed
+		//	- calculate full MVP matrix
+		//	- move lighting objects' positions into object space
+		if (objects[i].axis)
+			a3real4x4Product(modelMat.m, objects[i].sceneObject->modelMat.m, objects[i].axis->m);
+		else
+			modelMat = objects[i].sceneObject->modelMat;
+		a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
+		a3real4x4Product(object.modelViewProjectionMat.m, camera->viewProjectionMat.m, modelMat.m);
+		a3real4Real4x4Product(object.lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
+		a3real4Real4x4Product(object.eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
+
+		// clip w of the object's origin is its distance in front of the 
+		//	eye; nearer objects in the same state group draw first
+		packet = a3demo_pushRenderPacket(demoState->sceneQueue, 0, object.modelViewProjectionMat.v3.w / camera->zfar, program, objects[i].drawable, objects[i].tex_dm, objects[i].tex_sm);
+		if (packet)
+			packet->object = object;
+	}
+	a3demo_sortRenderQueue(demoState->sceneQueue);
+
+	// object blocks follow the frame block in draw order, grouped in runs
+	a3demo_stageRenderQueue(demoState->sceneQueue, demoState->sceneUniforms, demoState->multiDrawIndirect ? demoRenderBatch_drawMax : 1);
+}
+
+void a3demo_updateInstances(a3_DemoState *demoState)
+{
+	const int useVerticalY = demoState->verticalAxis;
+
+	// sphere is 2 units in radius, teapot about half that
+	const int teapot = demoState->instanceShape == demoStateInstance_teapot;
+	const a3mat4 *const axis = teapot ? (useVerticalY ? 0 : &a3demo_convertY2Z) : (useVerticalY ? &a3demo_convertZ2Y : 0);
+	const float scale = teapot ? 0.3f : 0.15f;
+	const float spacing = 0.5f, height = -3.0f;
+	const float time = (float)demoState->timer->currentTick;
+	const unsigned int count = demoState->instanceCount;
+
+	a3_DemoInstance *instance;
+	a3mat4 spinMat;
+	a3vec4 position;
+	float t, radius, angle, hue;
+	unsigned int i;
+
+	a3demo_resetInstanceBatch(demoState->sceneInstances);
+	if (demoState->instanceShape == demoStateInstance_off)
+		return;
+
+	for (i = 0; i < count; ++i)
+	{
+		instance = a3demo_pushInstance(demoState->sceneInstances);
+		if (!instance)
+			break;
+
+		// sunflower spiral over the ground: even spacing at any count, 
+		//	bass in the middle and treble at the edge
+		t = count > 1 ? (float)i / (float)(count - 1) : 0.0f;
+		radius = spacing * a3sqrtf((float)i);
+		angle = a3trigValid_sind(137.50776f * (float)i);
+
+		// each copy spins about the vertical at its own rate
+		if (useVerticalY)
+		{
+			a3real4x4SetRotateY(spinMat.m, a3trigValid_sind(time * (20.0f + 40.0f * t)));
+			a3real4Set(position.v, radius * a3cosd(angle), height, -radius * a3sind(angle), 1.0f);
+		}
+		else
+		{
+			a3real4x4SetRotateZ(spinMat.m, a3trigValid_sind(time * (20.0f + 40.0f * t)));
+			a3real4Set(position.v, radius * a3cosd(angle), radius * a3sind(angle), height, 1.0f);
+		}
+		if (axis)
+			a3real4x4Product(instance->modelMat.m, spinMat.m, axis->m);
+		else
+			instance->modelMat = spinMat;
+		a3real3MulS(instance->modelMat.v0.v, scale);
+		a3real3MulS(instance->modelMat.v1.v, scale);
+		a3real3MulS(instance->modelMat.v2.v, scale);
+		instance->modelMat.v3 = position;
+
+		// hue follows the band, low red through high blue
+		hue = 240.0f * t;
+		a3real4Set(instance->color.v,
+			0.5f + 0.5f * a3cosd(hue),
+			0.5f + 0.5f * a3cosd(hue - 120.0f),
+			0.5f + 0.5f * a3cosd(hue - 240.0f),
+			1.0f);
+		instance->phase = t;
+		instance->band = (float)(unsigned int)(t * (float)(demoAudioFrame_bandCount - 1) + 0.5f);
+		instance->amount = 0.5f;
+		instance->reserved = 0.0f;
+	}
+}
+
+void a3demo_render(a3_DemoState *demoState)
 {
+	a3_DemoGraphicsState *const graphicsState = demoState->graphicsState;
 	const a3_VertexDrawable *currentDrawable;
 	const a3_DemoStateShaderProgram *currentDemoProgram;
 
@@ -976,42 +1241,22 @@ void a3demo_render(const a3_DemoState *demoState)
 	*const grey = rgba4 + 32, *const grey_t = rgba4 + 36;
 
 
-	// model transformations (if needed)
-	const a3mat4 convertY2Z = {
-		+1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, +1.0f, 0.0f,
-		0.0f, -1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, +1.0f,
-	};
-	const a3mat4 convertZ2Y = {
-		+1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, -1.0f, 0.0f,
-		0.0f, +1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, +1.0f,
-	};
-	const a3mat4 convertZ2X = {
-		0.0f, 0.0f, -1.0f, 0.0f,
-		0.0f, +1.0f, 0.0f, 0.0f,
-		+1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, +1.0f,
-	};
-
 	// final model matrix and full matrix stack
-	a3mat4 modelMat = a3identityMat4, modelMatInv = a3identityMat4, modelMatOrig = a3identityMat4,
-		modelViewProjectionMat = a3identityMat4;
+	a3mat4 modelMatInv = a3identityMat4, modelViewProjectionMat = a3identityMat4;
 
-	// tmp lighting vectors
-	a3vec4 lightPos_obj, eyePos_obj;
-
-	// current scene object being rendered, for convenience
-	const a3_DemoSceneObject *currentSceneObject;
+	// what drawing the scene queue bound, and what it saved
+	a3_DemoRenderQueueStats queueStats[1] = { 0 };
 
 
 	// ****TO-DO: 
 	//	- activate framebuffer (...instead of...)
 	// reset viewport and clear buffers
 	//	a3framebufferDeactivateSetViewport(a3fbo_depth24, -demoState->frameBorder, -demoState->frameBorder, demoState->frameWidth, demoState->frameHeight);
-	a3framebufferActivate(demoState->fbo_scene);
+	// binds below go through the state cache; anything bound outside it 
+	//	(e.g. by the text renderer last frame) is forgotten first
+	a3demo_invalidateGraphicsState(graphicsState);
+	a3demo_resetGraphicsStateStats(graphicsState);
+	a3demo_setGraphicsFramebuffer(graphicsState, demoState->fbo_scene);
 
 	// clearing is expensive!
 	// instead, draw skybox and force depth to farthest possible value in scene
@@ -1021,168 +1266,65 @@ void a3demo_render(const a3_DemoState *demoState)
 
 	// draw skybox with texture, inverted
 	currentDemoProgram = demoState->prog_drawTexture;
-	a3shaderProgramActivate(currentDemoProgram->program);
+	a3demo_setGraphicsProgram(graphicsState, currentDemoProgram->program);
 	currentDrawable = demoState->draw_skybox;
 	modelMatInv = demoState->camera->sceneObject->modelMatInv;
 	modelMatInv.v3 = a3wVec4;
 	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->projectionMat.m, modelMatInv.m);
 	if (!useVerticalY)	// need to rotate box if Z-up
-		a3real4x4ConcatL(modelViewProjectionMat.m, convertY2Z.m);
+		a3real4x4ConcatL(modelViewProjectionMat.m, a3demo_convertY2Z.m);
 	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
 	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, skyblue);
-	a3textureActivate(demoState->tex_sky_clouds, a3tex_unit00);
+	a3demo_setGraphicsTexture(graphicsState, demoState->tex_sky_clouds, a3tex_unit00);
 
-	glDepthFunc(GL_ALWAYS);
-	glCullFace(GL_FRONT);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
-	glCullFace(GL_BACK);
-	glDepthFunc(GL_LEQUAL);
+	a3demo_setGraphicsDepth(graphicsState, 1, GL_ALWAYS);
+	a3demo_setGraphicsCull(graphicsState, 1, GL_FRONT);
+	a3demo_drawGraphicsDrawable(graphicsState, currentDrawable);
+	a3demo_setGraphicsCull(graphicsState, 1, GL_BACK);
+	a3demo_setGraphicsDepth(graphicsState, 1, GL_LEQUAL);
 
 
 	if (demoState->displayGrid)
 	{
 		// draw grid aligned to world
 		currentDemoProgram = demoState->prog_drawColorUnif;
-		a3shaderProgramActivate(currentDemoProgram->program);
+		a3demo_setGraphicsProgram(graphicsState, currentDemoProgram->program);
 		currentDrawable = demoState->draw_grid;
 		modelViewProjectionMat = demoState->camera->viewProjectionMat;
 		if (useVerticalY)
-			a3real4x4ConcatL(modelViewProjectionMat.m, convertZ2Y.m);
+			a3real4x4ConcatL(modelViewProjectionMat.m, a3demo_convertZ2Y.m);
 		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
 		a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uColor, 1, gridColor);
-		a3vertexActivateAndRenderDrawable(currentDrawable);
+		a3demo_drawGraphicsDrawable(graphicsState, currentDrawable);
 	}
 
 
-	// draw objects: 
-	//	- correct "up" axis if needed
-	//	- calculate full MVP matrix
-	//	- move lighting objects' positions into object space
-	//	- send uniforms
-	//	- draw
-
-	// draw models
-	//	currentDemoProgram = demoState->prog_drawPhong;
-
-	// ****TO-DO
-	// Add some sort of if statement here to switch between the two shader programs
-	currentDemoProgram = demoState->prog_drawMusicVisualizer;
-
-	a3shaderProgramActivate(currentDemoProgram->program);
-
-	//a3vec2 resolution;
-	//resolution.x = (int)demoState->windowWidth;
-	//resolution.y = (int)demoState->windowHeight;
-
-	// Send Uniforms we need here
-	a3shaderUniformSendDouble(a3unif_single, currentDemoProgram->uTime, 1, &demoState->timer->currentTick);
-	a3shaderUniformSendFloat(a3unif_single, currentDemoProgram->uSpectrumData, 256, demoState->spectrum_data);
-	a3shaderUniformSendFloat(a3unif_single, currentDemoProgram->uWaveData, 256, demoState->wave_data);
-//	a3shaderUniformSendFloat(a3unif_vec2, currentDemoProgram->uResolution, 1, (float)&demoState->windowWidth, &demoState->windowHeight);
-	a3shaderUniformSendInt(a3unif_single, currentDemoProgram->uResX, 1, &demoState->windowWidth);
-	a3shaderUniformSendInt(a3unif_single, currentDemoProgram->uResY, 1, &demoState->windowHeight);
-
-	// ground
-	currentDrawable = demoState->draw_groundPlane;
-	currentSceneObject = demoState->groundObject;
-
-	modelMat = currentSceneObject->modelMat;
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-	a3real4Real4x4Product(lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
-	a3real4Real4x4Product(eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
-
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uLightPos_obj, 1, lightPos_obj.v);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uEyePos_obj, 1, eyePos_obj.v);
-	a3textureActivate(demoState->tex_stone_dm, a3tex_unit00);
-	a3textureActivate(demoState->tex_stone_dm, a3tex_unit01);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
-
-	// sphere
-	currentDrawable = demoState->draw_sphere;
-	currentSceneObject = demoState->sphereObject;
-
-	modelMatOrig = currentSceneObject->modelMat;
-	if (useVerticalY)	// sphere's axis is Z
-		a3real4x4Product(modelMat.m, modelMatOrig.m, convertZ2Y.m);
-	else
-		modelMat = modelMatOrig;
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-	a3real4Real4x4Product(lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
-	a3real4Real4x4Product(eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
-
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uLightPos_obj, 1, lightPos_obj.v);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uEyePos_obj, 1, eyePos_obj.v);
-	a3textureActivate(demoState->tex_earth_dm, a3tex_unit00);
-	a3textureActivate(demoState->tex_earth_sm, a3tex_unit01);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
-
-	// cylinder
-	currentDrawable = demoState->draw_cylinder;
-	currentSceneObject = demoState->cylinderObject;
-
-	modelMatOrig = currentSceneObject->modelMat;
-	a3real4x4Product(modelMat.m, modelMatOrig.m, convertZ2X.m);
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-	a3real4Real4x4Product(lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
-	a3real4Real4x4Product(eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
+	// draw objects queued in update; every uniform they read was staged 
+	//	there and goes up in one write, then each run binds its own 
+	//	object blocks along with whatever state changed
+	a3demo_setGraphicsTexture(graphicsState, demoState->tex_spectrogram, a3tex_unit02);
+	a3shaderUniformBufferActivate(demoState->ubo_audio, demoStateBinding_audio);
+	a3demo_uploadUniformStream(demoState->sceneUniforms, demoState->ubo_scene);
+	if (demoState->frameBlockOffset >= 0)
+		a3demo_setGraphicsUniformRange(graphicsState, demoState->ubo_scene, demoStateBinding_frame, demoState->frameBlockOffset, sizeof(a3_DemoFrameBlock));
+	a3demo_drawRenderQueue(demoState->sceneQueue, graphicsState, demoState->ubo_scene, demoStateBinding_object, demoState->vbo_sceneCommands, 0, 0, queueStats);
 
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uLightPos_obj, 1, lightPos_obj.v);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uEyePos_obj, 1, eyePos_obj.v);
-	a3textureActivate(demoState->tex_checker, a3tex_unit00);
-	a3textureActivate(demoState->tex_checker, a3tex_unit01);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
-
-	// torus
-	currentDrawable = demoState->draw_torus;
-	currentSceneObject = demoState->torusObject;
-
-	modelMatOrig = currentSceneObject->modelMat;
-	a3real4x4Product(modelMat.m, modelMatOrig.m, convertZ2X.m);
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-	a3real4Real4x4Product(lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
-	a3real4Real4x4Product(eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
-
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uLightPos_obj, 1, lightPos_obj.v);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uEyePos_obj, 1, eyePos_obj.v);
-	a3textureActivate(demoState->tex_earth_dm, a3tex_unit00);
-	a3textureActivate(demoState->tex_earth_sm, a3tex_unit01);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
-
-	// teapot
-	currentDrawable = demoState->draw_teapot;
-	currentSceneObject = demoState->teapotObject;
-
-	modelMatOrig = currentSceneObject->modelMat;
-	if (!useVerticalY)	// teapot's axis is Y
-		a3real4x4Product(modelMat.m, modelMatOrig.m, convertY2Z.m);
-	else
-		modelMat = modelMatOrig;
-	a3real4x4TransformInverseIgnoreScale(modelMatInv.m, modelMat.m);
-	a3real4x4Product(modelViewProjectionMat.m, demoState->camera->viewProjectionMat.m, modelMat.m);
-	a3real4Real4x4Product(lightPos_obj.v, modelMatInv.m, demoState->lightPos_world.v);
-	a3real4Real4x4Product(eyePos_obj.v, modelMatInv.m, demoState->cameraObject->modelMat.v3.v);
-
-	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uLightPos_obj, 1, lightPos_obj.v);
-	a3shaderUniformSendFloat(a3unif_vec4, currentDemoProgram->uEyePos_obj, 1, eyePos_obj.v);
-	a3textureActivate(demoState->tex_checker, a3tex_unit00);
-	a3textureActivate(demoState->tex_checker, a3tex_unit01);
-	a3vertexActivateAndRenderDrawable(currentDrawable);
+	// instanced field: every copy in one call, reading the frame and audio 
+	//	blocks already bound
+	if (a3demo_uploadInstanceBatch(demoState->sceneInstances, demoState->vbo_sceneInstances) > 0)
+	{
+		currentDemoProgram = demoState->prog_drawInstanced;
+		currentDrawable = demoState->instanceShape == demoStateInstance_teapot ? demoState->draw_teapot : demoState->draw_sphere;
+		a3demo_setGraphicsProgram(graphicsState, currentDemoProgram->program);
+		a3demo_drawGraphicsDrawableInstanced(graphicsState, currentDrawable, demoState->sceneInstances->count);
+	}
 
 	glDisable(GL_STENCIL_TEST);
 
 
 	// scene is rendered, draw other modes using resulting textures
 	// deactivate active FBO, use full frame
-	a3framebufferDeactivateSetViewport(a3fbo_depthDisable, -demoState->frameBorder, -demoState->frameBorder, demoState->frameWidth, demoState->frameHeight);
+	a3demo_setGraphicsDefaultFramebuffer(graphicsState, a3fbo_depthDisable, -demoState->frameBorder, -demoState->frameBorder, demoState->frameWidth, demoState->frameHeight);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -1191,41 +1333,42 @@ void a3demo_render(const a3_DemoState *demoState)
 		a3framebufferBindDepthTexture(demoState->fbo_scene, a3tex_unit00);
 	else
 		a3framebufferBindColorTexture(demoState->fbo_scene, a3tex_unit00, demoState->demoMode);
+	a3demo_forgetGraphicsTexture(graphicsState, a3tex_unit00);
 
 	// display previously rendered scene on FSQ
 	// do not clear since we are drawing a FULL-SCREEN QUAD
 	// render FSQ with texture
 	// use simple texturing program
 	currentDemoProgram = demoState->prog_drawTexture;
-	a3shaderProgramActivate(currentDemoProgram->program);
+	a3demo_setGraphicsProgram(graphicsState, currentDemoProgram->program);
 	a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, a3identityMat4.mm);
 	currentDrawable = demoState->draw_fsq;
-	a3vertexActivateAndRenderDrawable(currentDrawable);
+	a3demo_drawGraphicsDrawable(graphicsState, currentDrawable);
 
 	if (demoState->displayAxes)
 	{
-		glDisable(GL_DEPTH_TEST);
+		a3demo_setGraphicsDepth(graphicsState, 0, GL_LEQUAL);
 
 		// draw coordinate axes in front of everything
 		currentDemoProgram = demoState->prog_drawColor;
-		a3shaderProgramActivate(currentDemoProgram->program);
+		a3demo_setGraphicsProgram(graphicsState, currentDemoProgram->program);
 		currentDrawable = demoState->draw_axes;
-		a3vertexActivateDrawable(currentDrawable);
 
 		// center of world
 		modelViewProjectionMat = demoState->camera->viewProjectionMat;
 		a3shaderUniformSendFloatMat(a3unif_mat4, 0, currentDemoProgram->uMVP, 1, modelViewProjectionMat.mm);
-		a3vertexRenderActiveDrawable();
+		a3demo_drawGraphicsDrawable(graphicsState, currentDrawable);
 
-		glEnable(GL_DEPTH_TEST);
+		a3demo_setGraphicsDepth(graphicsState, 1, GL_LEQUAL);
 	}
 
 
 	// deactivate things
 	a3vertexDeactivateDrawable();
-	a3shaderProgramDeactivate();
-	a3textureDeactivate(a3tex_unit01);
-	a3textureDeactivate(a3tex_unit00);
+	a3demo_setGraphicsProgram(graphicsState, 0);
+	a3demo_setGraphicsTexture(graphicsState, 0, a3tex_unit02);
+	a3demo_setGraphicsTexture(graphicsState, 0, a3tex_unit01);
+	a3demo_setGraphicsTexture(graphicsState, 0, a3tex_unit00);
 
 
 	// HUD
@@ -1251,8 +1394,18 @@ void a3demo_render(const a3_DemoState *demoState)
 			"TMP FUcK Music Visualizer straight up BOOLIN my guy"
 		};
 
+		const char *instanceShapeText[demoStateInstance_shapeCount] = {
+			"(off)",
+			"spheres",
+			"teapots",
+		};
+
 		const float col = (!demoState->displayDepth) ? 1.0f : 0.0f;
 
+		// counted before the text renderer binds its own state
+		const unsigned int issued = a3demo_getGraphicsStateIssued(graphicsState);
+		const unsigned int skipped = a3demo_getGraphicsStateSkipped(graphicsState);
+
 
 		glDisable(GL_DEPTH_TEST);
 
@@ -1270,6 +1423,15 @@ void a3demo_render(const a3_DemoState *demoState)
 
 		a3textDraw(demoState->text, -0.98f, +0.60f, -1.0f, col, col, col, 1.0f,
 			"GRID in scene (toggle = 'g') %d | AXES overlay ('x') %d", demoState->displayGrid, demoState->displayAxes);
+		a3textDraw(demoState->text, -0.98f, +0.50f, -1.0f, col, col, col, 1.0f,
+			"SCENE objects %u in %u draws, visualizer %d ('v'), indirect %d ('m') | binds: program %u, vertex array %u, texture %u | skipped %u", 
+			queueStats->objects, queueStats->draws, demoState->displayVisualizer, demoState->multiDrawIndirect, queueStats->programBinds, queueStats->vertexArrayBinds, queueStats->textureBinds, queueStats->bindsSkipped);
+		a3textDraw(demoState->text, -0.98f, +0.40f, -1.0f, col, col, col, 1.0f,
+			"GL STATE calls issued %u | skipped %u", 
+			issued, skipped);
+		a3textDraw(demoState->text, -0.98f, +0.30f, -1.0f, col, col, col, 1.0f,
+			"INSTANCES %u %s in one draw (shape = 'i', count = '[' ']')", 
+			demoState->sceneInstances->count, instanceShapeText[demoState->instanceShape]);
 
 
 		// display controls
@@ -1304,6 +1466,20 @@ void a3demo_render(const a3_DemoState *demoState)
 // FMOD functions -----------------------------------------------------
 void fmod_init(a3_DemoState *demoState/*params*/)
 {
+	// null output device plays at this rate; raise it to run analysis 
+	//	faster than real time
+	demoState->audioSpeed = 1.0;
+
+	// output buffering plus one display refresh; beat-synchronous visuals
+	//	are predicted this far ahead so they land with the sound
+	demoState->audioLatency = 0.05;
+
+	// 16-bit tracks can skip float conversion and go through the integer
+	//	transform instead; worth it where float throughput is the 
+	//	bottleneck, within 100 dB of the float path otherwise
+	demoState->audioIntegerFFT = 0;
+
+#ifndef A3_DEMO_NULL_AUDIO
 	// Initialize FMOD audio - Vedant
 	FMOD_System_Create(&demoState->audio_system);
 
@@ -1311,32 +1487,584 @@ void fmod_init(a3_DemoState *demoState/*params*/)
 	//FMOD_System_SetSpeakerMode(demoState->audio_system, demoState->speakerMode);
 	
 	demoState->channel = 0;
-	FMOD_System_Init(demoState->audio_system, 32, FMOD_INIT_NORMAL, 0);
+
+	// no sound hardware: audio goes to the null device instead
+	if (FMOD_System_Init(demoState->audio_system, 32, FMOD_INIT_NORMAL, 0) != FMOD_OK)
+	{
+		FMOD_System_Release(demoState->audio_system);
+		demoState->audio_system = 0;
+	}
+#endif	// !A3_DEMO_NULL_AUDIO
 }
 
 void fmod_loadAudio(a3_DemoState *demoState/*params*/)
 {
 	demoState->audio_path = "../../../../resource/audio/archer-theme-song.wav";
 
-	FMOD_System_CreateSound(demoState->audio_system, demoState->audio_path, FMOD_HARDWARE, 0, &demoState->sound);
-	FMOD_Sound_SetMode(demoState->sound, FMOD_LOOP_OFF);
-	FMOD_System_PlaySound(demoState->audio_system, FMOD_CHANNEL_FREE, demoState->sound, 1, &demoState->channel);
+	// WAV files are read straight from a mapping; that feeds the cache 
+	//	and, when FMOD is not playing, the null device
+	a3demo_openWaveFile(demoState->audioWave, demoState->audio_path);
+
+#ifndef A3_DEMO_NULL_AUDIO
+	if (demoState->audio_system)
+	{
+		FMOD_System_CreateSound(demoState->audio_system, demoState->audio_path, FMOD_HARDWARE, 0, &demoState->sound);
+		FMOD_Sound_SetMode(demoState->sound, FMOD_LOOP_OFF);
+		FMOD_System_PlaySound(demoState->audio_system, FMOD_CHANNEL_FREE, demoState->sound, 1, &demoState->channel);
+	}
+	if (!demoState->channel)
+#endif	// !A3_DEMO_NULL_AUDIO
+	if (a3demo_initNullDevice(demoState->audioDevice, demoState->audioWave, demoState->audioSpeed) > 0)
+		a3demo_playNullDevice(demoState->audioDevice, 1);
+
+	// precomputed analysis, keyed by the file's contents; on first load of 
+	//	a track, starting analysis builds it in the background
+	*demoState->audioCachePath = 0;
+	if (a3demo_hashAudioFile(demoState->audio_path, &demoState->audioCacheHashLo, &demoState->audioCacheHashHi) > 0 &&
+		a3demo_getAudioCachePath(demoState->audioCachePath, sizeof(demoState->audioCachePath), demoState->audioCacheHashLo, demoState->audioCacheHashHi) > 0)
+		a3demo_openAudioCache(demoState->audioCache, demoState->audioCachePath, demoState->audioCacheHashLo, demoState->audioCacheHashHi);
+}
+
+int fmod_buildAudioCacheJob(a3_DemoState *demoState, const a3_DemoAudioJob *job)
+{
+	// called on the job thread; decodes the mapped WAV if there is one, 
+	//	otherwise lets FMOD decode a copy of the track
+	a3_DemoAudioDecoder decoder[1] = { 0 };
+	int result;
+#ifndef A3_DEMO_NULL_AUDIO
+	fmod_Decoder fmodDecoder[1] = { 0 };
+	if (demoState->audioWave->pcm || fmod_openDecoder(demoState, fmodDecoder, decoder) <= 0)
+#endif	// !A3_DEMO_NULL_AUDIO
+		a3demo_setWaveFileDecoder(decoder, demoState->audioWave);
+	result = fmod_buildAudioCache(decoder, demoState->audioCachePath, demoState->audioCacheHashLo, demoState->audioCacheHashHi, job);
+#ifndef A3_DEMO_NULL_AUDIO
+	fmod_closeDecoder(fmodDecoder);
+#endif	// !A3_DEMO_NULL_AUDIO
+	return result;
+}
+
+int fmod_buildAudioCache(const a3_DemoAudioDecoder *decoder, const char *cachePath, const unsigned int hashLo, const unsigned int hashHi, const a3_DemoAudioJob *job_opt)
+{
+	// same settings as live analysis
+	enum { hopSize = 512 };
+	a3_FileStream fileStream[1] = { 0 };
+	a3_DemoAudioCacheHeader header[1] = { 0 };
+	a3_DemoAudioCacheHop hop[1];
+	a3_DemoAudioFrame frame[1];
+	a3_DemoSTFT stft[1] = { 0 };
+	a3_DemoBeatTracker beat[1];
+	a3_DemoAudioFeatureExtractor features[1];
+	a3_DemoLoudnessMeter loudness[1];
+	a3_DemoHPSS hpss[1] = { 0 };
+	a3_DemoChromaAnalyzer chroma[1];
+	float *left, *right;
+	int result = 0;
+	unsigned int i;
+
+	if (decoder->readFunc && decoder->sampleRate && decoder->length &&
+		a3demo_createAudioSTFT(stft, (float)decoder->sampleRate) > 0 &&
+		a3demo_initBeatTracker(beat, (double)decoder->sampleRate / hopSize, demoAudioFrame_bandCount) > 0 &&
+		a3demo_initAudioFeatureExtractor(features, stft->resolution[a3audio_main].bins, (float)decoder->sampleRate) > 0 &&
+		a3demo_initLoudnessMeter(loudness, (float)decoder->sampleRate, decoder->channelCount > 1 ? 2 : 1) > 0 &&
+		a3demo_createHPSS(hpss, stft->resolution[a3audio_main].bins, 17, 17) > 0 &&
+		a3demo_initChromaAnalyzer(chroma, stft->resolution[a3audio_bass].bins, (float)decoder->sampleRate, (double)decoder->sampleRate / hopSize, 65.0f, 4200.0f, 4.0f) > 0 &&
+		a3fileStreamOpenWrite(fileStream, cachePath) > 0)
+	{
+		header->magic = demoAudioCache_magic;
+		header->version = demoAudioCache_version;
+		header->hashLo = hashLo;
+		header->hashHi = hashHi;
+		header->sampleRate = decoder->sampleRate;
+		header->hopSize = hopSize;
+		header->transformSize = stft->resolution[a3audio_main].size;
+		header->hopCount = decoder->length / hopSize + 1;
+		header->channelCount = demoAudioFrame_channelCount;
+		header->bandCount = demoAudioFrame_bandCount;
+		header->hopBytes = sizeof(a3_DemoAudioCacheHop);
+		a3fileStreamWriteObject(fileStream, header, (a3_FileStreamWriteFunc)a3demo_saveAudioCacheHeaderBinary);
+
+		// hop i is the window ending at sample i * hopSize; push one hop of
+		//	decoded audio into the ring each time; a job stopped part way 
+		//	leaves a short file, which does not open and is built again
+		left = stft->input + hopSize * a3audio_left;
+		right = stft->input + hopSize * a3audio_right;
+		memset(frame, 0, sizeof(frame));
+		for (i = 0; i < header->hopCount && (!job_opt || a3demo_isAudioJobRunning(job_opt) > 0); ++i)
+		{
+			if (i)
+			{
+				decoder->readFunc(decoder->data, left, right, (i - 1) * hopSize, hopSize);
+				a3demo_pushAudioSTFT(stft, hopSize);
+			}
+			a3demo_analyzeAudioHop(stft, beat, features, loudness, hpss, chroma, i ? hopSize : 0, 0, frame);
+			a3demo_storeAudioCacheHop(hop, frame);
+			a3fileStreamWriteObject(fileStream, hop, (a3_FileStreamWriteFunc)a3demo_saveAudioCacheHopBinary);
+		}
+		a3fileStreamClose(fileStream);
+		result = i == header->hopCount;
+	}
+
+	a3demo_releaseSTFT(stft);
+	a3demo_releaseHPSS(hpss);
+	return result;
+}
+
+void fmod_releaseAudio(a3_DemoState *demoState)
+{
+	a3demo_closeAudioCache(demoState->audioCache);
+	a3demo_closeWaveFile(demoState->audioWave);
+	memset(demoState->audioDevice, 0, sizeof(demoState->audioDevice));
 }
 
 void fmod_unload(const a3_DemoState *demoState/*params*/)
 {
+#ifndef A3_DEMO_NULL_AUDIO
 	// Unload FMOD - Vedant
-	FMOD_System_Close(demoState->audio_system);
+	if (demoState->audio_system)
+		FMOD_System_Close(demoState->audio_system);
+#endif	// !A3_DEMO_NULL_AUDIO
+}
+
+#ifndef A3_DEMO_NULL_AUDIO
+int fmod_readChannelWave(a3_DemoState *demoState, float *samples_out, const unsigned int count, const unsigned int channel)
+{
+	return FMOD_Channel_GetWaveData(demoState->channel, samples_out, (int)count, (int)channel) == FMOD_OK;
+}
+
+int fmod_getChannelPosition(a3_DemoState *demoState, unsigned int *position_out)
+{
+	return FMOD_Channel_GetPosition(demoState->channel, position_out, FMOD_TIMEUNIT_PCM) == FMOD_OK;
+}
+
+int fmod_openDecoder(a3_DemoState *demoState, fmod_Decoder *fmodDecoder_out, a3_DemoAudioDecoder *decoder_out)
+{
+	// decode without playing; only 16-bit and float are handled
+	FMOD_SOUND_FORMAT format = FMOD_SOUND_FORMAT_NONE;
+	float frequency = 0.0f;
+	int channels = 0, bits = 0;
+	unsigned int length = 0;
+
+	if (!demoState->audio_system ||
+		FMOD_System_CreateSound(demoState->audio_system, demoState->audio_path, FMOD_SOFTWARE | FMOD_OPENONLY | FMOD_ACCURATETIME, 0, &fmodDecoder_out->sound) != FMOD_OK)
+		return 0;
+	FMOD_Sound_GetFormat(fmodDecoder_out->sound, 0, &format, &channels, &bits);
+	FMOD_Sound_GetDefaults(fmodDecoder_out->sound, &frequency, 0, 0, 0);
+	FMOD_Sound_GetLength(fmodDecoder_out->sound, &length, FMOD_TIMEUNIT_PCM);
+	if ((format == FMOD_SOUND_FORMAT_PCM16 || format == FMOD_SOUND_FORMAT_PCMFLOAT) && channels > 0 && frequency > 0.0f)
+	{
+		fmodDecoder_out->format = format;
+		fmodDecoder_out->channels = (unsigned int)channels;
+		fmodDecoder_out->bytesPerFrame = (unsigned int)(channels * bits / 8);
+		fmodDecoder_out->cursor = 0;
+		decoder_out->readFunc = (a3_DemoAudioDecoderReadFunc)fmod_readDecoder;
+		decoder_out->data = fmodDecoder_out;
+		decoder_out->sampleRate = (unsigned int)frequency;
+		decoder_out->channelCount = (unsigned int)channels;
+		decoder_out->length = length;
+		return 1;
+	}
+	fmod_closeDecoder(fmodDecoder_out);
+	return 0;
+}
+
+int fmod_readDecoder(fmod_Decoder *fmodDecoder, float *left_out, float *right_out, const unsigned int first, const unsigned int count)
+{
+	const unsigned int channels = fmodDecoder->channels, last = channels - 1;
+	unsigned int total = 0, bytesRead, frames, i;
+	union {
+		short pcm16[4096];
+		float pcmFloat[2048];
+	} pcm;
+
+	// decoding is sequential; only seek when asked to jump
+	if (first != fmodDecoder->cursor && FMOD_Sound_SeekData(fmodDecoder->sound, first) == FMOD_OK)
+		fmodDecoder->cursor = first;
+	while (total < count)
+	{
+		frames = (sizeof(pcm) / fmodDecoder->bytesPerFrame < count - total) ? (unsigned int)sizeof(pcm) / fmodDecoder->bytesPerFrame : count - total;
+		bytesRead = 0;
+		FMOD_Sound_ReadData(fmodDecoder->sound, &pcm, frames * fmodDecoder->bytesPerFrame, &bytesRead);
+		frames = bytesRead / fmodDecoder->bytesPerFrame;
+		if (!frames)
+			break;
+		for (i = 0; i < frames; ++i)
+		{
+			if (fmodDecoder->format == FMOD_SOUND_FORMAT_PCM16)
+			{
+				left_out[total + i] = (float)pcm.pcm16[i * channels] / 32768.0f;
+				right_out[total + i] = (float)pcm.pcm16[i * channels + last] / 32768.0f;
+			}
+			else
+			{
+				left_out[total + i] = pcm.pcmFloat[i * channels];
+				right_out[total + i] = pcm.pcmFloat[i * channels + last];
+			}
+		}
+		total += frames;
+	}
+	fmodDecoder->cursor += total;
+
+	// past the end
+	for (i = total; i < count; ++i)
+		left_out[i] = right_out[i] = 0.0f;
+	return (int)total;
+}
+
+void fmod_closeDecoder(fmod_Decoder *fmodDecoder)
+{
+	if (fmodDecoder->sound)
+		FMOD_Sound_Release(fmodDecoder->sound);
+	memset(fmodDecoder, 0, sizeof(fmod_Decoder));
+}
+#endif	// !A3_DEMO_NULL_AUDIO
+
+void fmod_bindAudioSource(a3_DemoState *demoState)
+{
+	// source and device hold addresses in the state and functions in this 
+	//	library, both of which move on hotload, so bind before every start
+	a3_DemoAudioSource *const source = demoState->audioSource;
+	memset(source, 0, sizeof(a3_DemoAudioSource));
+
+#ifndef A3_DEMO_NULL_AUDIO
+	if (demoState->channel)
+	{
+		float frequency = 0.0f;
+		int channels = 0;
+		FMOD_Sound_GetFormat(demoState->sound, 0, 0, &channels, 0);
+		FMOD_Sound_GetDefaults(demoState->sound, &frequency, 0, 0, 0);
+		source->waveFunc = (a3_DemoAudioSourceWaveFunc)fmod_readChannelWave;
+		source->positionFunc = (a3_DemoAudioSourcePositionFunc)fmod_getChannelPosition;
+		source->data = demoState;
+		source->sampleRate = (unsigned int)frequency;
+		source->channelCount = (unsigned int)channels;
+		return;
+	}
+#endif	// !A3_DEMO_NULL_AUDIO
+
+	if (demoState->audioDevice->wave)
+	{
+		demoState->audioDevice->wave = demoState->audioWave;
+		a3demo_setNullDeviceSource(source, demoState->audioDevice);
+	}
 }
 
 void fmod_updateAudioData(a3_DemoState *demoState/*params*/)
 {
 	// update audio data - Vedant
-	// FMOD_Channel_GetSpectrum(demoState->channel, demoState->spectrum_data, 256, 0, FMOD_DSP_FFT_WINDOW_TRIANGLE);
-	// FMOD_DSP_GetParameterData(FMOD_DSP_FFT_SPECTRUMDATA, 1, (void **)&demoState->fft, 1024, demoState->spectrum_data, 256)
-	// Get Wave and Spectrum Data
-	FMOD_Channel_GetWaveData(demoState->channel, demoState->wave_data, 256, 0);
-	FMOD_Channel_GetSpectrum(demoState->channel, demoState->spectrum_data, 256, 0, FMOD_DSP_FFT_WINDOW_TRIANGLE);
+	// analysis happens on its own thread at a higher rate than rendering;
+	//	summarize every hop since the last update so transients between
+	//	ticks are not lost
+	a3_DemoAudioAggregate *const aggregate = demoState->audioAggregate;
+	a3_DemoAudioBlock *const block = demoState->audioBlock;
+	a3_DemoAudioFrame frame[1];
+	const double now = demoState->renderTimer->totalTime;
+	const double speed = demoState->audioSource->data == demoState->audioDevice ? demoState->audioDevice->speed : 1.0;
+
+	// cache finished building: restart analysis so it looks hops up 
+	//	instead of computing them; the analysis thread reads the cache, so 
+	//	it is only opened while that thread is stopped
+	if (a3demo_pollAudioJob(demoState->audioCacheJob) > 0)
+	{
+		fmod_stopAnalysis(demoState);
+		if (a3demo_openAudioCache(demoState->audioCache, demoState->audioCachePath, demoState->audioCacheHashLo, demoState->audioCacheHashHi) <= 0)
+			*demoState->audioCachePath = 0;
+		fmod_startAnalysis(demoState);
+	}
+
+	if (a3demo_consumeAudioFrames(demoState->audioAnalysis, aggregate, frame) > 0)
+	{
+		memcpy(block->bands, aggregate->bandPeak[a3audio_mid], sizeof(block->bands));
+		memcpy(block->wave, frame->wave, sizeof(block->wave));
+
+		// one row per update instead of re-sending the whole array; 
+		//	shaders read history back from the newest row
+		a3textureReplaceData(demoState->tex_spectrogram, 0, demoState->spectrogramRow, demoStateSpectrogram_width, 1, block->bands, 0);
+		block->spectrogramOffset = ((float)demoState->spectrogramRow + 0.5f) / (float)demoStateSpectrogram_height;
+		demoState->spectrogramRow = (demoState->spectrogramRow + 1) % demoStateSpectrogram_height;
+
+		demoState->audioFrameTime = frame->timestamp;
+		demoState->audioFrameReceived = now;
+		demoState->audioBeatPhase = frame->beatPhase;
+		block->onsetStrength = aggregate->onsetStrengthPeak;
+		block->onsetCount = (int)aggregate->onsetCount;
+		block->tempo = frame->tempo;
+
+		// levels are averaged over the hops, change is its peak so short
+		//	hits are not smoothed away
+		block->rms = aggregate->featureMean.rms;
+		block->zeroCrossingRate = aggregate->featureMean.zeroCrossingRate;
+		block->centroid = aggregate->featureMean.centroid;
+		block->rolloff = aggregate->featureMean.rolloff;
+		block->flatness = aggregate->featureMean.flatness;
+		block->flux = aggregate->featurePeak.flux;
+		block->loudnessMomentary = frame->loudnessMomentary;
+		block->loudnessShortTerm = frame->loudnessShortTerm;
+		block->loudnessIntegrated = frame->loudnessIntegrated;
+		block->gain = frame->gain;
+		memcpy(block->harmonic, aggregate->harmonicPeak, sizeof(block->harmonic));
+		memcpy(block->percussive, aggregate->percussivePeak, sizeof(block->percussive));
+		memcpy(block->chroma, frame->chroma, sizeof(block->chroma));
+		block->key = frame->key;
+		block->keyStrength = frame->keyStrength;
+	}
+	else
+		block->onsetCount = 0;
+
+	// the grid keeps running between frames: show where it will be when
+	//	this frame reaches the screen, not where it was when analyzed
+	//	(tempo is in track time; the null device may play faster)
+	if (a3demo_predictBeat(&block->beatPhase, &block->nextBeat, demoState->audioBeatPhase, block->tempo * (float)speed,
+		now - demoState->audioFrameReceived + demoState->audioLatency) < 0)
+		block->beatPhase = demoState->audioBeatPhase;
+
+	// everything the visualizers read goes up in one write
+	a3bufferFillOffset(demoState->ubo_audio, 0, 0, sizeof(a3_DemoAudioBlock), block, 0);
+}
+
+void fmod_startAnalysis(a3_DemoState *demoState)
+{
+	// one hop every 512 samples of the track; the null device can play 
+	//	faster than real time, in which case hops come faster too
+	const a3_DemoAudioSource *const source = demoState->audioSource;
+	float sampleRate;
+	double hopRate, speed = 1.0;
+
+	fmod_bindAudioSource(demoState);
+
+	// no cache for this track yet: build it on its own thread and analyze 
+	//	live until it is ready; a build stopped by hotload starts over
+	if (!demoState->audioCache->header && *demoState->audioCachePath)
+		a3demo_startAudioJob(demoState->audioCacheJob, (a3_DemoAudioJobFunc)fmod_buildAudioCacheJob, demoState);
+
+	sampleRate = source->sampleRate ? (float)source->sampleRate : 44100.0f;
+	hopRate = sampleRate / 512.0;
+	if (source->data == demoState->audioDevice && demoState->audioDevice->speed > 0.0)
+		speed = demoState->audioDevice->speed;
+	demoState->audioConsumed = 0;
+
+	// spectrum engines replace FMOD's fixed triangle-window spectrum
+	// left, right, mid and side go through batched transforms of three
+	//	window sizes, and visualizer bands come from whichever suits them
+	// drums and tonal content split apart; 17 hops is about 200 ms of
+	//	history at 44.1 kHz, 17 bins about 700 Hz of neighborhood
+	// without any of these there is nothing to analyze with, so the 
+	//	thread does not start
+	if (a3demo_createAudioSTFT(demoState->audioSTFT, sampleRate) <= 0 ||
+		a3demo_createSpectrumI32(demoState->audioSpectrumI32, demoState->audioSTFT->resolution[a3audio_main].size, a3spectrum_windowHann) <= 0 ||
+		a3demo_createHPSS(demoState->audioHPSS, demoState->audioSTFT->resolution[a3audio_main].bins, 17, 17) <= 0)
+	{
+		a3demo_releaseSTFT(demoState->audioSTFT);
+		a3demo_releaseSpectrumI32(demoState->audioSpectrumI32);
+		a3demo_releaseHPSS(demoState->audioHPSS);
+		return;
+	}
+
+	// onsets and beats come from the mid channel's bands
+	a3demo_initBeatTracker(demoState->audioBeat, hopRate, demoAudioFrame_bandCount);
+
+	// feature vector from the mid channel's spectrum and waveform
+	a3demo_initAudioFeatureExtractor(demoState->audioFeatures, demoState->audioSTFT->resolution[a3audio_main].bins, sampleRate);
+
+	// loudness normalizes bands and waveform, so quiet and loud tracks
+	//	move the visuals the same amount
+	a3demo_initLoudnessMeter(demoState->audioLoudness, sampleRate, source->channelCount > 1 ? 2 : 1);
+
+	// pitch classes from C2 to C8, from the long window so low notes
+	//	land in their own class; the key follows about four seconds of sound
+	a3demo_initChromaAnalyzer(demoState->audioChroma, demoState->audioSTFT->resolution[a3audio_bass].bins, sampleRate, hopRate, 65.0f, 4200.0f, 4.0f);
+	a3demo_startAudioAnalysis(demoState->audioAnalysis, (a3_DemoAudioAnalyzeFunc)fmod_analyzeAudio, demoState, hopRate * speed);
+}
+
+void fmod_stopAnalysis(a3_DemoState *demoState)
+{
+	a3demo_stopAudioJob(demoState->audioCacheJob);
+	a3demo_stopAudioAnalysis(demoState->audioAnalysis);
+	a3demo_releaseSTFT(demoState->audioSTFT);
+	a3demo_releaseSpectrumI32(demoState->audioSpectrumI32);
+	a3demo_releaseHPSS(demoState->audioHPSS);
+}
+
+int fmod_analyzeAudio(a3_DemoState *demoState, a3_DemoAudioFrame *frame_out)
+{
+	// called on the analysis thread; sources are safe to read from here
+	const a3_DemoAudioSource *const source = demoState->audioSource;
+	a3_DemoSTFT *const stft = demoState->audioSTFT;
+	a3_DemoSpectrumBatch *const spectrum = stft->resolution + a3audio_main;
+	a3_DemoSpectrumI32 *const integer = demoState->audioSpectrumI32;
+	const unsigned int size = spectrum->size, ringSize = stft->ringSize, hop = stft->hop;
+	float *const left = stft->input + ringSize * a3audio_left;
+	float *const right = stft->input + ringSize * a3audio_right;
+	float *const streamLeft = stft->input + ringSize * a3audio_mid;
+	float *const streamRight = stft->input + ringSize * a3audio_side;
+	int transformed = 0, positioned;
+	unsigned int position, consumed, pending, i;
+
+	// precomputed track: look up the hop at the playback position, only
+	//	the waveform is read live
+	if (demoState->audioCache->header)
+	{
+		if (a3demo_getAudioSourcePosition(source, &position) > 0 &&
+			a3demo_readAudioSourceWave(source, left, right, demoAudioFrame_waveSize) > 0)
+		{
+			for (i = 0; i < demoAudioFrame_waveSize; ++i)
+				frame_out->wave[i] = 0.5f * (left[i] + right[i]);
+			a3demo_copyAudioCacheHop(frame_out, a3demo_getAudioCacheHop(demoState->audioCache, position));
+			for (i = 0; i < demoAudioFrame_waveSize; ++i)
+				frame_out->wave[i] *= frame_out->gain;
+			return a3analyze_frame;
+		}
+		return a3analyze_none;
+	}
+
+	// stream the source: everything heard since the previous call goes into 
+	//	the ring once, a hop at a time, the same as the cache build; the 
+	//	position moves in device blocks, so a call may find no whole hop or 
+	//	several; each call analyzes one and asks to be called again while 
+	//	more are ready, so every hop is published as its own frame
+	if (a3demo_getAudioSourcePosition(source, &position) <= 0)
+		return a3analyze_none;
+	consumed = demoState->audioConsumed;
+	if (position < consumed || position - consumed > ringSize)
+	{
+		// seek, loop or fell a whole ring behind: start over with the 
+		//	newest ring of samples
+		consumed = position > ringSize ? position - ringSize : 0;
+		demoState->audioConsumed = consumed;
+	}
+	pending = position - consumed;
+	if (pending < hop)
+		return a3analyze_none;
+
+	// the hop after the consumed position; sources that only hand out 
+	//	their newest samples read everything pending right after taking 
+	//	the position, staged in the mid and side lanes, which the hop's 
+	//	push does not reach
+	positioned = source->waveAtFunc != 0;
+	if (positioned)
+	{
+		if (a3demo_readAudioSourceWaveAt(source, stft->input + hop * a3audio_left, stft->input + hop * a3audio_right, consumed + hop, hop) <= 0)
+			return a3analyze_none;
+	}
+	else
+	{
+		if (a3demo_readAudioSourceWave(source, streamLeft, streamRight, pending) <= 0)
+			return a3analyze_none;
+		memcpy(stft->input + hop * a3audio_left, streamLeft, sizeof(float) * hop);
+		memcpy(stft->input + hop * a3audio_right, streamRight, sizeof(float) * hop);
+	}
+	a3demo_pushAudioSTFT(stft, hop);
+	demoState->audioConsumed = consumed + hop;
+
+	// integer path: int16 goes straight into the fixed-point transform
+	//	for the main window, read at the position the ring was filled up 
+	//	to; the ring still feeds everything else
+	if (demoState->audioIntegerFFT && integer->size == size && positioned && 
+		a3demo_readAudioSourcePCM16At(source, integer->pcm, integer->pcm + size, consumed + hop, size) > 0)
+		transformed = a3demo_computeSpectrumI32(integer, integer->pcm, integer->pcm + size, spectrum->spectrum) > 0;
+
+	a3demo_analyzeAudioHop(stft, demoState->audioBeat, demoState->audioFeatures, demoState->audioLoudness, demoState->audioHPSS, demoState->audioChroma, hop, transformed, frame_out);
+	return pending - hop >= hop ? a3analyze_more : a3analyze_frame;
+}
+
+int a3demo_createAudioSTFT(a3_DemoSTFT *stft_out, const float sampleRate)
+{
+	// long window resolves bass notes 11 Hz apart, short one keeps hi-hats
+	//	to about 10 ms; one hop for all
+	const unsigned int sizes[demoAudio_resolutionCount] = { 4096, 1024, 512 };
+	const float crossoverHz[demoAudio_resolutionCount - 1] = { 250.0f, 4000.0f };
+	if (a3demo_createSTFT(stft_out, sizes, demoAudio_resolutionCount, demoAudioFrame_channelCount, 512, a3spectrum_windowHann) > 0)
+	{
+		// visualizer gets log-spaced bands instead of linear bins, which
+		//	spend most of their range on the top octaves
+		if (a3demo_createSTFTBands(stft_out, demoAudioFrame_bandCount, sampleRate, 40.0f, 16000.0f, a3bands_log, crossoverHz) > 0)
+			return 1;
+		a3demo_releaseSTFT(stft_out);
+	}
+	return 0;
+}
+
+int a3demo_pushAudioSTFT(a3_DemoSTFT *stft, const unsigned int count)
+{
+	const float *const left = stft->input + count * a3audio_left;
+	const float *const right = stft->input + count * a3audio_right;
+	float *const mid = stft->input + count * a3audio_mid;
+	float *const side = stft->input + count * a3audio_side;
+	unsigned int i;
+
+	for (i = 0; i < count; ++i)
+	{
+		mid[i] = 0.5f * (left[i] + right[i]);
+		side[i] = 0.5f * (left[i] - right[i]);
+	}
+	return a3demo_pushSTFT(stft, stft->input, count);
+}
+
+void a3demo_analyzeAudioHop(a3_DemoSTFT *stft, a3_DemoBeatTracker *beat, a3_DemoAudioFeatureExtractor *features, a3_DemoLoudnessMeter *loudness, a3_DemoHPSS *hpss, a3_DemoChromaAnalyzer *chroma, const unsigned int pushed, const int transformed, a3_DemoAudioFrame *frame_out)
+{
+	const a3_DemoSpectrumBatch *const spectrum = stft->resolution + a3audio_main;
+	const a3_DemoSpectrumBatch *const bass = stft->resolution + a3audio_bass;
+	const unsigned int size = spectrum->size, count = pushed < size ? pushed : size;
+	const float *const left = spectrum->samples + size * a3audio_left;
+	const float *const right = spectrum->samples + size * a3audio_right;
+	const float *const mid = spectrum->samples + size * a3audio_mid;
+	float *value;
+	unsigned int i;
+
+	// every window frames the newest samples; the main one may already
+	//	have its spectrum
+	a3demo_computeSTFT(stft, transformed ? ~(1u << a3audio_main) : ~0u);
+
+	// newest samples are at the end
+	memcpy(frame_out->wave, mid + size - demoAudioFrame_waveSize, sizeof(frame_out->wave));
+
+	// gating integrates every sample once, so only the ones just pushed
+	if (count)
+		a3demo_updateLoudnessMeter(loudness, left + size - count, right + size - count, count);
+	frame_out->loudnessMomentary = loudness->momentary;
+	frame_out->loudnessShortTerm = loudness->shortTerm;
+	frame_out->loudnessIntegrated = loudness->integrated;
+	frame_out->gain = loudness->gain;
+
+	// band mapping is linear, so normalizing the bands is the same as
+	//	normalizing the spectrum first, for a fraction of the work
+	for (i = 0; i < demoAudioFrame_channelCount; ++i)
+		a3demo_applySTFTBands(stft, i, frame_out->bands[i]);
+
+	// onsets come from the bands before gain, since gain moving between 
+	//	hops would look like spectral flux
+	a3demo_updateBeatTracker(beat, frame_out->bands[a3audio_mid]);
+	for (i = 0, value = *frame_out->bands; i < demoAudioFrame_channelCount * demoAudioFrame_bandCount; ++i)
+		value[i] *= loudness->gain;
+
+	// harmonic and percussive parts of the mid channel; medians are not
+	//	linear either, but scaling every input scales them the same way
+	a3demo_separateHPSS(hpss, spectrum->spectrum + spectrum->bins * a3audio_mid);
+	a3demo_applySpectrumBands(stft->bands + a3audio_main, hpss->harmonic, frame_out->harmonicBands);
+	a3demo_applySpectrumBands(stft->bands + a3audio_main, hpss->percussive, frame_out->percussiveBands);
+	for (i = 0; i < demoAudioFrame_bandCount; ++i)
+	{
+		frame_out->harmonicBands[i] *= loudness->gain;
+		frame_out->percussiveBands[i] *= loudness->gain;
+	}
+	for (i = 0; i < demoAudioFrame_waveSize; ++i)
+		frame_out->wave[i] *= loudness->gain;
+
+	// features over the whole window, so every hop sees the same span;
+	//	taken before normalization, so rms still tells loud from quiet
+	a3demo_extractAudioFeatures(features, spectrum->spectrum + spectrum->bins * a3audio_mid, mid, size, &frame_out->features);
+
+	// chroma is scaled to its own peak, so gain does not matter
+	frame_out->key = a3demo_updateChromaAnalyzer(chroma, bass->spectrum + bass->bins * a3audio_mid);
+	frame_out->keyStrength = chroma->keyStrength;
+	memcpy(frame_out->chroma, chroma->chroma, sizeof(frame_out->chroma));
+
+	frame_out->onsetStrength = beat->onsetStrength;
+	frame_out->beatPhase = beat->beatPhase;
+	frame_out->tempo = beat->tempo;
+	frame_out->onset = beat->onset;
+	frame_out->beat = beat->beat;
+	frame_out->onsetTotal = beat->onsetTotal;
+	frame_out->beatTotal = beat->beatCount;
 }
 
 
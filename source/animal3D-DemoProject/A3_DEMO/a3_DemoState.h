@@ -42,9 +42,31 @@ Demo state interface and programmer function declarations.
 
 #include "_utilities/a3_DemoSceneObject.h"
 #include "_utilities/a3_DemoShaderProgram.h"
-
+#include "_utilities/a3_DemoGraphicsState.h"
+#include "_utilities/a3_DemoRenderQueue.h"
+#include "_utilities/a3_DemoUniformStream.h"
+#include "_utilities/a3_DemoSceneBlock.h"
+#include "_utilities/a3_DemoInstancing.h"
+#include "_utilities/a3_DemoAudioAnalysis.h"
+#include "_utilities/a3_DemoSpectrum.h"
+#include "_utilities/a3_DemoSpectrumBands.h"
+#include "_utilities/a3_DemoBeat.h"
+#include "_utilities/a3_DemoAudioFeatures.h"
+#include "_utilities/a3_DemoLoudness.h"
+#include "_utilities/a3_DemoHPSS.h"
+#include "_utilities/a3_DemoChroma.h"
+#include "_utilities/a3_DemoSpectrumI32.h"
+#include "_utilities/a3_DemoSTFT.h"
+#include "_utilities/a3_DemoAudioCache.h"
+#include "_utilities/a3_DemoAudioSource.h"
+#include "_utilities/a3_DemoAudioBlock.h"
+
+// define A3_DEMO_NULL_AUDIO to build without FMOD; audio then only plays 
+//	through the null device
+#ifndef A3_DEMO_NULL_AUDIO
 #include "fmod\fmod.h"
 #include "fmod\fmod_errors.h"
+#endif	// !A3_DEMO_NULL_AUDIO
 
 //-----------------------------------------------------------------------------
 
@@ -69,10 +91,38 @@ enum a3_DemoStateObjectMaxCounts
 	demoStateMaxCount_timer = 1,
 	demoStateMaxCount_framebuffer = 1,
 	demoStateMaxCount_texture = 8,
-	demoStateMaxCount_drawDataBuffer = 1,
+	demoStateMaxCount_drawDataBuffer = 3,
+	demoStateMaxCount_uniformBuffer = 2,
 	demoStateMaxCount_vertexArray = 4,
 	demoStateMaxCount_drawable = 16,
 	demoStateMaxCount_shaderProgram = 14,
+	demoStateMaxCount_instance = 4096,
+};
+
+// what the instanced field draws copies of
+enum a3_DemoStateInstanceShape
+{
+	demoStateInstance_off,
+	demoStateInstance_sphere,
+	demoStateInstance_teapot,
+
+	demoStateInstance_shapeCount
+};
+
+// uniform buffer binding slots, shared by all programs
+enum a3_DemoStateUniformBufferBinding
+{
+	demoStateBinding_audio,
+	demoStateBinding_frame,
+	demoStateBinding_object,
+};
+
+// rolling spectrogram: one row of bands per update, newest row overwrites 
+//	the oldest
+enum a3_DemoStateSpectrogramSize
+{
+	demoStateSpectrogram_width = demoAudioFrame_bandCount,
+	demoStateSpectrogram_height = 256,
 };
 
 
@@ -133,7 +183,32 @@ struct a3_DemoState
 	// (initialized in 'init scene')
 	a3vec4 lightPos_world;
 
+	// scene object draws, queued and sorted in update, drawn in render
+	a3_DemoRenderQueue sceneQueue[1];
+
+	// this frame's scene blocks, staged in update for one upload to 
+	//	ubo_scene: the frame block first, then one object block per draw
+	a3_DemoUniformStream sceneUniforms[1];
+	a3_DemoFrameBlock frameBlock[1];
+	int frameBlockOffset;
+
+	// draw runs of scene objects with one indirect call each, if the 
+	//	driver can (checked when shaders load)
+	int multiDrawIndirect, multiDrawIndirectSupported;
+
+	// draw scene objects with the visualizer, or lit by their own blocks
+	int displayVisualizer;
+
+	// audio-reactive field of copies of one mesh, staged in update and 
+	//	drawn with one instanced call
+	a3_DemoInstanceBatch sceneInstances[1];
+	unsigned int instanceShape, instanceCount;
+
+	// what render has bound, so repeated binds are dropped
+	a3_DemoGraphicsState graphicsState[1];
+
 	// Include Audio Stuff - Vedant
+#ifndef A3_DEMO_NULL_AUDIO
 	FMOD_SYSTEM* audio_system;
 	FMOD_SOUND* sound;
 	FMOD_CHANNEL* channel;
@@ -141,12 +216,38 @@ struct a3_DemoState
 
 	FMOD_CAPS* caps;
 	FMOD_SPEAKERMODE* speakerMode;
+#endif	// !A3_DEMO_NULL_AUDIO
 
-	float spectrum_data[256];
-	float wave_data[512];
+	a3_DemoAudioBlock audioBlock[1];				// per-frame audio data, uploaded to ubo_audio
 
 	char* audio_path;
 
+	// analysis runs on its own thread and hands frames to update
+	a3_DemoAudioAnalysis audioAnalysis[1];
+	a3_DemoSTFT audioSTFT[1];						// owned by analysis thread
+	a3_DemoSpectrumI32 audioSpectrumI32[1];			// owned by analysis thread; int16 sources when audioIntegerFFT is set
+	a3_DemoBeatTracker audioBeat[1];				// owned by analysis thread
+	a3_DemoAudioFeatureExtractor audioFeatures[1];	// owned by analysis thread
+	a3_DemoLoudnessMeter audioLoudness[1];			// owned by analysis thread
+	a3_DemoHPSS audioHPSS[1];						// owned by analysis thread
+	a3_DemoChromaAnalyzer audioChroma[1];			// owned by analysis thread
+	a3_DemoAudioAggregate audioAggregate[1];		// frames since previous update
+	a3_DemoAudioCache audioCache[1];				// precomputed analysis of the loaded track, if any
+	a3_DemoAudioJob audioCacheJob[1];				// builds the cache of a new track while live analysis runs
+	char audioCachePath[64];						// loaded track's cache file, empty if it has none
+	unsigned int audioCacheHashLo, audioCacheHashHi;
+	a3_DemoAudioSource audioSource[1];				// what analysis listens to: FMOD channel or null device
+	a3_DemoWaveFile audioWave[1];					// loaded track, if it is a WAV file
+	a3_DemoNullDevice audioDevice[1];				// plays the WAV when FMOD does not
+	double audioSpeed;								// null device playback rate
+	int audioIntegerFFT;							// use the integer transform for int16 sources
+	unsigned int audioConsumed;						// source position pushed into the transform so far; owned by analysis thread
+	unsigned int spectrogramRow;					// row written by the next update
+	double audioFrameTime;
+	double audioFrameReceived;						// render time the newest frame arrived
+	double audioLatency;							// seconds from analysis to eyes beyond the frame's age
+	float audioBeatPhase;							// beat grid phase in the newest frame
+
 	//---------------------------------------------------------------------
 	// object arrays: organized as anonymous unions for two reasons: 
 	//	1. easy to manage entire sets of the same type of object using the 
@@ -207,7 +308,8 @@ struct a3_DemoState
 				tex_sky_water[1],					// skybox with water
 				tex_stone_dm[1],					// stone diffuse texture
 				tex_earth_dm[1],					// earth diffuse texture
-				tex_earth_sm[1];					// earth specular texture
+				tex_earth_sm[1],					// earth specular texture
+				tex_spectrogram[1];					// band history, one row per update
 		};
 	};
 
@@ -217,7 +319,19 @@ struct a3_DemoState
 		a3_VertexBuffer drawDataBuffer[demoStateMaxCount_drawDataBuffer];
 		struct {
 			a3_VertexBuffer
-				vbo_staticSceneObjectDrawBuffer[1];			// buffer to hold all data for static scene objects (e.g. grid)
+				vbo_staticSceneObjectDrawBuffer[1],			// buffer to hold all data for static scene objects (e.g. grid)
+				vbo_sceneInstances[1],						// per-instance attributes, refilled every frame
+				vbo_sceneCommands[1];						// indirect draw commands for the scene queue
+		};
+	};
+
+	// uniform buffers
+	union {
+		a3_UniformBuffer uniformBuffer[demoStateMaxCount_uniformBuffer];
+		struct {
+			a3_UniformBuffer
+				ubo_audio[1],								// per-frame audio data block (demoStateBinding_audio)
+				ubo_scene[1];								// frame and object blocks (demoStateBinding_frame, demoStateBinding_object)
 		};
 	};
 
@@ -257,6 +371,8 @@ struct a3_DemoState
 		struct {
 			a3_DemoStateShaderProgram
 				prog_drawMusicVisualizer[1],		// music visualizer shaders
+				prog_drawSceneObject[1],			// lit scene objects, one block each
+				prog_drawInstanced[1],				// instanced audio-reactive field
 
 				prog_drawEffectsMRT[1],				// draw effects shaders
 				prog_drawCombinedMRT[1],			// draw combined shaders
@@ -290,6 +406,50 @@ void fmod_init(a3_DemoState *demoState/*params*/);
 void fmod_loadAudio(a3_DemoState *demoState/*params*/);
 void fmod_updateAudioData(a3_DemoState *demoState/*params*/);
 void fmod_unload(const a3_DemoState *demoState/*params*/);
+void fmod_startAnalysis(a3_DemoState *demoState);
+void fmod_stopAnalysis(a3_DemoState *demoState);
+int fmod_analyzeAudio(a3_DemoState *demoState, a3_DemoAudioFrame *frame_out);
+int fmod_buildAudioCache(const a3_DemoAudioDecoder *decoder, const char *cachePath, const unsigned int hashLo, const unsigned int hashHi, const a3_DemoAudioJob *job_opt);
+int fmod_buildAudioCacheJob(a3_DemoState *demoState, const a3_DemoAudioJob *job);
+void fmod_releaseAudio(a3_DemoState *demoState);
+void fmod_bindAudioSource(a3_DemoState *demoState);
+
+#ifndef A3_DEMO_NULL_AUDIO
+// FMOD sound opened for decoding only
+typedef struct fmod_Decoder
+{
+	FMOD_SOUND *sound;
+	FMOD_SOUND_FORMAT format;
+	unsigned int channels, bytesPerFrame;
+	unsigned int cursor;							// next frame ReadData returns
+} fmod_Decoder;
+
+// FMOD as a playback source and as a decoder
+int fmod_readChannelWave(a3_DemoState *demoState, float *samples_out, const unsigned int count, const unsigned int channel);
+int fmod_getChannelPosition(a3_DemoState *demoState, unsigned int *position_out);
+int fmod_openDecoder(a3_DemoState *demoState, fmod_Decoder *fmodDecoder_out, a3_DemoAudioDecoder *decoder_out);
+int fmod_readDecoder(fmod_Decoder *fmodDecoder, float *left_out, float *right_out, const unsigned int first, const unsigned int count);
+void fmod_closeDecoder(fmod_Decoder *fmodDecoder);
+#endif	// !A3_DEMO_NULL_AUDIO
+
+// analysis windows and bands, the same for live analysis and the cache
+int a3demo_createAudioSTFT(a3_DemoSTFT *stft_out, const float sampleRate);
+
+// derive mid and side for 'count' samples of left and right in the
+//	transform's staging lanes, then push all four
+int a3demo_pushAudioSTFT(a3_DemoSTFT *stft, const unsigned int count);
+
+// one hop of analysis on the newest samples pushed; 'pushed' is how many
+//	are new since the previous hop, and only those reach the loudness meter;
+//	if 'transformed' is set the main resolution's spectrum already holds this hop
+void a3demo_analyzeAudioHop(a3_DemoSTFT *stft, a3_DemoBeatTracker *beat, a3_DemoAudioFeatureExtractor *features, a3_DemoLoudnessMeter *loudness, a3_DemoHPSS *hpss, a3_DemoChromaAnalyzer *chroma, const unsigned int pushed, const int transformed, a3_DemoAudioFrame *frame_out);
+
+// queue this frame's scene object draws and stage their uniform blocks; 
+//	call after cameras update
+void a3demo_queueScene(a3_DemoState *demoState);
+
+// stage the instanced field for this frame; call after cameras update
+void a3demo_updateInstances(a3_DemoState *demoState);
 
 // loading and unloading
 void a3demo_loadFramebuffers(a3_DemoState *demoState);
@@ -311,7 +471,7 @@ void a3demo_validateUnload(const a3_DemoState *demoState);
 // main loop
 void a3demo_input(a3_DemoState *demoState, double dt);
 void a3demo_update(a3_DemoState *demoState, double dt);
-void a3demo_render(const a3_DemoState *demoState);
+void a3demo_render(a3_DemoState *demoState);
 
 
 //-----------------------------------------------------------------------------
@@ -160,7 +160,9 @@ A3API void a3test_unload(a3_DemoState *demoState, int hotload)
 {
 	// release things that need releasing always, whether hotloading or not
 	// e.g. kill thread
-	// nothing in this example, but then...
+	// analysis thread runs code from this library, so it must stop before 
+	//	the library is unloaded; hotload restarts it
+	fmod_stopAnalysis(demoState);
 
 	// release persistent state if not hotloading
 	// good idea to release in reverse order that things were loaded...
@@ -171,6 +173,7 @@ A3API void a3test_unload(a3_DemoState *demoState, int hotload)
 	{
 		// free fixed objects
 		a3textRelease(demoState->text);
+		fmod_releaseAudio(demoState);
 
 		// free graphics objects
 		a3demo_unloadFramebuffers(demoState);
@@ -210,6 +213,9 @@ A3API a3_DemoState *a3test_hotload(a3_DemoState *demoState)
 
 		a3demo_refresh(demoState);
 		a3trigInitSetTables(4, demoState->trigTable);
+
+		// restart threads stopped by unload
+		fmod_startAnalysis(demoState);
 	}
 
 	// return pointer to new persistent state
@@ -392,6 +398,29 @@ A3API void a3test_keyCharPress(a3_DemoState *demoState, int asciiKey)
 	case 'x':
 		demoState->displayAxes = 1 - demoState->displayAxes;
 		break;
+
+		// toggle visualizer or lit scene objects
+	case 'v':
+		demoState->displayVisualizer = 1 - demoState->displayVisualizer;
+		break;
+
+		// toggle multi-draw indirect for the scene, if available
+	case 'm':
+		demoState->multiDrawIndirect = demoState->multiDrawIndirectSupported && !demoState->multiDrawIndirect;
+		break;
+
+		// change instanced field shape and count
+	case 'i':
+		demoState->instanceShape = (demoState->instanceShape + 1) % demoStateInstance_shapeCount;
+		break;
+	case '[':
+		if (demoState->instanceCount > 1)
+			demoState->instanceCount /= 2;
+		break;
+	case ']':
+		if (demoState->instanceCount < demoStateMaxCount_instance)
+			demoState->instanceCount *= 2;
+		break;
 	}
 }
 